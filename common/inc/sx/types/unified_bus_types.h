@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 
 namespace sx::types {
@@ -9,4 +11,38 @@ enum class StreamMode : uint8_t {
     kRealTimeLatest = 1, // 实时模式：Overwrite模式，最新数据覆盖旧数据
 };
 
+// 控制面 endpoint 的 ZMQ 调优参数（在该 endpoint 的 socket 创建时生效）。
+// inproc:// endpoint 走进程内同步分发，这些参数对其无效。
+struct ControlChannelOptions {
+    // 只保留最新一条消息 (ZMQ_CONFLATE)，适合高频遥测。与批量发送互斥（conflate 时不做批量）。
+    bool conflate = false;
+
+    // 发送 / 接收高水位 (消息条数)，-1 表示使用 ZMQ 默认值 (1000)。
+    int send_hwm = -1;
+    int recv_hwm = -1;
+
+    // 批量发送：最多合并 batch_max_messages 条为一个多帧 (ZMQ_SNDMORE) 消息，
+    // 首条入批后最多等待 batch_flush_interval（毫秒精度）。<= 1 表示不批量。
+    std::size_t batch_max_messages = 0;
+    std::chrono::microseconds batch_flush_interval{1000};
+
+    // 发布端为消息编号：序号放在负载前单独的 16 字节帧头帧中（标记 + 标志 + 发布端实例号 + 序号），
+    // 任何订阅端都据此剥离帧头、统计丢包 (gap) 并丢弃重复消息，负载本身不变。
+    // 发布端重启后实例号改变，订阅端从新实例收到的第一条消息重新计数。
+    // 只需在发布端配置；与 conflate 互斥（CONFLATE 不支持多帧消息，conflate 时不加帧头）。
+    bool sequenced = false;
+
+    // 发布端缓存最后一条消息，新订阅者加入时重放 (ZMQ_XPUB 订阅事件触发)。隐含 sequenced，
+    // 已有订阅者会按序号丢弃重放的副本。同一总线上后加的回调由订阅端缓存补发。
+    bool last_value_cache = false;
+};
+
+// 订阅端统计（仅发布端 sequenced 时有 gap / duplicate 统计）。
+struct ControlChannelStats {
+    std::uint64_t received = 0;       // 交付给回调的消息数
+    std::uint64_t gaps = 0;           // 按序号推算丢失的消息数（如 HWM 丢弃）
+    std::uint64_t duplicates = 0;     // 丢弃的重复消息数（如最后值重放）
+    std::uint64_t last_sequence = 0;  // 最近一次交付的序号
+};
+
 } // namespace sx::types
@@ -0,0 +1,92 @@
+/**
+ * @file mpsc_queue.h
+ * @brief 无锁侵入式多生产者单消费者队列 (Vyukov MPSC)
+ * @version 0.1
+ *
+ * - push() 可在任意线程并发调用，无锁且 wait-free（一次 exchange）。
+ * - pop() / empty() 只能由单一消费者调用。
+ * - 节点内存由调用方管理，队列本身不做任何分配。
+ */
+
+#pragma once
+
+#include <atomic>
+
+namespace sx::utils
+{
+
+struct MPSCNode
+{
+    std::atomic<MPSCNode*> next{nullptr};
+};
+
+template <typename T>
+class MPSCQueue
+{
+public:
+    MPSCQueue() noexcept : head_(&stub_), tail_(&stub_) {}
+
+    // Multi-producer. Node must stay alive until popped.
+    void push(T* item) noexcept { push_node(static_cast<MPSCNode*>(item)); }
+
+    // Single consumer. Returns nullptr when empty, or when a producer is between
+    // its exchange and link steps (the item becomes visible once that push completes).
+    [[nodiscard]] T* pop() noexcept
+    {
+        MPSCNode* tail = tail_;
+        MPSCNode* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &stub_) {
+            if (next == nullptr) return nullptr;
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+
+        if (tail != head_.load(std::memory_order_acquire)) return nullptr;
+
+        push_node(&stub_);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+        return nullptr;
+    }
+
+    // Single consumer only. False once every push that happened before has linked its node,
+    // even if pop() still returns nullptr because an earlier producer is between its exchange
+    // and link (that producer finishes its push afterwards, so it must do its own wakeup).
+    // Other threads cannot tell empty from "pending" reliably: head_ may already point back
+    // at stub_ while linked nodes wait behind it.
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return tail_ == &stub_ && stub_.next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+    MPSCQueue(MPSCQueue&&) = delete;
+    MPSCQueue& operator=(MPSCQueue&&) = delete;
+    ~MPSCQueue() = default;
+
+private:
+    void push_node(MPSCNode* node) noexcept
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MPSCNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    alignas(64) std::atomic<MPSCNode*> head_;
+    alignas(64) MPSCNode* tail_;
+    MPSCNode stub_;
+};
+
+}  // namespace sx::utils
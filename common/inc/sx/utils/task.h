@@ -0,0 +1,144 @@
+/**
+ * @file task.h
+ * @brief 只可移动的 void() 任务类型，带 64 字节内联存储 (small-buffer optimization)
+ * @version 0.1
+ *
+ * - 替代 std::function<void()>：接受只可移动的可调用对象（如捕获 unique_ptr 的 lambda）。
+ * - 捕获不超过 kInlineSize 字节且 nothrow-move 的可调用对象直接存放在对象内部，不分配堆内存；
+ *   更大的回退到堆上。
+ * - 用 Task::stored_inline<F> 可在编译期确认热路径上的 lambda 不会分配。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sx::utils
+{
+
+class Task
+{
+public:
+    static constexpr std::size_t kInlineSize = 64;
+
+    template <typename F>
+    static constexpr bool stored_inline = sizeof(F) <= kInlineSize &&
+                                          alignof(F) <= alignof(std::max_align_t) &&
+                                          std::is_nothrow_move_constructible_v<F>;
+
+    Task() noexcept = default;
+    Task(std::nullptr_t) noexcept {}  // NOLINT(google-explicit-constructor)
+
+    template <typename F, typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<D, Task> && std::is_invocable_v<D&>>>
+    Task(F&& f)  // NOLINT(google-explicit-constructor)
+    {
+        if constexpr (std::is_pointer_v<D> || is_std_function<D>::value) {
+            if (!f) return;  // empty callable => empty task, like std::function
+        }
+        if constexpr (stored_inline<D>) {
+            ::new (static_cast<void*>(storage_)) D(std::forward<F>(f));
+            ops_ = &kInlineOps<D>;
+        } else {
+            ::new (static_cast<void*>(storage_)) D*(new D(std::forward<F>(f)));
+            ops_ = &kHeapOps<D>;
+        }
+    }
+
+    Task(Task&& other) noexcept { move_from(other); }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    Task& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~Task() { reset(); }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    void operator()() { ops_->invoke(storage_); }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    void reset() noexcept
+    {
+        if (ops_ != nullptr) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void* storage);
+        void (*relocate)(void* dst, void* src) noexcept;  // move-construct into dst, destroy src
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename T>
+    struct is_std_function : std::false_type
+    {};
+    template <typename R, typename... A>
+    struct is_std_function<std::function<R(A...)>> : std::true_type
+    {};
+
+    template <typename D>
+    static D* inline_ptr(void* p) noexcept
+    {
+        return std::launder(static_cast<D*>(p));
+    }
+
+    template <typename D>
+    static D*& heap_ptr(void* p) noexcept
+    {
+        return *std::launder(static_cast<D**>(p));
+    }
+
+    template <typename D>
+    static constexpr Ops kInlineOps{
+        [](void* s) { (*inline_ptr<D>(s))(); },
+        [](void* dst, void* src) noexcept {
+            D* from = inline_ptr<D>(src);
+            ::new (dst) D(std::move(*from));
+            from->~D();
+        },
+        [](void* s) noexcept { inline_ptr<D>(s)->~D(); },
+    };
+
+    template <typename D>
+    static constexpr Ops kHeapOps{
+        [](void* s) { (*heap_ptr<D>(s))(); },
+        [](void* dst, void* src) noexcept { ::new (dst) D*(heap_ptr<D>(src)); },
+        [](void* s) noexcept { delete heap_ptr<D>(s); },
+    };
+
+    void move_from(Task& other) noexcept
+    {
+        if (other.ops_ != nullptr) {
+            other.ops_->relocate(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+    const Ops* ops_ = nullptr;
+};
+
+}  // namespace sx::utils
@@ -0,0 +1,148 @@
+/**
+ * @file work_stealing_deque.h
+ * @brief Chase-Lev 无锁工作窃取双端队列
+ * @version 0.1
+ *
+ * - push() / pop() 只能由拥有者线程调用，在 bottom 端操作 (LIFO)。
+ * - steal() 可由任意线程调用，从 top 端窃取 (FIFO)。
+ * - 容量按 2 的幂自动增长；旧数组在析构时统一释放（窃取者可能仍在读取）。
+ *
+ * 参考: Lê, Pop, Cohen, Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak
+ * Memory Models", PPoPP 2013.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace sx::utils
+{
+
+template <typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque stores T in atomics");
+
+public:
+    explicit WorkStealingDeque(std::size_t capacity = 256)
+    {
+        std::size_t cap = 1;
+        while (cap < capacity) cap <<= 1U;
+        array_.store(new Array(cap), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingDeque() { delete array_.load(std::memory_order_relaxed); }
+
+    // Owner only.
+    void push(T item)
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(a->capacity) - 1) {
+            Array* bigger = a->grow(b, t);
+            retired_.emplace_back(a);
+            array_.store(bigger, std::memory_order_release);
+            a = bigger;
+        }
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only. Takes the most recently pushed item.
+    [[nodiscard]] bool pop(T& out)
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = a->get(b);
+        if (t == b) {
+            // Last item: race against thieves.
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Takes the oldest item; false when empty or when another thread won the race.
+    [[nodiscard]] bool steal(T& out)
+    {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return false;
+
+        Array* a = array_.load(std::memory_order_acquire);
+        const T item = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        out = item;
+        return true;
+    }
+
+    // Approximate, any thread.
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0U;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0U; }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+private:
+    struct Array
+    {
+        std::size_t capacity;
+        std::size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(std::size_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+        [[nodiscard]] T get(int64_t i) const noexcept
+        {
+            return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, T v) noexcept
+        {
+            slots[static_cast<std::size_t>(i) & mask].store(v, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] Array* grow(int64_t b, int64_t t) const
+        {
+            auto* bigger = new Array(capacity * 2U);
+            for (int64_t i = t; i < b; ++i) bigger->put(i, get(i));
+            return bigger;
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_{nullptr};
+    std::vector<std::unique_ptr<Array>> retired_;  // owner only
+};
+
+}  // namespace sx::utils
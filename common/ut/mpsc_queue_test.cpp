@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "sx/utils/mpsc_queue.h"
+
+namespace {
+
+struct Item : sx::utils::MPSCNode {
+    std::size_t producer = 0;
+    std::size_t seq = 0;
+};
+
+}  // namespace
+
+TEST(MPSCQueue, PopsInPushOrderAndReusesTheStub) {
+    sx::utils::MPSCQueue<Item> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.pop(), nullptr);
+
+    std::vector<Item> items(4);
+    for (std::size_t round = 0; round < 3U; ++round) {
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            items[i].seq = i;
+            queue.push(&items[i]);
+            EXPECT_FALSE(queue.empty());
+        }
+        // Draining re-links the stub behind the last item; the queue must stay usable.
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            ASSERT_FALSE(queue.empty());
+            Item* item = queue.pop();
+            ASSERT_NE(item, nullptr);
+            EXPECT_EQ(item->seq, i);
+        }
+        EXPECT_TRUE(queue.empty());
+        EXPECT_EQ(queue.pop(), nullptr);
+    }
+}
+
+TEST(MPSCQueue, ConcurrentProducersKeepPerProducerOrderAndEmptyIsExactForTheConsumer) {
+    constexpr std::size_t kProducers = 4U;
+    constexpr std::size_t kPerProducer = 20000U;
+    sx::utils::MPSCQueue<Item> queue;
+    std::vector<std::unique_ptr<Item[]>> storage;
+    for (std::size_t p = 0; p < kProducers; ++p) storage.emplace_back(new Item[kPerProducer]);
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (std::size_t i = 0; i < kPerProducer; ++i) {
+                Item& item = storage[p][i];
+                item.producer = p;
+                item.seq = i;
+                queue.push(&item);
+            }
+        });
+    }
+
+    std::vector<std::size_t> next(kProducers, 0U);
+    std::size_t received = 0;
+    auto take = [&](Item* item) {
+        ASSERT_LT(item->producer, kProducers);
+        EXPECT_EQ(item->seq, next[item->producer]++);
+        ++received;
+    };
+
+    // Pop while the producers race the consumer's stub re-insertion.
+    go.store(true, std::memory_order_release);
+    while (received < kProducers * kPerProducer / 2U) {
+        if (Item* item = queue.pop()) take(item);
+    }
+    for (auto& t : producers) t.join();
+
+    // Every push has completed: whatever is left must be reported and poppable.
+    while (!queue.empty()) {
+        Item* item = queue.pop();
+        ASSERT_NE(item, nullptr);
+        take(item);
+    }
+    EXPECT_EQ(received, kProducers * kPerProducer);
+    EXPECT_EQ(queue.pop(), nullptr);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace sx::hal {
+
+// One logical CPU as described by /sys/devices/system/cpu/cpuN. Unknown fields stay -1.
+struct CpuInfo {
+    int id = -1;
+    int core_id = -1;     // topology/core_id (unique only within a package)
+    int package_id = -1;  // topology/physical_package_id
+    int numa_node = -1;   // cpuN/nodeX link; -1 without NUMA support
+    // Cache domains are named by the lowest CPU sharing the cache, so two CPUs share an L2
+    // exactly when their l2_domain values are equal.
+    int l2_domain = -1;
+    int l3_domain = -1;
+    std::vector<int> smt_siblings;  // hardware threads of the same core, including id
+};
+
+// Snapshot of the online CPUs and how they share cores, caches and memory nodes.
+class CpuTopology {
+public:
+    static constexpr const char* kDefaultSysfsRoot = "/sys/devices/system/cpu";
+
+    // Reads the topology below `sysfs_root` (tests point this at a fake tree). Only the online
+    // CPUs are listed; missing cache or NUMA entries are left as -1 rather than failing.
+    [[nodiscard]] std::error_code load(const std::string& sysfs_root = kDefaultSysfsRoot);
+
+    [[nodiscard]] const std::vector<CpuInfo>& cpus() const noexcept { return cpus_; }
+    [[nodiscard]] const CpuInfo* find(int cpu) const noexcept;
+
+    // Online CPUs grouped per physical core (SMT siblings together), each group sorted and the
+    // groups ordered by (NUMA node, L3, L2, first CPU) so neighbouring cores share caches.
+    [[nodiscard]] std::vector<std::vector<int>> physical_cores() const;
+
+    [[nodiscard]] bool has_smt() const noexcept;
+
+    // Parses the kernel's cpulist format ("0-3,8,10-11"). Returns false on malformed input.
+    [[nodiscard]] static bool parse_cpu_list(const std::string& text, std::vector<int>& out);
+
+private:
+    std::vector<CpuInfo> cpus_;  // sorted by id
+};
+
+}  // namespace sx::hal
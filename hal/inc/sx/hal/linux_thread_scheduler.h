@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <vector>
+
+#include "sx/hal/i_thread_scheduler.h"
+#include "sx/types/thread_policy.h"
+
+namespace sx::hal {
+
+enum class RealtimePolicy {
+    kFifo,        // SCHED_FIFO
+    kRoundRobin,  // SCHED_RR
+};
+
+// How threads of one ThreadClass are placed and prioritized.
+struct ThreadClassPolicy {
+    // Allowed CPUs; empty leaves the inherited affinity untouched.
+    std::vector<int> cpus;
+    // Pin worker `index` to cpus[index % cpus.size()] instead of the whole set.
+    bool pin_round_robin = false;
+    // Per-thread nice value (-20..19); unset leaves it unchanged. Ignored for realtime threads.
+    std::optional<int> nice;
+    // > 0 switches the thread to `realtime_policy` with this priority (1..99 on Linux).
+    int realtime_priority = -1;
+};
+
+struct LinuxSchedulerConfig {
+    ThreadClassPolicy io;
+    ThreadClassPolicy cpu;
+    ThreadClassPolicy critical;
+
+    // Used for ThreadClassPolicy::realtime_priority and ThreadPolicy::realtime.
+    RealtimePolicy realtime_policy = RealtimePolicy::kFifo;
+    // Priority for ThreadPolicy::realtime when ThreadPolicy::realtime_priority is -1.
+    int default_realtime_priority = 50;
+
+    // mlockall(MCL_CURRENT | MCL_FUTURE) in init(), so page faults cannot stall realtime threads.
+    bool lock_memory = false;
+    // Bytes of stack each thread touches when it starts (0 = none). With lock_memory the
+    // pages stay resident; without it they are at least already mapped.
+    std::size_t prefault_stack_bytes = 0;
+};
+
+// Default IThreadScheduler for Linux. The IThreadScheduler hooks cannot return errors, so
+// failures there are counted and the most recent one is kept (last_error()) and, if set,
+// reported through the error handler. The static helpers apply one setting to the calling
+// thread and return the error directly.
+class LinuxThreadScheduler final : public IThreadScheduler {
+public:
+    using ErrorHandler = std::function<void(ThreadClass cls, std::size_t index, std::error_code ec)>;
+
+    explicit LinuxThreadScheduler(LinuxSchedulerConfig config = {});
+
+    // Validates the CPU masks against the online CPUs and applies process-wide settings
+    // (lock_memory). Call once before handing the scheduler to AsyncRuntime.
+    [[nodiscard]] std::error_code init();
+
+    void set_error_handler(ErrorHandler handler);
+
+    void on_thread_start(ThreadClass cls, std::size_t index) override;
+    void apply_current_thread_policy(const sx::types::ThreadPolicy& policy) override;
+
+    [[nodiscard]] std::error_code last_error() const;
+    [[nodiscard]] std::size_t error_count() const noexcept { return error_count_.load(std::memory_order_relaxed); }
+    [[nodiscard]] const LinuxSchedulerConfig& config() const noexcept { return config_; }
+
+    // Calling-thread helpers.
+    [[nodiscard]] static std::error_code set_affinity(const std::vector<int>& cpus);
+    [[nodiscard]] static std::error_code set_realtime(RealtimePolicy policy, int priority);
+    [[nodiscard]] static std::error_code set_nice(int nice);
+    [[nodiscard]] static std::error_code lock_memory();
+    // CPUs the calling thread may run on (empty if the mask cannot be read).
+    [[nodiscard]] static std::vector<int> current_affinity();
+    static void prefault_stack(std::size_t bytes) noexcept;
+
+private:
+    void report(ThreadClass cls, std::size_t index, std::error_code ec);
+    [[nodiscard]] const ThreadClassPolicy& policy_for(ThreadClass cls) const noexcept;
+
+    LinuxSchedulerConfig config_;
+
+    mutable std::mutex error_mutex_;
+    std::error_code last_error_;
+    ErrorHandler error_handler_;
+    std::atomic<std::size_t> error_count_{0};
+};
+
+}  // namespace sx::hal
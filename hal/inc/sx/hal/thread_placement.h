@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "sx/hal/cpu_topology.h"
+#include "sx/hal/linux_thread_scheduler.h"
+
+namespace sx::hal {
+
+// What the placement planner should do with the cores it is given.
+struct PlacementPolicy {
+    // Off by default: threads keep the affinity they inherit.
+    bool enabled = false;
+    // Physical cores reserved for critical loops; loop i is pinned to the first hardware thread
+    // of reserved core i. Reserved cores are taken from the end of the cache-ordered core list.
+    std::size_t critical_cores = 0;
+    // Leave the SMT siblings of critical cores idle instead of giving them to the CPU pool.
+    bool isolate_critical_smt = true;
+    // Physical cores for the IO pool, taken from the start of one cache domain and capped at the
+    // cores of that L3 domain. 0 (or too few cores) makes the IO pool share the CPU pool's cores.
+    std::size_t io_cores = 1;
+    // CPUs the runtime may use; empty means every online CPU in the topology.
+    std::vector<int> allowed_cpus;
+};
+
+// Result of plan_placement(). Empty lists leave the class unpinned.
+struct PlacementPlan {
+    std::vector<int> io_cpus;        // whole set: IO threads (and IO strands) float inside it
+    std::vector<int> cpu_cpus;       // CPU worker i is pinned to cpu_cpus[i % size]
+    std::vector<int> critical_cpus;  // critical loop i is pinned to critical_cpus[i % size]
+
+    // Writes the CPU masks into `config`, leaving priorities and memory settings alone.
+    void apply(LinuxSchedulerConfig& config) const;
+};
+
+// Maps the AsyncRuntime pools onto `topology`:
+// - critical loops get whole physical cores, so no SMT sibling competes with them;
+// - the IO pool gets the first cores of the cache-ordered list, never more than one L3 domain,
+//   so the handlers of an IO strand stay within one cache domain whichever thread runs them;
+// - the CPU pool gets the rest, one worker per core first and SMT siblings after, with
+//   neighbouring workers on cores that share caches. A CPU strand's batches run on whichever
+//   CPU worker takes them, so CPU strands are not confined to one domain; work that needs
+//   that locality belongs on an IO strand (or an IoPoolKind::kPerThread shard).
+// At least one core is always left for the CPU pool.
+[[nodiscard]] PlacementPlan plan_placement(const CpuTopology& topology, const PlacementPolicy& policy);
+
+}  // namespace sx::hal
@@ -0,0 +1,171 @@
+/**
+ * @file cpu_topology.cpp
+ * @brief CpuTopology implementation (sysfs parsing)
+ */
+
+#include "sx/hal/cpu_topology.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <tuple>
+
+namespace sx::hal {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Reads the first line of a sysfs attribute; false if the file is missing.
+bool read_line(const fs::path& path, std::string& out) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+    std::getline(in, out);
+    while (!out.empty() && (out.back() == '\n' || out.back() == ' ' || out.back() == '\r')) out.pop_back();
+    return true;
+}
+
+bool parse_int(const char* first, const char* last, int& out) {
+    const auto [ptr, ec] = std::from_chars(first, last, out);
+    return ec == std::errc{} && ptr == last;
+}
+
+int read_int(const fs::path& path, int fallback) {
+    std::string text;
+    int value = 0;
+    if (!read_line(path, text) || !parse_int(text.data(), text.data() + text.size(), value)) return fallback;
+    return value;
+}
+
+// Lowest CPU of the cache at `level` (data or unified) that `cpu_dir` belongs to, or -1.
+int cache_domain(const fs::path& cpu_dir, int level) {
+    std::error_code ec;
+    for (fs::directory_iterator it(cpu_dir / "cache", ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.rfind("index", 0) != 0) continue;
+
+        std::string type;
+        if (read_int(it->path() / "level", -1) != level) continue;
+        if (read_line(it->path() / "type", type) && type == "Instruction") continue;
+
+        std::string list;
+        std::vector<int> shared;
+        if (read_line(it->path() / "shared_cpu_list", list) && CpuTopology::parse_cpu_list(list, shared) &&
+            !shared.empty()) {
+            return shared.front();
+        }
+    }
+    return -1;
+}
+
+int numa_node_of(const fs::path& cpu_dir) {
+    std::error_code ec;
+    for (fs::directory_iterator it(cpu_dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        int node = -1;
+        if (name.size() > 4U && name.rfind("node", 0) == 0 &&
+            parse_int(name.data() + 4, name.data() + name.size(), node)) {
+            return node;
+        }
+    }
+    return -1;
+}
+
+}  // namespace
+
+bool CpuTopology::parse_cpu_list(const std::string& text, std::vector<int>& out) {
+    out.clear();
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        std::size_t end = text.find(',', pos);
+        if (end == std::string::npos) end = text.size();
+        const std::string item = text.substr(pos, end - pos);
+        pos = end + 1U;
+        if (item.empty()) continue;
+
+        const std::size_t dash = item.find('-');
+        int first = 0;
+        int last = 0;
+        const char* begin = item.data();
+        if (dash == std::string::npos) {
+            if (!parse_int(begin, begin + item.size(), first)) return false;
+            last = first;
+        } else if (!parse_int(begin, begin + dash, first) ||
+                   !parse_int(begin + dash + 1, begin + item.size(), last)) {
+            return false;
+        }
+        if (first < 0 || last < first) return false;
+        for (int cpu = first; cpu <= last; ++cpu) out.push_back(cpu);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return true;
+}
+
+std::error_code CpuTopology::load(const std::string& sysfs_root) {
+    const fs::path root(sysfs_root);
+    std::vector<int> online;
+    std::string list;
+    if (!read_line(root / "online", list)) return std::make_error_code(std::errc::no_such_file_or_directory);
+    if (!parse_cpu_list(list, online) || online.empty()) return std::make_error_code(std::errc::invalid_argument);
+
+    std::vector<CpuInfo> cpus;
+    cpus.reserve(online.size());
+    for (const int id : online) {
+        const fs::path dir = root / ("cpu" + std::to_string(id));
+        CpuInfo info;
+        info.id = id;
+        info.core_id = read_int(dir / "topology" / "core_id", -1);
+        info.package_id = read_int(dir / "topology" / "physical_package_id", -1);
+        info.numa_node = numa_node_of(dir);
+        info.l2_domain = cache_domain(dir, 2);
+        info.l3_domain = cache_domain(dir, 3);
+
+        // core_cpus_list is the newer name; thread_siblings_list is kept for older kernels.
+        if (!read_line(dir / "topology" / "core_cpus_list", list) &&
+            !read_line(dir / "topology" / "thread_siblings_list", list)) {
+            list.clear();
+        }
+        std::vector<int> siblings;
+        if (!parse_cpu_list(list, siblings)) siblings.clear();
+        for (const int sibling : siblings) {
+            if (std::binary_search(online.begin(), online.end(), sibling)) info.smt_siblings.push_back(sibling);
+        }
+        if (info.smt_siblings.empty()) info.smt_siblings.push_back(id);
+        cpus.push_back(std::move(info));
+    }
+
+    cpus_ = std::move(cpus);
+    return {};
+}
+
+const CpuInfo* CpuTopology::find(int cpu) const noexcept {
+    const auto it = std::lower_bound(cpus_.begin(), cpus_.end(), cpu,
+                                     [](const CpuInfo& info, int id) { return info.id < id; });
+    return it != cpus_.end() && it->id == cpu ? &*it : nullptr;
+}
+
+std::vector<std::vector<int>> CpuTopology::physical_cores() const {
+    std::map<int, std::vector<int>> by_first_sibling;
+    for (const auto& info : cpus_) by_first_sibling[info.smt_siblings.front()].push_back(info.id);
+
+    std::vector<std::vector<int>> cores;
+    cores.reserve(by_first_sibling.size());
+    for (auto& entry : by_first_sibling) cores.push_back(std::move(entry.second));
+
+    auto key = [this](const std::vector<int>& core) {
+        const CpuInfo* info = find(core.front());
+        return std::make_tuple(info->numa_node, info->l3_domain, info->l2_domain, info->id);
+    };
+    std::sort(cores.begin(), cores.end(),
+              [&key](const std::vector<int>& a, const std::vector<int>& b) { return key(a) < key(b); });
+    return cores;
+}
+
+bool CpuTopology::has_smt() const noexcept {
+    return std::any_of(cpus_.begin(), cpus_.end(), [](const CpuInfo& info) { return info.smt_siblings.size() > 1U; });
+}
+
+}  // namespace sx::hal
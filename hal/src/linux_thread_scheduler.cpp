@@ -0,0 +1,166 @@
+/**
+ * @file linux_thread_scheduler.cpp
+ * @brief LinuxThreadScheduler implementation (pthread / sched / mlockall)
+ */
+
+#include "sx/hal/linux_thread_scheduler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace sx::hal {
+
+namespace {
+
+std::error_code errno_error(int err) { return {err, std::system_category()}; }
+
+// Keep this much of the thread's stack untouched by prefault_stack().
+constexpr std::size_t kStackReserve = 64U * 1024U;
+
+}  // namespace
+
+LinuxThreadScheduler::LinuxThreadScheduler(LinuxSchedulerConfig config) : config_(std::move(config)) {}
+
+std::error_code LinuxThreadScheduler::init() {
+    const long configured = sysconf(_SC_NPROCESSORS_CONF);
+    const int max_cpu = std::min(configured > 0 ? static_cast<int>(configured) : 1, CPU_SETSIZE);
+    for (const auto* policy : {&config_.io, &config_.cpu, &config_.critical}) {
+        for (const int cpu : policy->cpus) {
+            if (cpu < 0 || cpu >= max_cpu) return std::make_error_code(std::errc::invalid_argument);
+        }
+    }
+    if (config_.lock_memory) return lock_memory();
+    return {};
+}
+
+void LinuxThreadScheduler::set_error_handler(ErrorHandler handler) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    error_handler_ = std::move(handler);
+}
+
+std::error_code LinuxThreadScheduler::last_error() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+const ThreadClassPolicy& LinuxThreadScheduler::policy_for(ThreadClass cls) const noexcept {
+    switch (cls) {
+        case ThreadClass::kIo: return config_.io;
+        case ThreadClass::kCpu: return config_.cpu;
+        case ThreadClass::kCritical: return config_.critical;
+    }
+    return config_.cpu;
+}
+
+void LinuxThreadScheduler::on_thread_start(ThreadClass cls, std::size_t index) {
+    const ThreadClassPolicy& policy = policy_for(cls);
+
+    if (!policy.cpus.empty()) {
+        const auto ec = policy.pin_round_robin ? set_affinity({policy.cpus[index % policy.cpus.size()]})
+                                               : set_affinity(policy.cpus);
+        if (ec) report(cls, index, ec);
+    }
+
+    if (policy.realtime_priority > 0) {
+        if (const auto ec = set_realtime(config_.realtime_policy, policy.realtime_priority)) report(cls, index, ec);
+    } else if (policy.nice) {
+        if (const auto ec = set_nice(*policy.nice)) report(cls, index, ec);
+    }
+
+    prefault_stack(config_.prefault_stack_bytes);
+}
+
+void LinuxThreadScheduler::apply_current_thread_policy(const sx::types::ThreadPolicy& policy) {
+    if (policy.cpu_id >= 0) {
+        if (const auto ec = set_affinity({policy.cpu_id})) report(ThreadClass::kCritical, 0U, ec);
+    }
+    if (policy.realtime) {
+        const int priority = policy.realtime_priority > 0 ? policy.realtime_priority : config_.default_realtime_priority;
+        if (const auto ec = set_realtime(config_.realtime_policy, priority)) report(ThreadClass::kCritical, 0U, ec);
+    }
+}
+
+void LinuxThreadScheduler::report(ThreadClass cls, std::size_t index, std::error_code ec) {
+    ErrorHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_ = ec;
+        handler = error_handler_;
+    }
+    error_count_.fetch_add(1, std::memory_order_relaxed);
+    if (handler) handler(cls, index, ec);
+}
+
+std::error_code LinuxThreadScheduler::set_affinity(const std::vector<int>& cpus) {
+    if (cpus.empty()) return {};
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) return std::make_error_code(std::errc::invalid_argument);
+        CPU_SET(static_cast<std::size_t>(cpu), &set);
+    }
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    return rc == 0 ? std::error_code{} : errno_error(rc);
+}
+
+std::vector<int> LinuxThreadScheduler::current_affinity() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) return cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(static_cast<std::size_t>(cpu), &set)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+std::error_code LinuxThreadScheduler::set_realtime(RealtimePolicy policy, int priority) {
+    const int native = policy == RealtimePolicy::kRoundRobin ? SCHED_RR : SCHED_FIFO;
+    sched_param param{};
+    param.sched_priority = std::clamp(priority, sched_get_priority_min(native), sched_get_priority_max(native));
+    const int rc = pthread_setschedparam(pthread_self(), native, &param);
+    return rc == 0 ? std::error_code{} : errno_error(rc);
+}
+
+std::error_code LinuxThreadScheduler::set_nice(int nice) {
+    // On Linux, PRIO_PROCESS with a thread id sets the nice value of that thread only.
+    const auto tid = static_cast<id_t>(::syscall(SYS_gettid));
+    if (::setpriority(PRIO_PROCESS, tid, std::clamp(nice, -20, 19)) != 0) return errno_error(errno);
+    return {};
+}
+
+std::error_code LinuxThreadScheduler::lock_memory() {
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) return errno_error(errno);
+    return {};
+}
+
+void LinuxThreadScheduler::prefault_stack(std::size_t bytes) noexcept {
+    if (bytes == 0U) return;
+
+    // Never reach into the guard page: cap to the thread's stack size minus a reserve.
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+        std::size_t stack_size = 0;
+        if (pthread_attr_getstacksize(&attr, &stack_size) == 0) {
+            bytes = std::min(bytes, stack_size > kStackReserve ? stack_size - kStackReserve : 0U);
+        }
+        (void)pthread_attr_destroy(&attr);
+    }
+    if (bytes == 0U) return;
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+    const std::size_t step = page_size > 0 ? static_cast<std::size_t>(page_size) : 4096U;
+    auto* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+    for (std::size_t offset = 0; offset < bytes; offset += step) stack[offset] = 0;
+}
+
+}  // namespace sx::hal
@@ -0,0 +1,88 @@
+/**
+ * @file thread_placement.cpp
+ * @brief plan_placement() implementation
+ */
+
+#include "sx/hal/thread_placement.h"
+
+#include <algorithm>
+
+namespace sx::hal {
+
+namespace {
+
+int l3_of(const CpuTopology& topology, const std::vector<int>& core) {
+    const CpuInfo* info = topology.find(core.front());
+    return info != nullptr ? info->l3_domain : -1;
+}
+
+}  // namespace
+
+void PlacementPlan::apply(LinuxSchedulerConfig& config) const {
+    config.io.cpus = io_cpus;
+    config.io.pin_round_robin = false;
+    config.cpu.cpus = cpu_cpus;
+    config.cpu.pin_round_robin = !cpu_cpus.empty();
+    config.critical.cpus = critical_cpus;
+    config.critical.pin_round_robin = !critical_cpus.empty();
+}
+
+PlacementPlan plan_placement(const CpuTopology& topology, const PlacementPolicy& policy) {
+    PlacementPlan plan;
+    if (!policy.enabled) return plan;
+
+    std::vector<int> allowed = policy.allowed_cpus;
+    std::sort(allowed.begin(), allowed.end());
+    std::vector<std::vector<int>> cores;
+    for (auto& core : topology.physical_cores()) {
+        if (!allowed.empty()) {
+            core.erase(std::remove_if(core.begin(), core.end(),
+                                      [&allowed](int cpu) {
+                                          return !std::binary_search(allowed.begin(), allowed.end(), cpu);
+                                      }),
+                       core.end());
+        }
+        if (!core.empty()) cores.push_back(std::move(core));
+    }
+    if (cores.empty()) return plan;
+
+    const std::size_t critical = std::min(policy.critical_cores, cores.size() - 1U);
+    const std::size_t pool_cores = cores.size() - critical;
+    // The IO set stops at the end of the first L3 domain, so IO strands never straddle two caches.
+    std::size_t io = policy.io_cores < pool_cores ? policy.io_cores : 0U;
+    const int first_l3 = l3_of(topology, cores.front());
+    for (std::size_t c = 1; c < io; ++c) {
+        if (l3_of(topology, cores[c]) != first_l3) {
+            io = c;
+            break;
+        }
+    }
+
+    for (std::size_t c = pool_cores; c < cores.size(); ++c) {
+        plan.critical_cpus.push_back(cores[c].front());
+    }
+
+    for (std::size_t c = 0; c < io; ++c) {
+        plan.io_cpus.insert(plan.io_cpus.end(), cores[c].begin(), cores[c].end());
+    }
+
+    // Hardware thread 0 of every pool core first, then thread 1, ...: with fewer workers than
+    // hardware threads each worker gets a core of its own. CPU strands are not bound to a
+    // worker, so beyond keeping neighbouring workers on cores that share caches there is no
+    // per-strand domain to honour here.
+    std::size_t max_threads = 0;
+    for (const auto& core : cores) max_threads = std::max(max_threads, core.size());
+    for (std::size_t t = 0; t < max_threads; ++t) {
+        for (std::size_t c = io; c < cores.size(); ++c) {
+            if (t >= cores[c].size()) continue;
+            if (c >= pool_cores && (t == 0U || policy.isolate_critical_smt)) continue;
+            plan.cpu_cpus.push_back(cores[c][t]);
+        }
+    }
+
+    if (io == 0U) plan.io_cpus = plan.cpu_cpus;
+    std::sort(plan.io_cpus.begin(), plan.io_cpus.end());
+    return plan;
+}
+
+}  // namespace sx::hal
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "sx/hal/linux_thread_scheduler.h"
+
+namespace {
+
+using sx::hal::IThreadScheduler;
+using sx::hal::LinuxSchedulerConfig;
+using sx::hal::LinuxThreadScheduler;
+
+std::vector<int> CurrentAffinity() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) return cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+}  // namespace
+
+TEST(LinuxThreadScheduler, PinsWorkersToPerClassMasks) {
+    const std::vector<int> allowed = CurrentAffinity();
+    ASSERT_FALSE(allowed.empty());
+
+    LinuxSchedulerConfig config;
+    config.cpu.cpus = allowed;
+    config.cpu.pin_round_robin = true;
+    config.cpu.nice = 5;  // raising nice never needs privileges
+    config.prefault_stack_bytes = 256U * 1024U;
+    LinuxThreadScheduler scheduler(config);
+    ASSERT_FALSE(scheduler.init());
+
+    for (std::size_t index = 0; index < 3U; ++index) {
+        std::vector<int> pinned;
+        std::thread worker([&]() {
+            scheduler.on_thread_start(IThreadScheduler::ThreadClass::kCpu, index);
+            pinned = CurrentAffinity();
+        });
+        worker.join();
+        ASSERT_EQ(pinned.size(), 1U);
+        EXPECT_EQ(pinned[0], allowed[index % allowed.size()]);
+    }
+    EXPECT_EQ(scheduler.error_count(), 0U);
+}
+
+TEST(LinuxThreadScheduler, ReportsFailuresThroughErrorCode) {
+    LinuxSchedulerConfig bad;
+    bad.io.cpus = {-1};
+    EXPECT_EQ(LinuxThreadScheduler(bad).init(), std::errc::invalid_argument);
+    EXPECT_EQ(LinuxThreadScheduler::set_affinity({CPU_SETSIZE}), std::errc::invalid_argument);
+
+    // SCHED_FIFO needs CAP_SYS_NICE or an rtprio limit: either it works or the hook records
+    // why, without throwing or aborting the thread.
+    LinuxThreadScheduler scheduler;
+    std::error_code reported;
+    scheduler.set_error_handler([&reported](IThreadScheduler::ThreadClass cls, std::size_t, std::error_code ec) {
+        EXPECT_EQ(cls, IThreadScheduler::ThreadClass::kCritical);
+        reported = ec;
+    });
+
+    sx::types::ThreadPolicy policy;
+    policy.realtime = true;
+    policy.realtime_priority = 10;
+    int sched_policy = -1;
+    std::thread critical([&]() {
+        scheduler.apply_current_thread_policy(policy);
+        sched_param param{};
+        (void)pthread_getschedparam(pthread_self(), &sched_policy, &param);
+    });
+    critical.join();
+
+    if (scheduler.error_count() == 0U) {
+        EXPECT_EQ(sched_policy, SCHED_FIFO);
+    } else {
+        EXPECT_EQ(reported, scheduler.last_error());
+        EXPECT_EQ(reported, std::errc::operation_not_permitted);
+    }
+}
@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "sx/hal/thread_placement.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using sx::hal::CpuTopology;
+
+void WriteFile(const fs::path& path, const std::string& contents) {
+    fs::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::trunc);
+    out << contents << '\n';
+}
+
+// Fake sysfs: 4 cores x 2 SMT threads (cpu N and N+4 are siblings), a private L2 per core and
+// two L3 domains of two cores each.
+fs::path MakeFakeSysfs() {
+    const fs::path root = fs::temp_directory_path() / ("sx_topology_" + std::to_string(::getpid()));
+    fs::remove_all(root);
+    WriteFile(root / "online", "0-7");
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        const int core = cpu % 4;
+        const fs::path dir = root / ("cpu" + std::to_string(cpu));
+        const std::string siblings = std::to_string(core) + "," + std::to_string(core + 4);
+        WriteFile(dir / "topology" / "core_id", std::to_string(core));
+        WriteFile(dir / "topology" / "physical_package_id", "0");
+        WriteFile(dir / "topology" / "thread_siblings_list", siblings);
+        fs::create_directories(dir / "node0");
+        WriteFile(dir / "cache" / "index0" / "level", "1");
+        WriteFile(dir / "cache" / "index0" / "type", "Instruction");
+        WriteFile(dir / "cache" / "index0" / "shared_cpu_list", siblings);
+        WriteFile(dir / "cache" / "index2" / "level", "2");
+        WriteFile(dir / "cache" / "index2" / "type", "Unified");
+        WriteFile(dir / "cache" / "index2" / "shared_cpu_list", siblings);
+        WriteFile(dir / "cache" / "index3" / "level", "3");
+        WriteFile(dir / "cache" / "index3" / "type", "Unified");
+        WriteFile(dir / "cache" / "index3" / "shared_cpu_list", core < 2 ? "0-1,4-5" : "2-3,6-7");
+    }
+    return root;
+}
+
+}  // namespace
+
+TEST(CpuTopology, ParsesSysfsTree) {
+    std::vector<int> cpus;
+    EXPECT_TRUE(CpuTopology::parse_cpu_list("0-2,8,10-11", cpus));
+    EXPECT_EQ(cpus, (std::vector<int>{0, 1, 2, 8, 10, 11}));
+    EXPECT_FALSE(CpuTopology::parse_cpu_list("3-1", cpus));
+    EXPECT_FALSE(CpuTopology::parse_cpu_list("x", cpus));
+
+    const fs::path root = MakeFakeSysfs();
+    CpuTopology topology;
+    ASSERT_FALSE(topology.load(root.string()));
+    fs::remove_all(root);
+
+    ASSERT_EQ(topology.cpus().size(), 8U);
+    EXPECT_TRUE(topology.has_smt());
+    const auto* cpu6 = topology.find(6);
+    ASSERT_NE(cpu6, nullptr);
+    EXPECT_EQ(cpu6->core_id, 2);
+    EXPECT_EQ(cpu6->numa_node, 0);
+    EXPECT_EQ(cpu6->l2_domain, 2);
+    EXPECT_EQ(cpu6->l3_domain, 2);
+    EXPECT_EQ(cpu6->smt_siblings, (std::vector<int>{2, 6}));
+    EXPECT_EQ(topology.physical_cores(), (std::vector<std::vector<int>>{{0, 4}, {1, 5}, {2, 6}, {3, 7}}));
+
+    CpuTopology missing;
+    EXPECT_EQ(missing.load((root / "nope").string()), std::errc::no_such_file_or_directory);
+}
+
+TEST(ThreadPlacement, KeepsCriticalLoopsOffSmtSiblings) {
+    const fs::path root = MakeFakeSysfs();
+    CpuTopology topology;
+    ASSERT_FALSE(topology.load(root.string()));
+    fs::remove_all(root);
+
+    sx::hal::PlacementPolicy policy;
+    policy.enabled = true;
+    policy.critical_cores = 1U;
+    policy.io_cores = 1U;
+    const auto plan = sx::hal::plan_placement(topology, policy);
+
+    EXPECT_EQ(plan.critical_cpus, (std::vector<int>{3}));  // cpu 7 (its sibling) stays idle
+    EXPECT_EQ(plan.io_cpus, (std::vector<int>{0, 4}));     // one core, first L3 domain
+    EXPECT_EQ(plan.cpu_cpus, (std::vector<int>{1, 2, 5, 6}));
+
+    policy.isolate_critical_smt = false;
+    policy.allowed_cpus = {0, 1, 2, 3};  // e.g. a cpuset without the SMT threads
+    const auto narrow = sx::hal::plan_placement(topology, policy);
+    EXPECT_EQ(narrow.critical_cpus, (std::vector<int>{3}));
+    EXPECT_EQ(narrow.io_cpus, (std::vector<int>{0}));
+    EXPECT_EQ(narrow.cpu_cpus, (std::vector<int>{1, 2}));
+
+    // Three IO cores would straddle both L3 domains: the IO set stops at the first one.
+    policy.critical_cores = 0U;
+    policy.allowed_cpus.clear();
+    policy.io_cores = 3U;
+    const auto capped = sx::hal::plan_placement(topology, policy);
+    EXPECT_EQ(capped.io_cpus, (std::vector<int>{0, 1, 4, 5}));
+    EXPECT_EQ(capped.cpu_cpus, (std::vector<int>{2, 3, 6, 7}));
+
+    sx::hal::LinuxSchedulerConfig config;
+    plan.apply(config);
+    EXPECT_EQ(config.critical.cpus, plan.critical_cpus);
+    EXPECT_TRUE(config.cpu.pin_round_robin);
+    EXPECT_FALSE(config.io.pin_round_robin);
+}
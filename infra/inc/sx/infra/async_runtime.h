@@ -1,18 +1,35 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <system_error>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "sx/hal/i_thread_scheduler.h"
+#include "sx/infra/critical_loop.h"
+#include "sx/infra/executor.h"
+#include "sx/infra/file_io.h"
+#include "sx/infra/future.h"
+#include "sx/infra/runtime_metrics.h"
+#include "sx/infra/watchdog.h"
 #include "sx/types/thread_policy.h"
 
 namespace sx::infra {
 
+class TaskGroup;
+namespace detail {
+struct TaskGroupState;
+}  // namespace detail
+
 class ITimer {
 public:
     virtual ~ITimer() = default;
@@ -22,10 +39,91 @@ public:
     virtual void cancel() = 0;
 };
 
-class IExecutor {
+struct PeriodicTick {
+    uint64_t index = 0;                              // periods since start(), skipped ones included
+    std::chrono::steady_clock::time_point deadline;  // when this tick was due
+    uint64_t missed = 0;                             // periods skipped right before this one
+};
+
+// Fixed-rate timer with absolute deadlines: tick k is due at start + k * period regardless of
+// when earlier callbacks ran, so the schedule does not drift. Callbacks never overlap or pile
+// up; deadlines passed while a callback (or the IO pool) was late are skipped and counted.
+class IPeriodicTimer {
 public:
-    virtual ~IExecutor() = default;
-    virtual void post(std::function<void()> f) = 0;
+    virtual ~IPeriodicTimer() = default;
+
+    // (Re)starts the schedule from now; the first tick is due one period later.
+    virtual void start(std::chrono::nanoseconds period, std::function<void(const PeriodicTick&)> callback) = 0;
+    // No further ticks are scheduled; a callback already running completes.
+    virtual void stop() = 0;
+    [[nodiscard]] virtual uint64_t overruns() const = 0;
+};
+
+// CPU pool implementation, selected at init().
+enum class CpuPoolKind {
+    kAsio,          // all CPU workers run one shared asio::io_context
+    kWorkStealing,  // per-worker Chase-Lev deques, LIFO local pop, random stealing
+};
+
+// IO pool layout, selected at init().
+enum class IoPoolKind {
+    kShared,     // all IO workers run one asio::io_context
+    kPerThread,  // one io_context per IO worker; keyed work, timers and sockets stay on one thread
+};
+
+// Elastic CPU pool sizing (RuntimeOptions::elastic). cpu_threads becomes the ceiling and the
+// pool starts with min_threads workers. A supervisor keeps one probe task queued on the pool;
+// whenever the probe has waited spawn_after (queued work, every worker busy) one worker is
+// added, and a worker that found nothing to do for retire_after exits again, never going below
+// min_threads. The gap between the two is the hysteresis: bursts grow the pool within a few
+// spawn_after, while it only shrinks after a sustained lull. The probe costs one wake-up per
+// spawn_after on an idle pool.
+struct ElasticPoolOptions {
+    bool enabled = false;
+    std::size_t min_threads = 1U;
+    std::chrono::milliseconds spawn_after{2};
+    std::chrono::milliseconds retire_after{5000};
+};
+
+// Running CPU workers and the current elastic bounds (min == max == cpu_threads when fixed).
+struct CpuPoolSize {
+    std::size_t live = 0;
+    std::size_t min = 0;
+    std::size_t max = 0;
+};
+
+struct RuntimeOptions {
+    std::size_t io_threads = 2U;
+    std::size_t cpu_threads = 4U;  // 0 => hardware_concurrency()
+    IoPoolKind io_pool = IoPoolKind::kShared;
+    CpuPoolKind cpu_pool = CpuPoolKind::kAsio;
+    // Resolution of create_wheel_timer() timers.
+    std::chrono::microseconds timer_wheel_tick{1000};
+    // Record queue delay, run time and backlog for metrics(). Off, the post path only pays a
+    // null check; on, every task is timed twice and may no longer fit Task's inline storage.
+    bool enable_metrics = false;
+    // Stall detection for the pools and critical loops; see watchdog.h.
+    WatchdogOptions watchdog;
+    // Grow and shrink the CPU pool with load; see ElasticPoolOptions.
+    ElasticPoolOptions elastic;
+    // Backend and buffers for async_read() / async_write(); see file_io.h.
+    FileIoOptions file_io;
+};
+
+// Priority class for post_cpu(options, f). Lower value runs first.
+enum class TaskPriority : uint8_t {
+    kHigh = 0,        // frame-critical work
+    kNormal = 1,
+    kBackground = 2,  // batch work that may wait
+};
+
+struct TaskOptions {
+    TaskPriority priority = TaskPriority::kNormal;
+    // Within a priority class, earlier deadlines run first; tasks without one keep FIFO order
+    // after those that have one.
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // Skip the task instead of running it after its deadline.
+    bool drop_if_expired = false;
 };
 
 class AsyncRuntime {
@@ -36,24 +134,147 @@ public:
     // Inject a platform thread scheduler (nullable). Starts IO/CPU worker threads.
     void init(std::shared_ptr<sx::hal::IThreadScheduler> scheduler, std::size_t io_n = 2U,
               std::size_t cpu_n = 4U);
+    void init(std::shared_ptr<sx::hal::IThreadScheduler> scheduler, const RuntimeOptions& options);
 
     // Stop all loops and join threads. Safe to call multiple times.
     void stop();
+    // Graceful variant: first waits up to `drain_timeout` for every live TaskGroup to run out
+    // of tasks, then cancels the groups still busy (queued tasks are skipped, running ones see
+    // their token) and stops as above. Tasks posted outside a group are not waited for.
+    void stop(std::chrono::milliseconds drain_timeout);
 
+    // Thread-safe and lock-free; never blocks behind init()/stop(). Tasks posted before
+    // init() or once stop() has begun are dropped.
     template <typename Func>
     void post_io(Func&& f) {
-        post_io_impl(std::function<void()>(std::forward<Func>(f)));
+        post_io_impl(Task(std::forward<Func>(f)));
     }
 
     template <typename Func>
     void post_cpu(Func&& f) {
-        post_cpu_impl(std::function<void()>(std::forward<Func>(f)));
+        post_cpu_impl(Task(std::forward<Func>(f)));
+    }
+
+    // post_io / post_cpu that run `f` before returning when the caller already is a worker of
+    // that pool, so chained stages skip the queue hop and wakeup (bounded nesting; see
+    // IExecutor::dispatch()). From any other thread they are plain posts.
+    template <typename Func>
+    void dispatch_io(Func&& f) {
+        dispatch_io_impl(Task(std::forward<Func>(f)));
+    }
+
+    template <typename Func>
+    void dispatch_cpu(Func&& f) {
+        dispatch_cpu_impl(Task(std::forward<Func>(f)));
+    }
+
+    // The pools as executors (post = post_io / post_cpu), e.g. for Future::then(). Pool workers
+    // report theirs from IExecutor::current(). Valid for the runtime's lifetime, across re-init.
+    [[nodiscard]] std::shared_ptr<IExecutor> io_executor() const;
+    [[nodiscard]] std::shared_ptr<IExecutor> cpu_executor() const;
+
+    // IO task for the worker that owns `key` (key % io_shards()): with IoPoolKind::kPerThread,
+    // everything posted with one key - a connection id, say - runs on one thread in post order,
+    // next to that key's timers and sockets. With a shared IO pool it is a plain post_io().
+    // Unkeyed post_io() from an IO worker stays on that worker; other threads round-robin.
+    template <typename Func>
+    void post_io_keyed(std::size_t key, Func&& f) {
+        post_io_keyed_impl(key, Task(std::forward<Func>(f)));
+    }
+
+    // IO contexts in use: io_threads with IoPoolKind::kPerThread, else 1 (0 when not running).
+    [[nodiscard]] std::size_t io_shards() const noexcept;
+
+    // Prioritized CPU task. The choice is made at dequeue time: whenever a worker picks up
+    // prioritized work it takes the highest-priority, earliest-deadline task queued at that
+    // moment, so late-arriving critical work overtakes queued background work. kHigh tasks
+    // also overtake plain post_cpu() tasks already queued (workers look for them between
+    // tasks); kNormal and kBackground ones only reorder among prioritized tasks and otherwise
+    // take their FIFO turn with plain tasks.
+    template <typename Func>
+    void post_cpu(const TaskOptions& options, Func&& f) {
+        post_cpu_prioritized_impl(options, Task(std::forward<Func>(f)));
+    }
+
+    // Prioritized tasks skipped because their deadline had passed (drop_if_expired).
+    [[nodiscard]] std::uint64_t expired_task_drops() const noexcept;
+
+    // Per-pool and per-named-strand counters, latency histograms and worker busy ratios since
+    // the last init(). `enabled` is false unless RuntimeOptions::enable_metrics was set.
+    [[nodiscard]] RuntimeMetrics metrics() const;
+
+    [[nodiscard]] CpuPoolSize cpu_pool_size() const noexcept;
+    // Moves the elastic bounds without a restart, e.g. to park workers while a co-located
+    // process needs the cores. `max_threads` is capped at RuntimeOptions::cpu_threads; workers
+    // above the new ceiling exit once idle, and the pool grows back to a raised floor within
+    // one spawn_after. No-op unless the runtime is running with elastic sizing.
+    void set_cpu_pool_limits(std::size_t min_threads, std::size_t max_threads);
+
+    // Receives watchdog reports on the watchdog thread. May be set before or after init().
+    void set_stall_handler(std::function<void(const StallReport&)> handler);
+    // Stalls reported since construction.
+    [[nodiscard]] std::uint64_t stalls_detected() const noexcept;
+    // Called by a critical loop once per cycle while the watchdog is enabled; a loop that has
+    // kicked once and then stays silent for WatchdogOptions::critical_budget is reported.
+    static void watchdog_kick() noexcept;
+
+    // Runs fn on the CPU pool; the result (or exception) arrives through the returned Future.
+    // If the runtime is not running the task is dropped and the future fails with
+    // std::future_errc::broken_promise.
+    template <typename Fn>
+    auto submit(Fn&& fn) -> Future<std::invoke_result_t<std::decay_t<Fn>&>> {
+        using R = std::invoke_result_t<std::decay_t<Fn>&>;
+        Promise<R> promise;
+        Future<R> future = promise.get_future();
+        post_cpu_impl(Task([p = std::move(promise), f = std::forward<Fn>(fn)]() mutable { detail::fulfill(p, f); }));
+        return future;
     }
 
     // Resource factory
     std::shared_ptr<ITimer> create_timer();
+    // Timer whose callbacks run on the IO worker that owns `key` (see post_io_keyed()).
+    std::shared_ptr<ITimer> create_timer(std::size_t key);
+    // Timer on a shared hierarchical timing wheel: O(1) arm, re-arm and cancel, rounded up to
+    // RuntimeOptions::timer_wheel_tick. For large numbers of frequently rescheduled timeouts.
+    // Each IO context has its own wheel; the keyed form uses the one of the worker owning `key`.
+    std::shared_ptr<ITimer> create_wheel_timer();
+    std::shared_ptr<ITimer> create_wheel_timer(std::size_t key);
+    // Drift-free periodic timer on the IO pool (nanosecond resolution). Stops when released.
+    std::shared_ptr<IPeriodicTimer> create_periodic_timer();
+    // Serial executors on the CPU / IO pool: tasks run one at a time, in post order per
+    // producer, on whichever worker picks up the strand's current batch. Posting is lock-free,
+    // and strands are fully independent of each other. With IoPoolKind::kPerThread an IO
+    // strand is simply pinned to one IO worker.
     std::shared_ptr<IExecutor> create_cpu_strand();
     std::shared_ptr<IExecutor> create_io_strand();
+    // Same, with the strand's own entry in metrics().strands while metrics are enabled.
+    std::shared_ptr<IExecutor> create_cpu_strand(std::string name);
+    std::shared_ptr<IExecutor> create_io_strand(std::string name);
+
+    // Asynchronous file I/O on a descriptor the caller opened (and closes after the callback).
+    // The disk work happens on io_uring or on the fallback threads, never on the IO pool; the
+    // callback runs on `executor` (a strand, say) or, when null, on the IO pool. Reads and
+    // writes cover the full size unless they fail or a read hits end of file. `data` must stay
+    // valid until the callback, or until stop() returns: stop() may drop the callback of an
+    // operation it cut short. Dropped, without a callback, while the runtime is not running.
+    void async_read(int fd, void* data, std::size_t size, std::uint64_t offset, FileIoCallback callback,
+                    std::shared_ptr<IExecutor> executor = nullptr);
+    void async_write(int fd, const void* data, std::size_t size, std::uint64_t offset, FileIoCallback callback,
+                     std::shared_ptr<IExecutor> executor = nullptr);
+    // Same on a buffer from acquire_file_buffer(): io_uring uses READ_FIXED / WRITE_FIXED, so
+    // the kernel skips pinning the pages for every operation. `size` <= buffer.size().
+    void async_read(int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset,
+                    FileIoCallback callback, std::shared_ptr<IExecutor> executor = nullptr);
+    void async_write(int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset,
+                     FileIoCallback callback, std::shared_ptr<IExecutor> executor = nullptr);
+    // Not ordered against other operations: issue it once the writes it must cover completed.
+    void async_fsync(int fd, FileIoCallback callback, std::shared_ptr<IExecutor> executor = nullptr);
+    void async_fdatasync(int fd, FileIoCallback callback, std::shared_ptr<IExecutor> executor = nullptr);
+    // One of FileIoOptions::registered_buffers; empty when all are leased, the pool is disabled
+    // or the runtime is not running.
+    [[nodiscard]] FileBuffer acquire_file_buffer();
+    // Backend in use (starts the file I/O engine); kAuto while not running.
+    [[nodiscard]] FileIoBackend file_io_backend();
 
     // Escape hatch: start a managed dedicated loop thread.
     // If Func is invocable with (std::atomic<bool>&), it will receive a stop flag.
@@ -68,15 +289,113 @@ public:
         }
     }
 
+    // Managed variant: runs `f` every options.period on a dedicated thread placed by
+    // options.cpu / options.realtime, with sleep-then-spin pacing, wake-latency / run-time
+    // histograms and a watchdog kick per cycle (see critical_loop.h). `f` takes either
+    // (const LoopIteration&) or nothing. The loop ends with stop() or the returned handle's
+    // stop(); the handle also exposes its statistics. Returns nullptr if not running.
+    template <typename Func>
+    std::shared_ptr<CriticalLoop> spawn_critical_loop(const CriticalLoopOptions& options, Func&& f) {
+        CriticalLoop::Body body;
+        if constexpr (std::is_invocable_v<Func, const LoopIteration&>) {
+            body = std::forward<Func>(f);
+        } else {
+            body = [fn = std::forward<Func>(f)](const LoopIteration&) mutable { fn(); };
+        }
+        auto loop = std::make_shared<CriticalLoop>(options);
+        const bool started = spawn_critical_loop_impl(
+            loop->thread_policy(),
+            [loop, body = std::move(body)](std::atomic<bool>& stop) { loop->run(stop, body); });
+        return started ? loop : nullptr;
+    }
+
+    // Data parallelism on the CPU pool. Work over [first, last) is handed out in guided chunks
+    // (large first, shrinking to `grain`); the calling thread runs chunks too and returns once
+    // every chunk is done. The first exception thrown by `fn` is rethrown here. Safe to call
+    // from a CPU worker. Without a running runtime everything runs on the caller.
+    //
+    // `fn` is called as fn(begin, end) for each chunk if it accepts two indices, else fn(i).
+    template <typename Fn>
+    void parallel_for(std::size_t first, std::size_t last, std::size_t grain, Fn&& fn) {
+        auto body = [&fn](std::size_t /*slot*/, std::size_t begin, std::size_t end) {
+            if constexpr (std::is_invocable_v<Fn&, std::size_t, std::size_t>) {
+                fn(begin, end);
+            } else {
+                for (std::size_t i = begin; i < end; ++i) fn(i);
+            }
+        };
+        run_parallel(first, last, grain, parallel_slots(), body);
+    }
+
+    // `map(begin, end)` returns the partial result of one chunk; partials are folded with
+    // `combine` in index order, so it must be associative but need not be commutative.
+    template <typename T, typename Map, typename Combine>
+    T parallel_reduce(std::size_t first, std::size_t last, std::size_t grain, T identity, Map&& map,
+                      Combine&& combine) {
+        struct Chunk {
+            std::size_t begin;
+            T value;
+        };
+        struct alignas(64) Slot {
+            std::vector<Chunk> chunks;
+        };
+        std::vector<Slot> slots(parallel_slots());
+        auto body = [&](std::size_t slot, std::size_t begin, std::size_t end) {
+            slots[slot].chunks.push_back(Chunk{begin, map(begin, end)});
+        };
+        run_parallel(first, last, grain, slots.size(), body);
+
+        std::vector<Chunk> chunks;
+        for (auto& slot : slots) std::move(slot.chunks.begin(), slot.chunks.end(), std::back_inserter(chunks));
+        std::sort(chunks.begin(), chunks.end(), [](const Chunk& a, const Chunk& b) { return a.begin < b.begin; });
+        T result = std::move(identity);
+        for (auto& chunk : chunks) result = combine(std::move(result), std::move(chunk.value));
+        return result;
+    }
+
+    // Runs every callable, possibly concurrently, and returns when all have finished.
+    template <typename... Fns>
+    void parallel_invoke(Fns&&... fns) {
+        parallel_for(0U, sizeof...(Fns), 1U, [&](std::size_t i) {
+            std::size_t k = 0;
+            ((i == k++ ? static_cast<void>(fns()) : static_cast<void>(0)), ...);
+        });
+    }
+
 private:
+    friend class TaskGroup;
+    // Admits an abandoned `group` to the registry while running; otherwise it stays abandoned.
+    void register_task_group(const std::shared_ptr<detail::TaskGroupState>& group);
+
+    using RangeBody = void (*)(void* ctx, std::size_t slot, std::size_t begin, std::size_t end);
+
+    template <typename Body>
+    void run_parallel(std::size_t first, std::size_t last, std::size_t grain, std::size_t slots, Body& body) {
+        parallel_for_impl(first, last, grain, slots, &AsyncRuntime::invoke_body<Body>, &body);
+    }
+
+    template <typename Body>
+    static void invoke_body(void* ctx, std::size_t slot, std::size_t begin, std::size_t end) {
+        (*static_cast<Body*>(ctx))(slot, begin, end);
+    }
+
+    // Caller plus one slot per CPU worker. parallel_for_impl() passes slot ids below `slots`.
+    [[nodiscard]] std::size_t parallel_slots() const noexcept;
+    void parallel_for_impl(std::size_t first, std::size_t last, std::size_t grain, std::size_t slots,
+                           RangeBody body, void* ctx);
+
     AsyncRuntime(const AsyncRuntime&) = delete;
     AsyncRuntime& operator=(const AsyncRuntime&) = delete;
     AsyncRuntime(AsyncRuntime&&) = delete;
     AsyncRuntime& operator=(AsyncRuntime&&) = delete;
 
-    void post_io_impl(std::function<void()> f);
-    void post_cpu_impl(std::function<void()> f);
-    void spawn_critical_loop_impl(const sx::types::ThreadPolicy& policy,
+    void post_io_impl(Task f);
+    void post_io_keyed_impl(std::size_t key, Task f);
+    void post_cpu_impl(Task f);
+    void dispatch_io_impl(Task f);
+    void dispatch_cpu_impl(Task f);
+    void post_cpu_prioritized_impl(const TaskOptions& options, Task f);
+    bool spawn_critical_loop_impl(const sx::types::ThreadPolicy& policy,
                                   std::function<void(std::atomic<bool>&)> f);
 
     struct Impl;
@@ -86,6 +405,8 @@ private:
     // Use requires explicit approval.
     friend class AsioSerial;
     void* internal_get_io_context();
+    // The context owning `key`, for sockets that should live on one IO thread.
+    void* internal_get_io_context(std::size_t key);
 };
 
 }  // namespace sx::infra
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "sx/infra/runtime_metrics.h"
+#include "sx/types/thread_policy.h"
+
+namespace sx::infra {
+
+struct CriticalLoopOptions {
+    std::chrono::nanoseconds period{std::chrono::milliseconds(1)};
+    // How long before each deadline the loop stops sleeping and busy-polls the clock instead.
+    // 0 sleeps all the way (lowest CPU use, wake latency = timer slack + scheduler); a budget
+    // >= period never sleeps (one core burned, wake latency in the sub-microsecond range).
+    // A budget a little above the platform's typical wake latency gets most of both.
+    std::chrono::nanoseconds spin_budget{0};
+    // Dedicated (ideally isolcpus / nohz_full) CPU; -1 keeps the scheduler's placement.
+    int cpu = -1;
+    // SCHED_FIFO through the runtime's IThreadScheduler, if it has one.
+    bool realtime = false;
+    int realtime_priority = -1;
+};
+
+// Passed to the loop body once per cycle.
+struct LoopIteration {
+    uint64_t index = 0;                              // cycles since start, skipped ones included
+    std::chrono::steady_clock::time_point deadline;  // when this cycle was due
+    std::chrono::nanoseconds wake_latency{0};        // how late the body started
+    uint64_t missed = 0;                             // deadlines skipped right before this one
+};
+
+struct CriticalLoopStats {
+    uint64_t iterations = 0;
+    uint64_t overruns = 0;  // deadlines skipped because a cycle ran too long (sum of missed)
+    LatencyHistogram wake_latency;
+    LatencyHistogram exec_time;
+};
+
+// Fixed-rate loop on absolute deadlines (start + k * period, like LoopRate) with a hybrid
+// sleep-then-spin wait, per-iteration jitter statistics and a watchdog kick every cycle.
+// Usually started by AsyncRuntime::spawn_critical_loop(CriticalLoopOptions, fn); run() can
+// also drive it on a thread the caller owns.
+class CriticalLoop {
+public:
+    using Body = std::function<void(const LoopIteration&)>;
+
+    explicit CriticalLoop(const CriticalLoopOptions& options);
+    ~CriticalLoop();
+
+    // Runs `body` every period on the calling thread until `stop` or stop() is set.
+    void run(const std::atomic<bool>& stop, const Body& body);
+
+    // Makes run() return after the current cycle. Thread-safe.
+    void stop() noexcept;
+
+    // Thread-safe; cheap enough to poll from a monitoring task.
+    [[nodiscard]] CriticalLoopStats stats() const;
+    [[nodiscard]] const CriticalLoopOptions& options() const noexcept { return options_; }
+    [[nodiscard]] sx::types::ThreadPolicy thread_policy() const noexcept;
+
+    CriticalLoop(const CriticalLoop&) = delete;
+    CriticalLoop& operator=(const CriticalLoop&) = delete;
+    CriticalLoop(CriticalLoop&&) = delete;
+    CriticalLoop& operator=(CriticalLoop&&) = delete;
+
+private:
+    const CriticalLoopOptions options_;
+
+    struct Impl;
+    std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace sx::infra
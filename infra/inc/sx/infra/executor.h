@@ -0,0 +1,87 @@
+#pragma once
+
+#include <utility>
+
+#include "sx/utils/task.h"
+
+namespace sx::infra {
+
+// Move-only void() callable with 64-byte inline storage; see sx/utils/task.h.
+using Task = sx::utils::Task;
+
+class IExecutor {
+public:
+    // dispatch() calls nested deeper than this inside inline runs are posted instead, so a chain
+    // that keeps dispatching from dispatched work cannot grow the stack without bound.
+    static constexpr int kMaxDispatchDepth = 8;
+
+    virtual ~IExecutor() = default;
+    virtual void post(Task f) = 0;
+
+    // Runs `f` before returning when the calling thread is already running this executor's
+    // work (a task of this strand, a worker of this pool), else post(f). Inline runs keep the
+    // executor's guarantees - a strand is still serial - but skip the queue, so `f` overtakes
+    // work already queued, is not metered, and its exceptions reach the caller.
+    virtual void dispatch(Task f);
+
+    // True while the calling thread runs this executor's work.
+    [[nodiscard]] virtual bool running_in_this_thread() const noexcept;
+
+    // The executor whose work the calling thread is running (the innermost one for nested
+    // strands), or nullptr on threads outside any executor.
+    [[nodiscard]] static IExecutor* current() noexcept;
+
+private:
+    static inline thread_local int dispatch_depth_ = 0;
+};
+
+// For IExecutor implementations: marks the calling thread as running `executor`'s work while
+// alive. Executors open one around each task or batch they run; scopes nest.
+class ExecutorScope {
+public:
+    explicit ExecutorScope(IExecutor* executor) noexcept : executor_(executor), prev_(top_) { top_ = this; }
+    ~ExecutorScope() { top_ = prev_; }
+
+    // Fallback for the rest of the calling thread's life, beneath any scope: pool workers bind
+    // their pool's executor once at start.
+    static void bind_thread(IExecutor* executor) noexcept { thread_executor_ = executor; }
+
+    [[nodiscard]] static IExecutor* current() noexcept { return top_ != nullptr ? top_->executor_ : thread_executor_; }
+
+    [[nodiscard]] static bool active(const IExecutor* executor) noexcept {
+        for (const ExecutorScope* s = top_; s != nullptr; s = s->prev_) {
+            if (s->executor_ == executor) return true;
+        }
+        return executor != nullptr && thread_executor_ == executor;
+    }
+
+    ExecutorScope(const ExecutorScope&) = delete;
+    ExecutorScope& operator=(const ExecutorScope&) = delete;
+    ExecutorScope(ExecutorScope&&) = delete;
+    ExecutorScope& operator=(ExecutorScope&&) = delete;
+
+private:
+    IExecutor* executor_;
+    ExecutorScope* prev_;
+    static inline thread_local ExecutorScope* top_ = nullptr;
+    static inline thread_local IExecutor* thread_executor_ = nullptr;
+};
+
+inline void IExecutor::dispatch(Task f) {
+    if (dispatch_depth_ < kMaxDispatchDepth && running_in_this_thread()) {
+        struct Depth {
+            Depth() noexcept { ++dispatch_depth_; }
+            ~Depth() { --dispatch_depth_; }
+        } depth;
+        ExecutorScope scope(this);
+        f();
+        return;
+    }
+    post(std::move(f));
+}
+
+inline bool IExecutor::running_in_this_thread() const noexcept { return ExecutorScope::active(this); }
+
+inline IExecutor* IExecutor::current() noexcept { return ExecutorScope::current(); }
+
+}  // namespace sx::infra
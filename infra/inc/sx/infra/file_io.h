@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <system_error>
+
+namespace sx::infra {
+
+enum class FileIoBackend {
+    kAuto,        // io_uring when the kernel allows it (not blocked by seccomp etc.), else kThreadPool
+    kIoUring,     // io_uring only; operations fail with ENOSYS / EPERM where it is unavailable
+    kThreadPool,  // blocking pread / pwrite / fsync on a few dedicated threads
+};
+
+// AsyncRuntime file I/O (RuntimeOptions::file_io). The engine starts on first use.
+struct FileIoOptions {
+    FileIoBackend backend = FileIoBackend::kAuto;
+    // io_uring submission queue size; operations beyond it wait in a backlog, not in the kernel.
+    unsigned queue_depth = 128U;
+    // Buffers handed out by AsyncRuntime::acquire_file_buffer(). With io_uring they are
+    // registered with the ring (READ_FIXED / WRITE_FIXED: no per-operation page pinning); they
+    // are 4 KiB aligned, so O_DIRECT descriptors can use them. 0 disables the pool.
+    std::size_t registered_buffers = 0U;
+    std::size_t registered_buffer_size = 64U * 1024U;
+    // Worker threads of the kThreadPool backend.
+    std::size_t fallback_threads = 2U;
+};
+
+// Result of one operation: bytes transferred (the full size unless an error or, for reads,
+// end of file cut it short).
+using FileIoCallback = std::function<void(const std::error_code& ec, std::size_t bytes)>;
+
+namespace detail {
+class FileBufferPool;
+}  // namespace detail
+
+// Lease of one buffer from the runtime's file buffer pool; returned to the pool when destroyed.
+// Move-only. Empty when the pool is exhausted or disabled.
+class FileBuffer {
+public:
+    FileBuffer() = default;
+    FileBuffer(FileBuffer&& other) noexcept;
+    FileBuffer& operator=(FileBuffer&& other) noexcept;
+    FileBuffer(const FileBuffer&) = delete;
+    FileBuffer& operator=(const FileBuffer&) = delete;
+    ~FileBuffer();
+
+    [[nodiscard]] explicit operator bool() const noexcept { return data_ != nullptr; }
+    [[nodiscard]] std::byte* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+private:
+    friend class detail::FileBufferPool;
+    friend class FileIoService;
+
+    std::shared_ptr<detail::FileBufferPool> pool_;
+    std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+    int index_ = -1;  // slot in the pool, also its io_uring registration index
+};
+
+}  // namespace sx::infra
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "sx/infra/executor.h"
+#include "sx/infra/node_cache.h"
+#include "sx/utils/mpsc_queue.h"
+
+namespace sx::infra {
+
+template <typename T>
+class Future;
+template <typename T>
+class Promise;
+
+namespace detail {
+
+template <typename T>
+using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+// Shared state of one Promise/Future pair. Intrusively ref-counted and recycled through
+// NodeCache, so chained stages do not hit the allocator once warm, even when states are made
+// on one thread and released on another. Holds at most one continuation (futures are
+// single-consumer).
+template <typename T>
+class FutureState : public sx::utils::MPSCNode {
+public:
+    static FutureState* make() {
+        FutureState* s = NodeCache<FutureState>::acquire();
+        s->refs_.store(1, std::memory_order_relaxed);
+        return s;
+    }
+
+    void add_ref() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        value_.reset();
+        error_ = nullptr;
+        continuation_.reset();
+        phase_.store(kPending, std::memory_order_relaxed);
+        NodeCache<FutureState>::release(this);
+    }
+
+    template <typename... Args>
+    void set_value(Args&&... args) {
+        value_.emplace(std::forward<Args>(args)...);
+        complete();
+    }
+
+    void set_exception(std::exception_ptr e) {
+        error_ = std::move(e);
+        complete();
+    }
+
+    [[nodiscard]] bool ready() const noexcept { return phase_.load(std::memory_order_acquire) == kReady; }
+
+    // Runs `k` once the state is ready: right here if it already is, otherwise inline on
+    // the thread that completes it.
+    void on_ready(Task k) {
+        continuation_ = std::move(k);
+        uint8_t expected = kPending;
+        if (phase_.compare_exchange_strong(expected, kContinuation, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+            return;
+        }
+        Task now = std::move(continuation_);
+        now();
+    }
+
+    // Valid once ready().
+    [[nodiscard]] const std::exception_ptr& error() const noexcept { return error_; }
+    [[nodiscard]] Stored<T>& value() noexcept { return *value_; }
+
+private:
+    static constexpr uint8_t kPending = 0;
+    static constexpr uint8_t kContinuation = 1;
+    static constexpr uint8_t kReady = 2;
+
+    friend class NodeCache<FutureState>;
+    FutureState() = default;
+
+    void complete() {
+        if (phase_.exchange(kReady, std::memory_order_acq_rel) != kContinuation) return;
+        Task k = std::move(continuation_);
+        k();
+    }
+
+    std::atomic<uint8_t> phase_{kPending};
+    std::atomic<uint32_t> refs_{0};
+    std::optional<Stored<T>> value_;
+    std::exception_ptr error_;
+    Task continuation_;
+};
+
+// Owning handle to a FutureState.
+template <typename T>
+class StateRef {
+public:
+    StateRef() noexcept = default;
+    explicit StateRef(FutureState<T>* s) noexcept : s_(s) {}
+    StateRef(StateRef&& o) noexcept : s_(std::exchange(o.s_, nullptr)) {}
+    StateRef& operator=(StateRef&& o) noexcept {
+        if (this != &o) {
+            reset();
+            s_ = std::exchange(o.s_, nullptr);
+        }
+        return *this;
+    }
+    StateRef(const StateRef&) = delete;
+    StateRef& operator=(const StateRef&) = delete;
+    ~StateRef() { reset(); }
+
+    [[nodiscard]] StateRef share() const noexcept {
+        if (s_ != nullptr) s_->add_ref();
+        return StateRef(s_);
+    }
+
+    void reset() noexcept {
+        if (s_ != nullptr) std::exchange(s_, nullptr)->release();
+    }
+
+    FutureState<T>* operator->() const noexcept { return s_; }
+    explicit operator bool() const noexcept { return s_ != nullptr; }
+
+private:
+    FutureState<T>* s_ = nullptr;
+};
+
+template <typename Fn, typename T>
+struct ThenResult {
+    using type = std::invoke_result_t<Fn&, T>;
+};
+template <typename Fn>
+struct ThenResult<Fn, void> {
+    using type = std::invoke_result_t<Fn&>;
+};
+
+// Calls fn(args...) and stores its result (or exception) into `promise`.
+template <typename R, typename Fn, typename... Args>
+void fulfill(Promise<R>& promise, Fn& fn, Args&&... args) {
+    try {
+        if constexpr (std::is_void_v<R>) {
+            fn(std::forward<Args>(args)...);
+            promise.set_value();
+        } else {
+            promise.set_value(fn(std::forward<Args>(args)...));
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+}  // namespace detail
+
+// Producer side. Destroying an unsatisfied promise (e.g. a task dropped because the runtime
+// stopped) completes the future with std::future_errc::broken_promise.
+template <typename T>
+class Promise {
+public:
+    Promise() : state_(detail::FutureState<T>::make()) {}
+    Promise(Promise&&) noexcept = default;
+    Promise& operator=(Promise&& o) noexcept {
+        if (this != &o) {
+            abandon();
+            state_ = std::move(o.state_);
+        }
+        return *this;
+    }
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+    ~Promise() { abandon(); }
+
+    // Call once, before the value is set.
+    [[nodiscard]] Future<T> get_future() { return Future<T>(state_.share()); }
+
+    template <typename... Args>
+    void set_value(Args&&... args) {
+        auto s = std::move(state_);
+        s->set_value(std::forward<Args>(args)...);
+    }
+
+    void set_exception(std::exception_ptr e) {
+        auto s = std::move(state_);
+        s->set_exception(std::move(e));
+    }
+
+private:
+    void abandon() {
+        if (state_) set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+    }
+
+    detail::StateRef<T> state_;
+};
+
+// Move-only, single-consumer future. Continuations attached with then() run inline when the
+// value is already there, otherwise on the completing thread or the given executor.
+template <typename T>
+class Future {
+public:
+    Future() noexcept = default;
+    Future(Future&&) noexcept = default;
+    Future& operator=(Future&&) noexcept = default;
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+    ~Future() = default;
+
+    [[nodiscard]] bool valid() const noexcept { return static_cast<bool>(state_); }
+    [[nodiscard]] bool ready() const noexcept { return state_ && state_->ready(); }
+
+    // Blocks until ready.
+    void wait() const {
+        if (state_->ready()) return;
+        struct Waiter {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool done = false;
+        } waiter;
+        state_->on_ready([&waiter]() {
+            std::lock_guard<std::mutex> lock(waiter.mutex);
+            waiter.done = true;
+            waiter.cv.notify_one();
+        });
+        std::unique_lock<std::mutex> lock(waiter.mutex);
+        waiter.cv.wait(lock, [&waiter]() { return waiter.done; });
+    }
+
+    // Blocks until ready, then returns the value or rethrows. Consumes the future.
+    T get() {
+        wait();
+        auto s = std::move(state_);
+        if (s->error()) std::rethrow_exception(s->error());
+        if constexpr (!std::is_void_v<T>) return std::move(s->value());
+    }
+
+    // fn(T) (or fn() for Future<void>) runs inline once this future is ready. An exception
+    // from this future skips fn and propagates. Consumes the future.
+    template <typename Fn>
+    auto then(Fn&& fn) -> Future<typename detail::ThenResult<std::decay_t<Fn>, T>::type> {
+        return then(nullptr, std::forward<Fn>(fn));
+    }
+
+    // As then(fn), but fn runs on `executor` (inline when executor is null).
+    template <typename Fn>
+    auto then(std::shared_ptr<IExecutor> executor, Fn&& fn)
+        -> Future<typename detail::ThenResult<std::decay_t<Fn>, T>::type> {
+        using R = typename detail::ThenResult<std::decay_t<Fn>, T>::type;
+        Promise<R> next;
+        Future<R> result = next.get_future();
+        detail::FutureState<T>* raw = state_.operator->();
+        raw->on_ready([src = std::move(state_), ex = std::move(executor), f = std::forward<Fn>(fn),
+                       p = std::move(next)]() mutable {
+            auto stage = [src = std::move(src), f = std::move(f), p = std::move(p)]() mutable {
+                if (src->error()) {
+                    p.set_exception(src->error());
+                } else if constexpr (std::is_void_v<T>) {
+                    detail::fulfill(p, f);
+                } else {
+                    detail::fulfill(p, f, std::move(src->value()));
+                }
+            };
+            if (ex) {
+                ex->post(std::move(stage));
+            } else {
+                stage();
+            }
+        });
+        return result;
+    }
+
+private:
+    template <typename U>
+    friend class Promise;
+    template <typename U>
+    friend class Future;
+    template <typename U>
+    friend Future<std::conditional_t<std::is_void_v<U>, void, std::vector<U>>> when_all(std::vector<Future<U>>);
+    template <typename U>
+    friend Future<std::conditional_t<std::is_void_v<U>, std::size_t, std::pair<std::size_t, U>>> when_any(
+        std::vector<Future<U>>);
+
+    explicit Future(detail::StateRef<T> s) noexcept : state_(std::move(s)) {}
+
+    detail::StateRef<T> state_;
+};
+
+template <typename T>
+Future<std::decay_t<T>> make_ready_future(T&& value) {
+    Promise<std::decay_t<T>> p;
+    auto f = p.get_future();
+    p.set_value(std::forward<T>(value));
+    return f;
+}
+
+inline Future<void> make_ready_future() {
+    Promise<void> p;
+    auto f = p.get_future();
+    p.set_value();
+    return f;
+}
+
+// Ready when every input is; yields the values in input order (nothing for void). If any
+// input fails, the first failure observed is propagated once all inputs are done.
+template <typename T>
+Future<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> when_all(std::vector<Future<T>> futures) {
+    using R = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+    struct Join {
+        std::atomic<std::size_t> remaining{0};
+        std::vector<std::optional<detail::Stored<T>>> values;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        Promise<R> promise;
+
+        void finish() {
+            if (error) {
+                promise.set_exception(error);
+            } else if constexpr (std::is_void_v<T>) {
+                promise.set_value();
+            } else {
+                std::vector<T> out;
+                out.reserve(values.size());
+                for (auto& v : values) out.push_back(std::move(*v));
+                promise.set_value(std::move(out));
+            }
+        }
+    };
+
+    auto join = std::make_shared<Join>();
+    Future<R> result = join->promise.get_future();
+    if (futures.empty()) {
+        join->finish();
+        return result;
+    }
+    join->remaining.store(futures.size(), std::memory_order_relaxed);
+    join->values.resize(futures.size());
+
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        auto* raw = futures[i].state_.operator->();
+        raw->on_ready([join, i, src = std::move(futures[i].state_)]() {
+            if (src->error()) {
+                std::lock_guard<std::mutex> lock(join->error_mutex);
+                if (!join->error) join->error = src->error();
+            } else {
+                join->values[i].emplace(std::move(src->value()));
+            }
+            if (join->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1U) join->finish();
+        });
+    }
+    return result;
+}
+
+// Ready when the first input is; yields its index (and value, for non-void inputs), or its
+// exception. Later completions are ignored.
+template <typename T>
+Future<std::conditional_t<std::is_void_v<T>, std::size_t, std::pair<std::size_t, T>>> when_any(
+    std::vector<Future<T>> futures) {
+    using R = std::conditional_t<std::is_void_v<T>, std::size_t, std::pair<std::size_t, T>>;
+    struct Race {
+        std::atomic<bool> decided{false};
+        Promise<R> promise;
+    };
+
+    auto race = std::make_shared<Race>();
+    Future<R> result = race->promise.get_future();
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        auto* raw = futures[i].state_.operator->();
+        raw->on_ready([race, i, src = std::move(futures[i].state_)]() {
+            if (race->decided.exchange(true, std::memory_order_acq_rel)) return;
+            if (src->error()) {
+                race->promise.set_exception(src->error());
+            } else if constexpr (std::is_void_v<T>) {
+                race->promise.set_value(i);
+            } else {
+                race->promise.set_value(i, std::move(src->value()));
+            }
+        });
+    }
+    return result;
+}
+
+}  // namespace sx::infra
@@ -6,12 +6,13 @@
 #include <system_error>
 
 #include "sx/hal/i_thread_scheduler.h"
+#include "sx/hal/thread_placement.h"
+#include "sx/infra/async_runtime.h"
 #include "sx/infra/logging.h"
 
 namespace sx::infra {
 
 class ConfigManager;
-class AsyncRuntime;
 class UnifiedBus;
 
 struct InfraConfig {
@@ -25,9 +26,17 @@ struct InfraConfig {
     // AsyncRuntime pools
     std::size_t io_threads = 2U;
     std::size_t cpu_threads = 0U;  // 0 => use hardware_concurrency()
+    CpuPoolKind cpu_pool = CpuPoolKind::kAsio;
+    // Stall watchdog; with logging enabled, reports go to the "watchdog" logger at warn level.
+    WatchdogOptions watchdog;
 
     // Optional platform scheduler for affinity / priority.
     std::shared_ptr<sx::hal::IThreadScheduler> scheduler;
+
+    // Topology-aware placement of the IO / CPU / critical threads. Used only when `scheduler`
+    // is null: init() reads /sys/devices/system/cpu, plans the masks within the process
+    // affinity (unless placement.allowed_cpus is set) and installs a LinuxThreadScheduler.
+    sx::hal::PlacementPolicy placement;
 };
 
 // DI-friendly container for infra components (no singletons).
@@ -49,6 +58,9 @@ public:
 
     [[nodiscard]] bool started() const noexcept { return started_; }
 
+    // Masks chosen for InfraConfig::placement (empty when placement is off).
+    [[nodiscard]] const sx::hal::PlacementPlan& placement() const noexcept { return placement_; }
+
     LogManager& logging();
     ConfigManager& config();
     AsyncRuntime& runtime();
@@ -57,6 +69,7 @@ public:
 private:
     bool started_ = false;
     InfraConfig cfg_;
+    sx::hal::PlacementPlan placement_;
 
     std::unique_ptr<LogManager> logging_;
     std::unique_ptr<ConfigManager> config_;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace sx::infra {
+
+// Sleeps until `deadline` on CLOCK_MONOTONIC (the clock behind std::chrono::steady_clock)
+// with an absolute clock_nanosleep, resuming after signal interruptions.
+void sleep_until(std::chrono::steady_clock::time_point deadline) noexcept;
+
+// Fixed-rate pacing for dedicated loops (see AsyncRuntime::spawn_critical_loop):
+//
+//   LoopRate rate(std::chrono::microseconds(500));
+//   while (!stop) { step(); rate.sleep(); }
+//
+// Deadlines are absolute (start + k * period), so the loop body's run time does not shift
+// later wake-ups. A cycle that overruns one or more deadlines skips them and waits for the
+// next boundary instead of bursting to catch up; skipped periods are counted in overruns().
+class LoopRate {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LoopRate(std::chrono::nanoseconds period) noexcept;
+
+    // Blocks until the next deadline. Returns false when this cycle overran.
+    bool sleep() noexcept;
+
+    // Restarts the schedule from now.
+    void reset() noexcept;
+
+    [[nodiscard]] std::chrono::nanoseconds period() const noexcept { return period_; }
+    [[nodiscard]] Clock::time_point next_deadline() const noexcept { return next_; }
+    [[nodiscard]] uint64_t cycles() const noexcept { return cycles_; }
+    [[nodiscard]] uint64_t overruns() const noexcept { return overruns_; }
+
+private:
+    std::chrono::nanoseconds period_;
+    Clock::time_point next_;
+    uint64_t cycles_ = 0;
+    uint64_t overruns_ = 0;
+};
+
+}  // namespace sx::infra
@@ -0,0 +1,134 @@
+/**
+ * @file node_cache.h
+ * @brief Per-thread free list for intrusive nodes (task nodes, future states)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sx/utils/mpsc_queue.h"
+
+namespace sx::infra {
+
+// Per-thread free list of MPSCNode types. Nodes are usually acquired on one thread (the
+// poster, the promise's owner) and released on another (the worker that ran them, the one that
+// dropped the last reference), so each list is balanced through a shared depot: a thread whose list fills up hands a batch of
+// kBatch nodes to it, and a thread whose list runs dry takes one back. Steady post/run traffic
+// therefore does not reach the allocator once warmed up, whichever threads post; the depot
+// costs one lock per batch.
+template <typename Node>
+class NodeCache {
+    static_assert(std::is_base_of_v<sx::utils::MPSCNode, Node>, "depot batches are linked through MPSCNode::next");
+
+public:
+    static constexpr std::size_t kMaxNodes = 256U;
+    static constexpr std::size_t kBatch = 64U;
+    static constexpr std::size_t kMaxBatches = 64U;  // beyond this the depot frees what it gets
+
+    // A cached node in whatever state release() got it, or a new one.
+    static Node* acquire() {
+        auto& nodes = local().nodes;
+        if (nodes.empty()) refill(nodes);
+        if (nodes.empty()) return new Node();
+        Node* node = nodes.back();
+        nodes.pop_back();
+        return node;
+    }
+
+    // The caller drops what the node holds first (captures, values) rather than when it is reused.
+    static void release(Node* node) {
+        auto& nodes = local().nodes;
+        if (nodes.size() >= kMaxNodes) spill(nodes);
+        nodes.push_back(node);  // capacity reserved up front: does not allocate
+    }
+
+    NodeCache(const NodeCache&) = delete;
+    NodeCache& operator=(const NodeCache&) = delete;
+    NodeCache(NodeCache&&) = delete;
+    NodeCache& operator=(NodeCache&&) = delete;
+
+private:
+    // Batches are chains through MPSCNode::next; `batches` is reserved up front.
+    struct Depot {
+        std::mutex mutex;
+        std::vector<sx::utils::MPSCNode*> batches;
+
+        Depot() { batches.reserve(kMaxBatches); }
+        ~Depot() {
+            for (sx::utils::MPSCNode* head : batches) free_chain(head);
+        }
+        Depot(const Depot&) = delete;
+        Depot& operator=(const Depot&) = delete;
+        Depot(Depot&&) = delete;
+        Depot& operator=(Depot&&) = delete;
+    };
+
+    NodeCache() { nodes.reserve(kMaxNodes); }
+    ~NodeCache() {
+        // Leftovers of an exiting thread go back to the depot for the threads that remain.
+        while (nodes.size() >= kBatch) spill(nodes);
+        for (Node* node : nodes) delete node;
+    }
+
+    static NodeCache& local() {
+        thread_local NodeCache cache;
+        return cache;
+    }
+
+    static Depot& depot() {
+        static Depot d;
+        return d;
+    }
+
+    static void free_chain(sx::utils::MPSCNode* head) {
+        while (head != nullptr) {
+            sx::utils::MPSCNode* next = head->next.load(std::memory_order_relaxed);
+            delete static_cast<Node*>(head);
+            head = next;
+        }
+    }
+
+    // Moves the newest kBatch nodes of `nodes` to the depot.
+    static void spill(std::vector<Node*>& nodes) {
+        sx::utils::MPSCNode* head = nullptr;
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            Node* node = nodes.back();
+            nodes.pop_back();
+            node->next.store(head, std::memory_order_relaxed);
+            head = node;
+        }
+        {
+            Depot& d = depot();
+            std::lock_guard<std::mutex> lock(d.mutex);
+            if (d.batches.size() < kMaxBatches) {
+                d.batches.push_back(head);
+                return;
+            }
+        }
+        free_chain(head);
+    }
+
+    static void refill(std::vector<Node*>& nodes) {
+        sx::utils::MPSCNode* head = nullptr;
+        {
+            Depot& d = depot();
+            std::lock_guard<std::mutex> lock(d.mutex);
+            if (d.batches.empty()) return;
+            head = d.batches.back();
+            d.batches.pop_back();
+        }
+        while (head != nullptr) {
+            nodes.push_back(static_cast<Node*>(head));
+            head = head->next.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<Node*> nodes;
+};
+
+}  // namespace sx::infra
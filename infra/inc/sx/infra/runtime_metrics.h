@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sx::infra {
+
+// Snapshot of a log2 latency histogram. Bucket 0 counts zero-length samples; bucket b > 0
+// counts samples in [2^(b-1), 2^b) ns.
+struct LatencyHistogram {
+    static constexpr std::size_t kBuckets = 64U;
+
+    std::array<uint64_t, kBuckets> buckets{};
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+
+    [[nodiscard]] std::chrono::nanoseconds mean() const noexcept;
+    // Upper bound of the bucket holding quantile `q` (0..1), capped at max_ns; 0 when empty.
+    [[nodiscard]] std::chrono::nanoseconds percentile(double q) const noexcept;
+};
+
+// Counters of one pool or strand. Counters are read completed-first, so queued() and
+// in_flight() are never negative, but a snapshot taken under load is not atomic as a whole.
+struct TaskMetrics {
+    uint64_t posted = 0;
+    uint64_t started = 0;
+    uint64_t completed = 0;  // returned or threw
+    LatencyHistogram queue_delay;  // post -> start
+    LatencyHistogram run_time;     // start -> end
+
+    [[nodiscard]] uint64_t queued() const noexcept { return posted - started; }
+    [[nodiscard]] uint64_t in_flight() const noexcept { return started - completed; }
+};
+
+struct WorkerMetrics {
+    std::chrono::nanoseconds busy{0};  // time spent running instrumented tasks
+    double busy_ratio = 0.0;           // busy / pool uptime
+};
+
+struct PoolMetrics {
+    TaskMetrics tasks;
+    std::chrono::nanoseconds uptime{0};  // since init()
+    std::vector<WorkerMetrics> workers;
+};
+
+struct StrandMetrics {
+    std::string name;
+    TaskMetrics tasks;
+};
+
+// AsyncRuntime::metrics() result. Everything is zero unless RuntimeOptions::enable_metrics.
+struct RuntimeMetrics {
+    bool enabled = false;
+    PoolMetrics io;
+    PoolMetrics cpu;
+    std::vector<StrandMetrics> strands;  // named strands that are still alive
+};
+
+}  // namespace sx::infra
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "sx/infra/async_runtime.h"
+#include "sx/infra/executor.h"
+
+namespace sx::infra {
+
+namespace detail {
+
+// Shared by a TaskGroup, its queued tasks, its tokens and the runtime's group registry.
+struct TaskGroupState {
+    std::atomic<bool> cancelled{false};  // cancel(): for good
+    // stop(drain_timeout) gave up on the group. Only for that session: cleared when the group
+    // rejoins a restarted runtime (AsyncRuntime::register_task_group()).
+    std::atomic<bool> drain_expired{false};
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::uint64_t> skipped{0};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    // Not registered with a running runtime: not yet, or the runtime stopped and tasks still
+    // queued will not run in that session. Written under `mutex`; the next post registers it.
+    std::atomic<bool> abandoned{true};
+
+    [[nodiscard]] bool cancel_requested() const noexcept {
+        return cancelled.load(std::memory_order_acquire) || drain_expired.load(std::memory_order_acquire);
+    }
+
+    void finish() noexcept {
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) != 1U) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_all();
+    }
+
+    // True once nothing is pending (or the runtime gave up on it) before `deadline`.
+    template <typename Clock, typename Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_until(lock, deadline, [this]() { return idle_locked(); });
+    }
+
+    [[nodiscard]] bool idle_locked() const noexcept {
+        return abandoned.load(std::memory_order_relaxed) || pending.load(std::memory_order_acquire) == 0U;
+    }
+};
+
+}  // namespace detail
+
+// Read-only view of a TaskGroup's cancellation flag. Long tasks poll cancelled() at safe
+// points and return early; a default-constructed token is never cancelled.
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    [[nodiscard]] bool cancelled() const noexcept {
+        return state_ && state_->cancel_requested();
+    }
+
+private:
+    friend class TaskGroup;
+    explicit CancellationToken(std::shared_ptr<detail::TaskGroupState> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<detail::TaskGroupState> state_;
+};
+
+// A set of tasks that can be waited for and cancelled together, e.g. one pipeline generation.
+// Tasks are posted through the group onto the runtime's pools or any IExecutor and take either
+// no arguments or (const CancellationToken&). The token is checked right before each task
+// starts: after cancel(), tasks still queued are skipped (their captures are released, nothing
+// runs) and tasks already running see token.cancelled() and can bail out.
+//
+// Destroying the group cancels it but does not wait; call wait() first if the tasks reference
+// state that dies with the caller. AsyncRuntime::stop(drain_timeout) waits for live groups up
+// to the deadline and cancels the rest for that session only: unlike cancel(), this lifts
+// once the group posts to the restarted runtime.
+class TaskGroup {
+public:
+    explicit TaskGroup(AsyncRuntime& runtime);
+    ~TaskGroup();
+
+    template <typename Func>
+    void post_cpu(Func&& f) {
+        rejoin();
+        runtime_.post_cpu(wrap(std::forward<Func>(f)));
+    }
+
+    template <typename Func>
+    void post_io(Func&& f) {
+        rejoin();
+        runtime_.post_io(wrap(std::forward<Func>(f)));
+    }
+
+    // Onto a strand or any other executor.
+    template <typename Func>
+    void post(IExecutor& executor, Func&& f) {
+        rejoin();
+        executor.post(Task(wrap(std::forward<Func>(f))));
+    }
+
+    // Tasks not yet started are skipped; running ones observe the token. Thread-safe, idempotent.
+    void cancel() noexcept;
+    // After cancel(), or after stop(drain_timeout) gave up on the group until it rejoins.
+    [[nodiscard]] bool cancelled() const noexcept { return state_->cancel_requested(); }
+    [[nodiscard]] CancellationToken token() const { return CancellationToken(state_); }
+
+    // Blocks until every task posted so far has finished or been skipped, or the runtime has
+    // stopped. A group outlives a restart: its first post after init() makes wait() wait again.
+    // Must not be called from one of the group's own tasks.
+    void wait();
+    // Same with a timeout; true if the group went idle in time.
+    bool wait_for(std::chrono::nanoseconds timeout);
+
+    // Posted tasks that have neither finished nor been skipped yet.
+    [[nodiscard]] std::size_t pending() const noexcept { return state_->pending.load(std::memory_order_acquire); }
+    // Tasks dropped by cancellation before they started.
+    [[nodiscard]] std::uint64_t skipped() const noexcept { return state_->skipped.load(std::memory_order_relaxed); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    TaskGroup(TaskGroup&&) = delete;
+    TaskGroup& operator=(TaskGroup&&) = delete;
+
+private:
+    // A stop() dropped the group from the runtime's registry; back in once it runs again.
+    void rejoin() {
+        if (state_->abandoned.load(std::memory_order_acquire)) runtime_.register_task_group(state_);
+    }
+
+    // Owns one unit of `pending`: released when the task runs, is skipped, or is destroyed
+    // unrun (posted to a stopped runtime, discarded by stop()).
+    class Ticket {
+    public:
+        explicit Ticket(std::shared_ptr<detail::TaskGroupState> state) noexcept : state_(std::move(state)) {
+            state_->pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        Ticket(Ticket&& other) noexcept = default;
+        Ticket& operator=(Ticket&&) = delete;
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+        ~Ticket() {
+            if (state_) state_->finish();
+        }
+
+        // `fn` (and its captures) is destroyed before the task counts as finished, so wait()
+        // returning means the group holds nothing any more.
+        template <typename Fn>
+        void run(std::optional<Fn>& fn) {
+            const auto state = std::move(state_);
+            struct Finish {
+                detail::TaskGroupState& s;
+                std::optional<Fn>& f;
+                ~Finish() {
+                    f.reset();
+                    s.finish();
+                }
+            } finish{*state, fn};
+            if (state->cancel_requested()) {
+                state->skipped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if constexpr (std::is_invocable_v<Fn&, const CancellationToken&>) {
+                (*fn)(CancellationToken(state));
+            } else {
+                (*fn)();
+            }
+        }
+
+    private:
+        std::shared_ptr<detail::TaskGroupState> state_;
+    };
+
+    template <typename Func>
+    auto wrap(Func&& f) {
+        return [ticket = Ticket(state_), fn = std::optional<std::decay_t<Func>>(std::forward<Func>(f))]() mutable {
+            ticket.run(fn);
+        };
+    }
+
+    AsyncRuntime& runtime_;
+    std::shared_ptr<detail::TaskGroupState> state_;
+};
+
+}  // namespace sx::infra
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace sx::infra {
+
+struct TraceOptions {
+    // Ring size per thread (rounded up to a power of two); once full, the oldest events are
+    // overwritten, and export leaves out any slot rewritten while it was being copied.
+    // A thread's ring is sized by the options in force at its first event.
+    std::size_t events_per_thread = 16384U;
+
+    // Rings of exited threads stay exportable; beyond this many, the earliest started are
+    // dropped when another thread records its first event, so thread churn does not pile up
+    // a ring per thread.
+    std::size_t exited_threads_kept = 8U;
+};
+
+// Process-wide timeline for latency investigations: which task ran where, how long, and where
+// it was posted from. Every thread records fixed-size events into its own ring (one writer,
+// no locks, no allocation after the thread's first event); timestamps are CLOCK_MONOTONIC.
+// While disabled an instrumentation point costs one relaxed load.
+//
+// AsyncRuntime records a "task" span per pool task and per strand task, with an arrow from the
+// "post" site; UnifiedBus records publish, dispatch and stream pop spans. Export produces
+// Chrome trace event JSON, which chrome://tracing and ui.perfetto.dev both open.
+//
+// `name` and `category` are stored as pointers and must outlive the export (string literals);
+// `detail` is copied, truncated to kDetailSize - 1 bytes.
+class Tracer {
+public:
+    static constexpr std::size_t kDetailSize = 40U;
+
+    // Starts recording; events from earlier sessions are no longer exported.
+    static void enable(const TraceOptions& options = {});
+    // Stops recording. Recorded events stay available to export.
+    static void disable() noexcept;
+    [[nodiscard]] static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] static std::uint64_t now_ns() noexcept;
+
+    // A finished span on the calling thread; `flow_in` (from flow_begin()) draws an arrow into it.
+    static void complete(const char* name, const char* category, std::uint64_t start_ns, std::uint64_t end_ns,
+                         std::string_view detail = {}, std::uint64_t flow_in = 0U);
+    static void instant(const char* name, const char* category, std::string_view detail = {});
+    // Marks a handoff on the calling thread and returns its id for the span where the work
+    // continues (0 while disabled).
+    [[nodiscard]] static std::uint64_t flow_begin(const char* name, const char* category);
+
+    // Label for the calling thread's track. Cheap; does not start a ring.
+    static void set_thread_name(std::string_view name);
+
+    // Events of the current session, oldest first per thread. Safe while recording; events
+    // overwritten during the export are left out.
+    [[nodiscard]] static std::string export_chrome_json();
+    static std::error_code write_chrome_json(const std::string& path);
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+// Records [construction, destruction) as a span if tracing was enabled at construction.
+// `detail` must outlive the span.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const char* category = "user", std::string_view detail = {},
+                       std::uint64_t flow_in = 0U) noexcept
+        : name_(name), category_(category), detail_(detail), flow_in_(flow_in),
+          start_ns_(Tracer::enabled() ? Tracer::now_ns() : 0U) {}
+
+    ~TraceSpan() {
+        if (start_ns_ != 0U) Tracer::complete(name_, category_, start_ns_, Tracer::now_ns(), detail_, flow_in_);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    TraceSpan(TraceSpan&&) = delete;
+    TraceSpan& operator=(TraceSpan&&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    std::string_view detail_;
+    std::uint64_t flow_in_;
+    std::uint64_t start_ns_;
+};
+
+}  // namespace sx::infra
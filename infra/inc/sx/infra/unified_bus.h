@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <system_error>
@@ -12,6 +14,21 @@
 namespace sx::infra
 {
 
+class IExecutor;
+class ConfigManager;
+
+// 请求/应答结果：ec 为空表示成功；超时为 std::errc::timed_out，总线关闭为 operation_canceled。
+struct ControlReply {
+    std::error_code ec;
+    std::string payload;
+};
+
+using ReplyCallback = std::function<void(ControlReply)>;
+
+// 服务端应答句柄：可在任意线程、任意时刻调用一次。
+using ControlResponder = std::function<void(const std::string& reply)>;
+using RequestHandler = std::function<void(const std::string& request, ControlResponder respond)>;
+
 // 队列句柄
 template <typename U>
 using StreamQueuePtr = std::shared_ptr<sx::utils::IQueue<std::shared_ptr<U>>>;
@@ -79,9 +96,15 @@ public:
     /**
      * @brief 发布控制消息，路由至 ZeroMQ
      * 适用于：状态、指令、小数据
+     * 线程安全：多线程并发发布不会互相串行化，消息投递到无锁发送队列后由后台发送线程写入 socket；
+     * 返回值只反映同步错误（如首次 bind 失败），同一线程的发布顺序保持不变。
      */
     [[nodiscard]] std::error_code publish(const std::string& topic, const std::string& message);
 
+    // 同上，首次发布（创建 socket）时使用 options；之后的调用忽略 options。
+    [[nodiscard]] std::error_code publish(const std::string& topic, const std::string& message,
+                                          const sx::types::ControlChannelOptions& options);
+
     /**
      * @brief 发布二进制数据，路由至内存队列 (Zero-Copy)
      * 适用于：大文件、图像、视频等
@@ -97,10 +120,69 @@ public:
 
     /**
      * @brief 订阅控制消息，回调模式
+     * - tcp:// / ipc:// 等跨进程 endpoint：回调在该 endpoint 的接收线程上执行。
+     * - inproc:// endpoint：不经过 ZeroMQ，由发布线程直接同步分发（零拷贝）；
+     *   同一 endpoint 的回调串行执行且保持发布顺序，回调内再次 publish 会排队而非重入。
+     *   积压较多时，正在分发的线程会把剩余消息交给下一个发布线程，因此回调也可能在其他
+     *   发布线程上执行。回调不得抛出异常（否则 std::terminate，与接收线程一致）。
+     *   带 last_value_cache 时，回调内（或其他线程正在分发时）的 subscribe 同样排队，
+     *   由当前分发者按顺序完成重放与登记。
      */
     [[nodiscard]] std::error_code subscribe(const std::string& topic,
                                             std::function<void(const std::string&)> callback);
 
+    // 同上，首次订阅（创建 socket）时使用 options。
+    [[nodiscard]] std::error_code subscribe(const std::string& topic,
+                                            std::function<void(const std::string&)> callback,
+                                            const sx::types::ControlChannelOptions& options);
+
+    // ================================ Channel tuning ================================
+
+    /**
+     * @brief 预先登记 endpoint 的调优参数，之后创建的 PUB/SUB socket 使用它
+     * 显式传给 publish/subscribe 的 options 优先。
+     */
+    void set_channel_options(const std::string& endpoint, const sx::types::ControlChannelOptions& options);
+
+    /**
+     * @brief 从配置加载调优参数，key_path 指向一个数组，例如:
+     * "bus": { "control_channels": [
+     *     { "endpoint": "tcp://127.0.0.1:5556", "conflate": true, "send_hwm": 10, "recv_hwm": 10,
+     *       "batch_max_messages": 32, "batch_flush_interval_us": 2000,
+     *       "sequenced": true, "last_value_cache": true } ] }
+     * @return 加载的 endpoint 数量
+     */
+    std::size_t load_channel_options(const ConfigManager& config,
+                                     const std::string& key_path = "bus.control_channels");
+
+    /**
+     * @brief 本总线在 endpoint 上的订阅统计（接收数、序号缺口、重复）
+     * 未订阅的 endpoint 返回全零。
+     */
+    [[nodiscard]] sx::types::ControlChannelStats channel_stats(const std::string& endpoint) const;
+
+    // ================================ Request / Reply ================================
+
+    /**
+     * @brief 在 endpoint 上提供请求/应答服务 (ZMQ ROUTER, bind)
+     * @param executor 非空时 handler 投递到该执行器运行，否则在总线 IO 线程上直接调用（须很快返回）
+     */
+    [[nodiscard]] std::error_code serve(const std::string& endpoint, RequestHandler handler,
+                                        std::shared_ptr<IExecutor> executor = nullptr);
+
+    /**
+     * @brief 异步请求 (ZMQ DEALER, connect)
+     * 同一 endpoint 的所有请求复用一个 socket，按关联 ID 匹配应答，超时由总线 IO 线程的定时器处理，
+     * 不为每个请求占用线程。
+     * @param executor 非空时 on_reply 投递到该执行器（如 AsyncRuntime 的 strand），否则在总线 IO 线程上调用
+     */
+    void request(const std::string& endpoint, const std::string& payload, std::chrono::milliseconds timeout,
+                 ReplyCallback on_reply, std::shared_ptr<IExecutor> executor = nullptr);
+
+    // Future 形式的便捷接口。
+    [[nodiscard]] std::future<ControlReply> request(const std::string& endpoint, const std::string& payload,
+                                                    std::chrono::milliseconds timeout);
+
     // Explicit shutdown for deterministic teardown (threads, zmq context).
     void shutdown();
 
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "sx/hal/i_thread_scheduler.h"
+
+namespace sx::infra {
+
+// AsyncRuntime stall detection (RuntimeOptions::watchdog). A monitor thread wakes every
+// `check_period` and
+// - flags IO/CPU tasks that have been running longer than `task_budget`;
+// - posts a heartbeat to each pool (to each IO context with IoPoolKind::kPerThread) and
+//   flags it when the heartbeat waits longer than `lag_budget` (e.g. every IO worker of the
+//   context blocked, so none of its timers can fire);
+// - flags critical loops that called AsyncRuntime::watchdog_kick() before but have not
+//   done so within `critical_budget`.
+// Each stall is reported once, when it crosses the budget.
+struct WatchdogOptions {
+    bool enabled = false;
+    std::chrono::milliseconds check_period{20};
+    std::chrono::milliseconds task_budget{100};
+    std::chrono::milliseconds lag_budget{100};
+    std::chrono::milliseconds critical_budget{100};
+};
+
+enum class StallKind {
+    kTaskOverrun,     // one task has run longer than task_budget
+    kLoopLag,         // a pool heartbeat has waited longer than lag_budget
+    kCriticalSilent,  // a critical loop stopped kicking the watchdog
+};
+
+struct StallReport {
+    StallKind kind = StallKind::kTaskOverrun;
+    sx::hal::IThreadScheduler::ThreadClass thread_class = sx::hal::IThreadScheduler::ThreadClass::kCpu;
+    // Worker / loop index within the class; for kLoopLag the IO context (see
+    // AsyncRuntime::io_shards()), or 0 for the CPU pool.
+    std::size_t index = 0;
+    // Kernel thread id (gettid) of the stalled thread; 0 for kLoopLag.
+    int64_t thread_id = 0;
+    // How long the task has run, the heartbeat has waited or the loop has been silent.
+    std::chrono::nanoseconds stalled_for{0};
+};
+
+// One-line description, e.g. "task overrun on cpu worker 1 (tid 4242): 153 ms".
+std::string to_string(const StallReport& report);
+
+}  // namespace sx::infra
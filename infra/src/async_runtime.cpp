@@ -6,8 +6,12 @@
 #include "sx/infra/async_runtime.h"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <mutex>
 #include <optional>
 #include <thread>
@@ -15,6 +19,16 @@
 
 #include <asio.hpp>
 
+#include "file_io_service.h"
+#include "sx/infra/node_cache.h"
+#include "sx/infra/task_group.h"
+#include "sx/infra/trace.h"
+#include "sx/utils/mpsc_queue.h"
+#include "task_stats.h"
+#include "timing_wheel.h"
+#include "watchdog.h"
+#include "work_stealing_pool.h"
+
 namespace sx::infra {
 
 class AsioTimer final : public ITimer {
@@ -37,158 +51,1325 @@ private:
     asio::steady_timer timer_;
 };
 
-class AsioExecutor final : public IExecutor {
+class AsioPeriodicTimer final : public IPeriodicTimer {
+public:
+    explicit AsioPeriodicTimer(asio::io_context& ctx) : core_(std::make_shared<Core>(ctx)) {}
+    ~AsioPeriodicTimer() override { stop(); }
+
+    AsioPeriodicTimer(const AsioPeriodicTimer&) = delete;
+    AsioPeriodicTimer& operator=(const AsioPeriodicTimer&) = delete;
+    AsioPeriodicTimer(AsioPeriodicTimer&&) = delete;
+    AsioPeriodicTimer& operator=(AsioPeriodicTimer&&) = delete;
+
+    void start(std::chrono::nanoseconds period, std::function<void(const PeriodicTick&)> callback) override {
+        asio::post(core_->strand, [core = core_, period, cb = std::move(callback)]() mutable {
+            core->restart(std::max(period, std::chrono::nanoseconds{1}), std::move(cb));
+        });
+    }
+
+    void stop() override {
+        asio::post(core_->strand, [core = core_]() { core->halt(); });
+    }
+
+    [[nodiscard]] uint64_t overruns() const override { return core_->overruns.load(std::memory_order_relaxed); }
+
+private:
+    // Lives as long as a wait is pending; every member except `overruns` is strand-only.
+    struct Core : std::enable_shared_from_this<Core> {
+        using Clock = std::chrono::steady_clock;
+
+        explicit Core(asio::io_context& ctx) : strand(asio::make_strand(ctx)), timer(strand) {}
+
+        void restart(std::chrono::nanoseconds p, std::function<void(const PeriodicTick&)> cb) {
+            halt();
+            period = p;
+            callback = std::move(cb);
+            origin = Clock::now();
+            index = 0;
+            arm();
+        }
+
+        void halt() {
+            ++generation;
+            (void)timer.cancel();
+            callback = nullptr;
+        }
+
+        [[nodiscard]] Clock::time_point due(uint64_t k) const {
+            return origin + std::chrono::duration_cast<Clock::duration>(period * static_cast<int64_t>(k));
+        }
+
+        void arm() {
+            timer.expires_at(due(index + 1U));
+            timer.async_wait([self = shared_from_this(), gen = generation](const std::error_code& ec) {
+                if (!ec && gen == self->generation) self->fire();
+            });
+        }
+
+        void fire() {
+            // The tick to run is the latest one already due; anything in between was missed.
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin);
+            const auto current = static_cast<uint64_t>(elapsed.count() / period.count());
+            PeriodicTick tick;
+            tick.index = std::max(current, index + 1U);
+            tick.missed = tick.index - index - 1U;
+            tick.deadline = due(tick.index);
+            index = tick.index;
+            if (tick.missed > 0U) overruns.fetch_add(tick.missed, std::memory_order_relaxed);
+
+            const uint64_t gen = generation;
+            if (callback) callback(tick);
+            if (gen == generation) arm();  // the callback may have stopped or restarted us
+        }
+
+        asio::strand<asio::io_context::executor_type> strand;
+        asio::steady_timer timer;
+        std::function<void(const PeriodicTick&)> callback;
+        std::chrono::nanoseconds period{1};
+        Clock::time_point origin;
+        uint64_t index = 0;
+        uint64_t generation = 0;
+        std::atomic<uint64_t> overruns{0};
+    };
+
+    std::shared_ptr<Core> core_;
+};
+
+// Runs a queued task. With tracing on, Tracer::flow_begin() left a "post" mark where it was
+// queued; `flow` is that mark's id (0 otherwise) and the "task" span is joined to it by an
+// arrow. The id travels next to the task (queue node or asio handler), never in a wrapper.
+void run_task(Task& f, bool watched, std::uint64_t flow, const char* category) {
+    if (flow != 0U) {
+        TraceSpan span("task", category, {}, flow);
+        run_task(f, watched, 0U, category);
+    } else if (watched) {
+        Watchdog::run(f);
+    } else {
+        f();
+    }
+}
+
+// Work-stealing pool run hooks.
+void run_cpu_task(Task& f, std::uint64_t flow) { run_task(f, false, flow, "cpu"); }
+void run_watched_cpu_task(Task& f, std::uint64_t flow) { run_task(f, true, flow, "cpu"); }
+
+// Optional per-task instrumentation of an executor: metrics wrap the task when it is posted,
+// the watchdog stamps it where it runs.
+struct TaskHooks {
+    StatsHook stats;
+    bool watchdog = false;
+
+    void run(Task& f, std::uint64_t flow, const char* category) const { run_task(f, watchdog, flow, category); }
+};
+
+// Strand for both pools and both pool kinds. post() links an intrusive node into a Vyukov
+// MPSC queue and bumps a pending count; whoever moves the count off zero schedules one batch
+// on the pool. Posting takes no lock of its own and, once the node caches are warm, allocates
+// no node: the workers' surplus flows back to posting threads through NodeCache's depot.
+// The count doubles as the "scheduled" flag: it only drops back to zero inside a batch,
+// after that batch ran the last queued task. Every strand owns its queue, unlike
+// asio::strand's fixed pool of hashed implementations, so unrelated strands never wait on
+// each other. A batch re-submits itself after kBatch tasks so a busy strand cannot
+// monopolize a worker.
+class SerialExecutor final : public IExecutor, public std::enable_shared_from_this<SerialExecutor> {
+public:
+    using Submit = std::function<void(Task)>;
+
+    // `submit` must not meter: each task goes through `hooks` here, the batches do not.
+    SerialExecutor(Submit submit, TaskHooks hooks) : submit_(std::move(submit)), hooks_(std::move(hooks)) {}
+
+    SerialExecutor(const SerialExecutor&) = delete;
+    SerialExecutor& operator=(const SerialExecutor&) = delete;
+    SerialExecutor(SerialExecutor&&) = delete;
+    SerialExecutor& operator=(SerialExecutor&&) = delete;
+
+    ~SerialExecutor() override {
+        // Batches hold a reference, so whatever is left here had its batch discarded by stop().
+        while (Node* node = queue_.pop()) delete node;
+    }
+
+    void post(Task f) override {
+        const std::uint64_t flow = Tracer::flow_begin("post", "strand");
+        Node* node = NodeCache<Node>::acquire();
+        node->fn = hooks_.stats.wrap(std::move(f));
+        node->flow = flow;
+        queue_.push(node);
+        if (pending_.fetch_add(1, std::memory_order_acq_rel) == 0U) schedule();
+    }
+
+private:
+    struct Node : sx::utils::MPSCNode {
+        Task fn;
+        std::uint64_t flow = 0U;  // tracing "post" mark, see run_task()
+    };
+
+    static constexpr int kBatch = 64;
+
+    void schedule() {
+        submit_([self = shared_from_this()]() { self->run_batch(); });
+    }
+
+    void run_batch() {
+        TraceSpan span("strand.batch", "strand");
+        ExecutorScope scope(this);
+        for (int i = 0; i < kBatch; ++i) {
+            Node* node = queue_.pop();
+            while (node == nullptr) {
+                // Counted but not reachable yet: a producer is between its exchange and link.
+                std::this_thread::yield();
+                node = queue_.pop();
+            }
+            if (node->fn) hooks_.run(node->fn, node->flow, "strand");
+            node->fn.reset();
+            NodeCache<Node>::release(node);
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1U) return;
+        }
+        schedule();
+    }
+
+    Submit submit_;
+    TaskHooks hooks_;
+    sx::utils::MPSCQueue<Node> queue_;
+    alignas(64) std::atomic<std::size_t> pending_{0};
+};
+
+// IO executor bound to one context of a per-thread IO pool; `post` is the runtime's admitted,
+// unmetered post to that context. Its work runs on that context's worker and nowhere else,
+// inside an ExecutorScope of the strand so current() names it like on any other strand.
+class ShardExecutor final : public IExecutor, public std::enable_shared_from_this<ShardExecutor> {
 public:
-    explicit AsioExecutor(asio::io_context& ctx) : strand_(asio::make_strand(ctx)) {}
+    // Takes the task, its tracing flow id (see run_task()) and the executor to run it under.
+    using Submit = std::function<void(Task, std::uint64_t, std::shared_ptr<IExecutor>)>;
+
+    ShardExecutor(Submit submit, TaskHooks hooks, const void* runtime, std::size_t shard)
+        : submit_(std::move(submit)), hooks_(std::move(hooks)), runtime_(runtime), shard_(shard) {}
 
-    void post(std::function<void()> f) override { asio::post(strand_, std::move(f)); }
+    void post(Task f) override {
+        const std::uint64_t flow = Tracer::flow_begin("post", "strand");
+        submit_(hooks_.stats.wrap(std::move(f)), flow, shared_from_this());
+    }
+
+    [[nodiscard]] bool running_in_this_thread() const noexcept override;
 
 private:
-    asio::strand<asio::io_context::executor_type> strand_;
+    Submit submit_;
+    TaskHooks hooks_;
+    const void* runtime_;
+    std::size_t shard_;
 };
 
+// A whole pool as an executor (AsyncRuntime::io_executor() / cpu_executor()). Workers bind it
+// with ExecutorScope::bind_thread(), which is what dispatch() checks.
+class PoolExecutor final : public IExecutor {
+public:
+    using Submit = std::function<void(Task)>;
+
+    explicit PoolExecutor(Submit submit) : submit_(std::move(submit)) {}
+
+    void post(Task f) override { submit_(std::move(f)); }
+
+private:
+    Submit submit_;
+};
+
+namespace {
+
+enum class RuntimeState : uint8_t { kStopped, kRunning, kStopping };
+
+// Posters announce themselves on a per-thread stripe so concurrent producers never share a
+// cache line; stop() only needs the sum.
+constexpr std::size_t kPosterStripes = 16U;
+
+struct alignas(64) PosterStripe {
+    std::atomic<int64_t> count{0};
+};
+
+std::size_t this_thread_stripe() noexcept {
+    static std::atomic<std::size_t> next_stripe{0};
+    thread_local const std::size_t stripe =
+        next_stripe.fetch_add(1, std::memory_order_relaxed) % kPosterStripes;
+    return stripe;
+}
+
+// One parallel_for call, shared by the caller and its helper tasks. Helpers can start after
+// the caller has returned (it may have run every chunk itself), so the state is reference
+// counted; a late helper finds nothing to claim and never touches the caller's body.
+struct ParallelState {
+    using Body = void (*)(void* ctx, std::size_t slot, std::size_t begin, std::size_t end);
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> remaining{0};  // indices not yet completed
+    std::size_t last = 0;
+    std::size_t grain = 1;
+    std::size_t participants = 1;
+    Body body = nullptr;
+    void* ctx = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    std::exception_ptr error;
+
+    // Guided self-scheduling: chunks start at remaining / (2 * participants) and shrink to
+    // `grain`, which balances uneven work without a claim per index.
+    bool claim(std::size_t& begin, std::size_t& end) noexcept {
+        std::size_t cur = next.load(std::memory_order_relaxed);
+        while (cur < last) {
+            const std::size_t left = last - cur;
+            const std::size_t chunk = std::min(left, std::max(grain, left / (2U * participants)));
+            if (next.compare_exchange_weak(cur, cur + chunk, std::memory_order_relaxed)) {
+                begin = cur;
+                end = cur + chunk;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void complete(std::size_t n) {
+        if (remaining.fetch_sub(n, std::memory_order_acq_rel) != n) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        cv.notify_all();
+    }
+
+    void run_chunk(std::size_t slot, std::size_t begin, std::size_t end) {
+        try {
+            body(ctx, slot, begin, end);
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+            // Cancel what nobody has claimed yet; it counts as completed.
+            const std::size_t unclaimed = next.exchange(last, std::memory_order_relaxed);
+            if (unclaimed < last) complete(last - unclaimed);
+        }
+        complete(end - begin);
+    }
+
+    void run(std::size_t slot) {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        while (claim(begin, end)) run_chunk(slot, begin, end);
+    }
+
+    void wait() {
+        for (int i = 0; i < 64; ++i) {
+            if (remaining.load(std::memory_order_acquire) == 0U) return;
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this]() { return done; });
+    }
+};
+
+// Prioritized CPU tasks. Each queued task is paired with a token posted to the pool; a
+// token runs whichever task is best at that moment, not the one that posted it, so
+// priority is decided at dequeue time on either pool implementation. Tokens wait behind
+// plain tasks already queued, so CPU workers also call run_urgent() between tasks: kHigh
+// work runs ahead of the pool's own queue, the rest only reorders among prioritized tasks.
+class PriorityLanes {
+public:
+    void push(const TaskOptions& options, Task task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        heap_.push_back(Entry{options.priority, options.deadline, next_seq_++, options.drop_if_expired,
+                              std::move(task)});
+        std::push_heap(heap_.begin(), heap_.end(), Later{});
+        if (options.priority == TaskPriority::kHigh) urgent_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Runs the best queued task, skipping (and counting) those past a drop-if-expired deadline.
+    void run_one() {
+        while (auto entry = pop(false)) {
+            if (run(*entry)) return;
+        }
+    }
+
+    // Runs every queued kHigh task. One relaxed load while there is none.
+    void run_urgent() {
+        while (urgent_.load(std::memory_order_relaxed) != 0U) {
+            auto entry = pop(true);
+            if (!entry) return;
+            (void)run(*entry);
+        }
+    }
+
+    void clear() {
+        std::vector<Entry> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dropped.swap(heap_);
+            urgent_.store(0U, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] std::uint64_t expired_drops() const noexcept {
+        return expired_drops_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry {
+        TaskPriority priority;
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t seq;
+        bool drop_if_expired;
+        Task task;
+    };
+
+    // Heap comparator: true when `a` should run after `b`.
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const noexcept {
+            if (a.priority != b.priority) return a.priority > b.priority;
+            if (a.deadline != b.deadline) return a.deadline > b.deadline;
+            return a.seq > b.seq;
+        }
+    };
+
+    // kHigh sorts first, so the top is urgent whenever any queued task is.
+    std::optional<Entry> pop(bool urgent_only) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (heap_.empty() || (urgent_only && heap_.front().priority != TaskPriority::kHigh)) return std::nullopt;
+        std::pop_heap(heap_.begin(), heap_.end(), Later{});
+        std::optional<Entry> entry(std::move(heap_.back()));
+        heap_.pop_back();
+        if (entry->priority == TaskPriority::kHigh) urgent_.fetch_sub(1, std::memory_order_relaxed);
+        return entry;
+    }
+
+    // False if the task was dropped for its deadline.
+    bool run(Entry& entry) {
+        if (entry.drop_if_expired && std::chrono::steady_clock::now() > entry.deadline) {
+            expired_drops_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (entry.task) entry.task();
+        return true;
+    }
+
+    std::mutex mutex_;
+    std::vector<Entry> heap_;
+    uint64_t next_seq_ = 0;
+    alignas(64) std::atomic<std::size_t> urgent_{0};  // queued kHigh tasks, read by every worker
+    std::atomic<std::uint64_t> expired_drops_{0};
+};
+
+// Set by elastic probes on asio CPU workers; see WorkStealingPool::mark_housekeeping().
+thread_local bool t_housekeeping = false;
+
+// An elastic asio CPU worker waiting in run_one_for() counts itself in this counter; the
+// first handler it runs takes it out again (leave_cpu_idle()).
+thread_local std::atomic<std::size_t>* t_cpu_idle = nullptr;
+
+void leave_cpu_idle() noexcept {
+    if (auto* idle = std::exchange(t_cpu_idle, nullptr)) idle->fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Per-thread IO pool: the runtime and shard the calling IO worker belongs to.
+struct CurrentIoShard {
+    const void* runtime = nullptr;
+    std::size_t shard = 0;
+};
+thread_local CurrentIoShard t_io_shard;
+
+}  // namespace
+
+bool ShardExecutor::running_in_this_thread() const noexcept {
+    return t_io_shard.runtime == runtime_ && t_io_shard.shard == shard_;
+}
+
 struct AsyncRuntime::Impl {
+    // Serializes init/stop/resource creation. Never taken on the post path.
     std::mutex mutex_;
-    bool started_ = false;
+    std::atomic<RuntimeState> state_{RuntimeState::kStopped};
+    std::atomic<std::size_t> cpu_threads_n_{0};
+    std::array<PosterStripe, kPosterStripes> posters_{};
+    CpuPoolKind cpu_pool_kind_ = CpuPoolKind::kAsio;
+    WorkStealingPool ws_pool_;
+    PriorityLanes lanes_;
+    std::chrono::nanoseconds wheel_tick_{std::chrono::milliseconds(1)};
+    // One wheel per IO context, each ticking on its own; created on first use.
+    std::vector<std::shared_ptr<TimingWheel>> wheels_;
 
     asio::io_context io_ctx_;
     asio::io_context cpu_ctx_;
 
-    std::optional<asio::executor_work_guard<asio::io_context::executor_type>> io_work_;
+    // IO contexts in use: just io_ctx_ for IoPoolKind::kShared, one per worker (io_ctx_ first)
+    // for kPerThread. Extra contexts outlive stop() since timers may still refer to them.
+    IoPoolKind io_pool_kind_ = IoPoolKind::kShared;
+    std::vector<asio::io_context*> io_shards_;
+    std::vector<std::unique_ptr<asio::io_context>> io_extra_ctxs_;
+
+    std::vector<asio::executor_work_guard<asio::io_context::executor_type>> io_work_;
     std::optional<asio::executor_work_guard<asio::io_context::executor_type>> cpu_work_;
 
     std::vector<std::thread> io_threads_;
-    std::vector<std::thread> cpu_threads_;
     std::vector<std::thread> critical_threads_;
 
+    // Asio CPU workers. Slots are sized to cpu_threads and restarted in place by the elastic
+    // supervisor, so worker indices (metrics, watchdog, scheduler) never exceed it.
+    struct CpuSlot {
+        std::thread thread;
+        bool running = false;  // guarded by cpu_grow_mutex_
+    };
+    std::vector<CpuSlot> cpu_slots_;
+    std::mutex cpu_grow_mutex_;
+    std::atomic<std::size_t> cpu_live_{0};
+    std::atomic<std::size_t> cpu_idle_{0};  // elastic only, see t_cpu_idle
+
+    // Elastic sizing (both pool kinds). Bounds are read lock-free by retiring workers.
+    ElasticPoolOptions elastic_;
+    std::atomic<std::size_t> cpu_min_{0};
+    std::atomic<std::size_t> cpu_max_{0};
+    std::atomic<int64_t> probe_since_ns_{0};  // 0 when no probe is queued
+    std::mutex elastic_mutex_;
+    std::condition_variable elastic_cv_;
+    bool elastic_stopping_ = false;
+    std::thread elastic_thread_;
+
     std::atomic<bool> stop_{false};
     std::shared_ptr<sx::hal::IThreadScheduler> scheduler_;
+    // Set by the AsyncRuntime constructor; bound by every worker of the pool.
+    std::shared_ptr<PoolExecutor> io_executor_;
+    std::shared_ptr<PoolExecutor> cpu_executor_;
+    // Set by init() when metrics / the watchdog are enabled; read lock-free by admitted posters.
+    std::shared_ptr<RuntimeStats> stats_;
+    // Metered tasks point at their session's counters without owning them, and handlers left in
+    // a stopped context survive restart(), so earlier sessions' counters are kept until the end.
+    std::vector<std::shared_ptr<RuntimeStats>> retired_stats_;
+    std::shared_ptr<Watchdog> watchdog_;
+
+    // Live TaskGroups, for stop(drain_timeout) and for releasing their waiters on stop().
+    // Groups only join while groups_open_, i.e. from init() until stop() abandons them.
+    std::mutex groups_mutex_;
+    std::vector<std::weak_ptr<detail::TaskGroupState>> groups_;
+    bool groups_open_ = false;
+
+    // File I/O engine, started by the first file operation of a session (inside post admission,
+    // so stop() finds it after wait_for_posters()) and shut down by stop().
+    FileIoOptions file_io_options_;
+    std::mutex file_io_mutex_;
+    std::unique_ptr<FileIoService> file_io_;
+    std::atomic<FileIoService*> file_io_ptr_{nullptr};
+
+    std::mutex stall_mutex_;
+    std::function<void(const StallReport&)> stall_handler_;
+    std::atomic<std::uint64_t> stalls_{0};
 
     void start_threads_locked(std::size_t io_n, std::size_t cpu_n) {
         io_threads_.reserve(io_n);
-        cpu_threads_.reserve(cpu_n);
 
         for (std::size_t i = 0; i < io_n; ++i) {
-            io_threads_.emplace_back([this, i]() {
+            const std::size_t shard = io_shards_.size() > 1U ? i : 0U;
+            io_threads_.emplace_back([this, i, shard]() {
+                Tracer::set_thread_name("sx-io-" + std::to_string(i));
+                ExecutorScope::bind_thread(io_executor_.get());
+                if (stats_) stats_->io.bind_current_thread(i);
+                if (watchdog_) watchdog_->bind_worker(sx::hal::IThreadScheduler::ThreadClass::kIo, i);
                 if (scheduler_) scheduler_->on_thread_start(sx::hal::IThreadScheduler::ThreadClass::kIo, i);
-                io_ctx_.run();
+                if (io_shards_.size() > 1U) t_io_shard = CurrentIoShard{this, shard};
+                io_shards_[shard]->run();
+                t_io_shard = CurrentIoShard{};
             });
         }
 
-        for (std::size_t i = 0; i < cpu_n; ++i) {
-            cpu_threads_.emplace_back([this, i]() {
-                if (scheduler_) scheduler_->on_thread_start(sx::hal::IThreadScheduler::ThreadClass::kCpu, i);
-                cpu_ctx_.run();
-            });
+        const std::size_t initial = cpu_min_.load(std::memory_order_relaxed);
+        if (cpu_pool_kind_ == CpuPoolKind::kWorkStealing) {
+            WorkStealingPool::Elastic elastic;
+            if (elastic_.enabled) {
+                elastic.initial = initial;
+                elastic.min = initial;
+                elastic.retire_after = elastic_.retire_after;
+            }
+            ws_pool_.start(cpu_n, [this](std::size_t i) { bind_cpu_worker(i); },
+                           watchdog_ ? &run_watched_cpu_task : &run_cpu_task, elastic,
+                           [this]() { lanes_.run_urgent(); });
+            return;
+        }
+
+        cpu_slots_ = std::vector<CpuSlot>(cpu_n);
+        std::lock_guard<std::mutex> lock(cpu_grow_mutex_);
+        for (std::size_t i = 0; i < initial; ++i) launch_cpu_slot_locked(i);
+    }
+
+    void bind_cpu_worker(std::size_t i) {
+        Tracer::set_thread_name("sx-cpu-" + std::to_string(i));
+        ExecutorScope::bind_thread(cpu_executor_.get());
+        if (stats_) stats_->cpu.bind_current_thread(i);
+        if (watchdog_) watchdog_->bind_worker(sx::hal::IThreadScheduler::ThreadClass::kCpu, i);
+        if (scheduler_) scheduler_->on_thread_start(sx::hal::IThreadScheduler::ThreadClass::kCpu, i);
+    }
+
+    void launch_cpu_slot_locked(std::size_t i) {
+        CpuSlot& slot = cpu_slots_[i];
+        if (slot.thread.joinable()) slot.thread.join();  // retired, already on its way out
+        slot.running = true;
+        cpu_live_.fetch_add(1, std::memory_order_relaxed);
+        slot.thread = std::thread([this, i]() { asio_cpu_worker(i); });
+    }
+
+    void asio_cpu_worker(std::size_t i) {
+        bind_cpu_worker(i);
+        if (!elastic_.enabled) {
+            // One handler at a time, so urgent prioritized work can cut in between.
+            while (cpu_ctx_.run_one() != 0U) lanes_.run_urgent();
+            return;
+        }
+        auto last_work = std::chrono::steady_clock::now();
+        for (;;) {
+            t_housekeeping = false;
+            cpu_idle_.fetch_add(1, std::memory_order_relaxed);
+            t_cpu_idle = &cpu_idle_;
+            const bool ran = cpu_ctx_.run_one_for(elastic_.retire_after) != 0U;
+            leave_cpu_idle();
+            if (ran) lanes_.run_urgent();
+            if (cpu_ctx_.stopped()) return;  // stop_and_join_locked() resets the slots
+            if (try_retire(cpu_live_, cpu_max_.load(std::memory_order_relaxed))) break;
+            const auto now = std::chrono::steady_clock::now();
+            if (ran && !t_housekeeping) {
+                last_work = now;
+            } else if (now - last_work >= elastic_.retire_after &&
+                       try_retire(cpu_live_, cpu_min_.load(std::memory_order_relaxed))) {
+                break;
+            }
+        }
+        std::lock_guard<std::mutex> lock(cpu_grow_mutex_);
+        cpu_slots_[i].running = false;
+    }
+
+    static bool try_retire(std::atomic<std::size_t>& live, std::size_t floor) noexcept {
+        std::size_t n = live.load(std::memory_order_relaxed);
+        while (n > floor) {
+            if (live.compare_exchange_weak(n, n - 1U, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] std::size_t cpu_live() const noexcept {
+        return cpu_pool_kind_ == CpuPoolKind::kWorkStealing ? ws_pool_.live()
+                                                            : cpu_live_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::size_t cpu_idle() const noexcept {
+        return cpu_pool_kind_ == CpuPoolKind::kWorkStealing ? ws_pool_.idle()
+                                                            : cpu_idle_.load(std::memory_order_relaxed);
+    }
+
+    // Starts one more CPU worker unless the ceiling is reached. Elastic supervisor only.
+    bool grow_cpu() {
+        const std::size_t max = cpu_max_.load(std::memory_order_relaxed);
+        if (cpu_pool_kind_ == CpuPoolKind::kWorkStealing) return ws_pool_.grow(max);
+        std::lock_guard<std::mutex> lock(cpu_grow_mutex_);
+        if (cpu_live_.load(std::memory_order_relaxed) >= max) return false;
+        for (std::size_t i = 0; i < cpu_slots_.size(); ++i) {
+            if (!cpu_slots_[i].running) {
+                launch_cpu_slot_locked(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void elastic_loop() {
+        const auto period = std::max<std::chrono::nanoseconds>(elastic_.spawn_after / 2, std::chrono::milliseconds(1));
+        std::unique_lock<std::mutex> lock(elastic_mutex_);
+        while (!elastic_cv_.wait_for(lock, period, [this]() { return elastic_stopping_; })) {
+            lock.unlock();
+            elastic_check();
+            lock.lock();
+        }
+    }
+
+    // One supervisor step: top up to the floor, otherwise keep a probe queued and add a worker
+    // per step while it is overdue and no worker is idle. An overdue probe next to an idle
+    // worker only means the OS has not scheduled it yet (a busy shared box), not a backlog.
+    void elastic_check() {
+        if (cpu_live() < cpu_min_.load(std::memory_order_relaxed)) {
+            (void)grow_cpu();
+            return;
+        }
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count();
+        const int64_t since = probe_since_ns_.load(std::memory_order_acquire);
+        if (since == 0) {
+            probe_since_ns_.store(now, std::memory_order_relaxed);
+            auto probe = [this]() {
+                // A probe keeps parked workers from timing out; it must not keep them alive.
+                t_housekeeping = true;
+                WorkStealingPool::mark_housekeeping();
+                probe_since_ns_.store(0, std::memory_order_release);
+            };
+            if (!post_unmetered(sx::hal::IThreadScheduler::ThreadClass::kCpu, std::move(probe))) {
+                probe_since_ns_.store(0, std::memory_order_relaxed);
+            }
+            return;
+        }
+        if (now - since >= std::chrono::duration_cast<std::chrono::nanoseconds>(elastic_.spawn_after).count() &&
+            cpu_idle() == 0U) {
+            (void)grow_cpu();
+        }
+    }
+
+    void start_elastic_locked() {
+        if (!elastic_.enabled) return;
+        probe_since_ns_.store(0, std::memory_order_relaxed);
+        elastic_stopping_ = false;
+        elastic_thread_ = std::thread([this]() { elastic_loop(); });
+    }
+
+    void stop_elastic_locked() {
+        {
+            std::lock_guard<std::mutex> lock(elastic_mutex_);
+            elastic_stopping_ = true;
+        }
+        elastic_cv_.notify_all();
+        if (elastic_thread_.joinable()) elastic_thread_.join();
+    }
+
+    [[nodiscard]] bool running() const noexcept {
+        return state_.load(std::memory_order_acquire) == RuntimeState::kRunning;
+    }
+
+    // Lock-free admission for post_io/post_cpu: returns false once stop() has begun. On true
+    // the caller must leave_post() after handing the task to a pool.
+    [[nodiscard]] bool enter_post(std::size_t stripe) noexcept {
+        posters_[stripe].count.fetch_add(1, std::memory_order_seq_cst);
+        if (state_.load(std::memory_order_seq_cst) == RuntimeState::kRunning) return true;
+        posters_[stripe].count.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    void leave_post(std::size_t stripe) noexcept {
+        posters_[stripe].count.fetch_sub(1, std::memory_order_release);
+    }
+
+    // Dekker pairing with enter_post(): after the kStopping store, any poster that saw
+    // kRunning is visible in the stripe sum, and any later poster sees kStopping.
+    void wait_for_posters() noexcept {
+        for (;;) {
+            int64_t in_flight = 0;
+            for (const auto& stripe : posters_) in_flight += stripe.count.load(std::memory_order_acquire);
+            if (in_flight == 0) return;
+            std::this_thread::yield();
         }
     }
 
     void stop_and_join_locked() {
+        if (watchdog_) watchdog_->stop();
+        stop_elastic_locked();  // no worker starts after this
+        state_.store(RuntimeState::kStopping, std::memory_order_seq_cst);
+        wait_for_posters();
         stop_.store(true, std::memory_order_relaxed);
+        stop_file_io();  // waits for operations the kernel already has; their callbacks are dropped
 
-        if (io_work_) io_work_.reset();
+        io_work_.clear();
         if (cpu_work_) cpu_work_.reset();
 
-        io_ctx_.stop();
+        for (auto* ctx : io_shards_) ctx->stop();
         cpu_ctx_.stop();
 
         for (auto& t : io_threads_) {
             if (t.joinable()) t.join();
         }
-        for (auto& t : cpu_threads_) {
-            if (t.joinable()) t.join();
+        for (auto& wheel : wheels_) {
+            if (wheel) wheel->shutdown();  // outstanding handles keep the object, not the IO context
+        }
+        wheels_.clear();
+        for (auto& slot : cpu_slots_) {
+            if (slot.thread.joinable()) slot.thread.join();
         }
+        cpu_live_.store(0, std::memory_order_relaxed);
+        ws_pool_.stop();
+        lanes_.clear();  // their tokens were discarded with the pools
         for (auto& t : critical_threads_) {
             if (t.joinable()) t.join();
         }
 
         io_threads_.clear();
-        cpu_threads_.clear();
+        cpu_slots_.clear();
+        abandon_groups();
         critical_threads_.clear();
 
         // Prepare contexts for potential re-init.
-        io_ctx_.restart();
+        for (auto* ctx : io_shards_) ctx->restart();
         cpu_ctx_.restart();
 
-        started_ = false;
+        state_.store(RuntimeState::kStopped, std::memory_order_release);
+    }
+
+    // Requires a successful enter_post().
+    [[nodiscard]] FileIoService& file_io() {
+        if (auto* service = file_io_ptr_.load(std::memory_order_acquire)) return *service;
+        std::lock_guard<std::mutex> lock(file_io_mutex_);
+        if (!file_io_) {
+            file_io_ = FileIoService::create(file_io_options_, [this](const std::shared_ptr<IExecutor>& ex, Task t) {
+                deliver_file_completion(ex, std::move(t));
+            });
+            file_io_ptr_.store(file_io_.get(), std::memory_order_release);
+        }
+        return *file_io_;
+    }
+
+    // On the io_uring reaper or a fallback thread.
+    void deliver_file_completion(const std::shared_ptr<IExecutor>& executor, Task t) {
+        if (executor) {
+            executor->post(std::move(t));
+            return;
+        }
+        const std::size_t stripe = this_thread_stripe();
+        if (!enter_post(stripe)) return;
+        post_io_admitted(io_target(), std::move(t));
+        leave_post(stripe);
+    }
+
+    void stop_file_io() {
+        std::lock_guard<std::mutex> lock(file_io_mutex_);
+        if (file_io_) file_io_->shutdown();
+        file_io_ptr_.store(nullptr, std::memory_order_release);
+        file_io_.reset();
+    }
+
+    [[nodiscard]] std::vector<std::shared_ptr<detail::TaskGroupState>> live_groups() {
+        std::vector<std::shared_ptr<detail::TaskGroupState>> live;
+        std::lock_guard<std::mutex> lock(groups_mutex_);
+        for (const auto& weak : groups_) {
+            if (auto group = weak.lock()) live.push_back(std::move(group));
+        }
+        return live;
+    }
+
+    // Waits for the groups until `deadline`, then cancels whichever are still busy (for this
+    // session only; register_task_group() lifts it).
+    void drain_groups(std::chrono::steady_clock::time_point deadline) {
+        for (const auto& group : live_groups()) {
+            if (!group->wait_until(deadline)) group->drain_expired.store(true, std::memory_order_release);
+        }
+    }
+
+    // Workers are joined: whatever a group still counts as pending will never run.
+    // A group posting again after the next init() re-registers (register_task_group()).
+    void abandon_groups() {
+        std::lock_guard<std::mutex> lock(groups_mutex_);
+        groups_open_ = false;
+        for (const auto& weak : groups_) {
+            const auto group = weak.lock();
+            if (!group) continue;
+            std::lock_guard<std::mutex> group_lock(group->mutex);
+            group->abandoned.store(true, std::memory_order_release);
+            group->cv.notify_all();
+        }
+        groups_.clear();
+    }
+
+    [[nodiscard]] TaskHooks task_hooks(bool io, std::shared_ptr<TaskStats> strand = nullptr) const {
+        TaskHooks hooks;
+        hooks.watchdog = watchdog_ != nullptr;
+        if (stats_) hooks.stats = StatsHook{stats_, io ? &stats_->io : &stats_->cpu, std::move(strand)};
+        return hooks;
+    }
+
+    // Sizes io_shards_ for the next session; called by init() before any IO worker starts.
+    void setup_io_shards_locked(IoPoolKind kind, std::size_t io_n) {
+        io_pool_kind_ = kind;
+        const std::size_t n = kind == IoPoolKind::kPerThread ? io_n : 1U;
+        while (io_extra_ctxs_.size() + 1U < n) io_extra_ctxs_.push_back(std::make_unique<asio::io_context>(1));
+        io_shards_.assign(1U, &io_ctx_);
+        for (std::size_t i = 1; i < n; ++i) io_shards_.push_back(io_extra_ctxs_[i - 1U].get());
+        io_work_.clear();
+        for (auto* ctx : io_shards_) io_work_.push_back(asio::make_work_guard(*ctx));
+    }
+
+    // Unkeyed IO work: an IO worker keeps it on its own context, other threads rotate through
+    // the shards (per-thread cursor, so posters share no counter).
+    [[nodiscard]] std::size_t io_target_index() noexcept {
+        const std::size_t n = io_shards_.size();
+        if (n == 1U) return 0U;
+        if (t_io_shard.runtime == this) return t_io_shard.shard;
+        thread_local std::size_t cursor = this_thread_stripe();
+        return cursor++ % n;
+    }
+
+    [[nodiscard]] asio::io_context& io_target() noexcept { return *io_shards_[io_target_index()]; }
+
+    [[nodiscard]] asio::io_context& io_shard_for(std::size_t key) noexcept {
+        return *io_shards_[key % io_shards_.size()];
+    }
+
+    // Requires mutex_.
+    std::shared_ptr<TimingWheel>& wheel_locked(std::size_t shard) {
+        wheels_.resize(io_shards_.size());
+        auto& wheel = wheels_[shard];
+        if (!wheel) wheel = std::make_shared<TimingWheel>(*io_shards_[shard], wheel_tick_);
+        return wheel;
+    }
+
+    // Requires a successful enter_post().
+    void post_io_admitted(asio::io_context& ctx, Task f) {
+        const std::uint64_t flow = Tracer::flow_begin("post", "io");
+        if (stats_) f = meter_task(std::move(f), &stats_->io, nullptr);
+        post_watched(ctx, std::move(f), flow, "io");
+    }
+
+    // Requires a successful enter_post().
+    void post_cpu_admitted(Task f) {
+        const std::uint64_t flow = Tracer::flow_begin("post", "cpu");
+        if (stats_) f = meter_task(std::move(f), &stats_->cpu, nullptr);
+        post_cpu_unmetered(std::move(f), flow);
+    }
+
+    // The watchdog flag, flow id and strand ride in asio's handler, which asio allocates anyway.
+    // `scope` is kept alive by the handler and reported by IExecutor::current() while it runs.
+    void post_watched(asio::io_context& ctx, Task f, std::uint64_t flow = 0U, const char* category = nullptr,
+                      std::shared_ptr<IExecutor> scope = nullptr) {
+        const bool watched = watchdog_ != nullptr;
+        if (scope) {
+            asio::post(ctx, [f = std::move(f), watched, flow, category, scope = std::move(scope)]() mutable {
+                ExecutorScope running(scope.get());
+                run_task(f, watched, flow, category);
+            });
+            return;
+        }
+        // Elastic asio CPU workers must learn when they stop being idle.
+        const bool elastic_cpu = &ctx == &cpu_ctx_ && elastic_.enabled;
+        if (!watched && flow == 0U && !elastic_cpu) {
+            asio::post(ctx, std::move(f));
+            return;
+        }
+        asio::post(ctx, [f = std::move(f), watched, flow, category, elastic_cpu]() mutable {
+            if (elastic_cpu) leave_cpu_idle();
+            run_task(f, watched, flow, category);
+        });
+    }
+
+    // Strand batches are admitted like a post; their tasks are metered by the hooks instead.
+    // With one context per IO thread an IO strand is just a shard: its single thread already
+    // runs everything in order, so no queue is needed.
+    std::shared_ptr<IExecutor> make_strand(sx::hal::IThreadScheduler::ThreadClass cls, TaskHooks hooks) {
+        if (cls == sx::hal::IThreadScheduler::ThreadClass::kIo && io_shards_.size() > 1U) {
+            const std::size_t shard = io_target_index();
+            asio::io_context* ctx = io_shards_[shard];
+            return std::make_shared<ShardExecutor>(
+                [this, ctx](Task f, std::uint64_t flow, std::shared_ptr<IExecutor> scope) {
+                    (void)post_unmetered(*ctx, std::move(f), flow, "strand", std::move(scope));
+                },
+                std::move(hooks), this, shard);
+        }
+        return std::make_shared<SerialExecutor>([this, cls](Task batch) { (void)post_unmetered(cls, std::move(batch)); },
+                                                std::move(hooks));
+    }
+
+    // Strand batches, watchdog heartbeats and elastic probes: admitted like a post, but not
+    // counted in metrics.
+    bool post_unmetered(sx::hal::IThreadScheduler::ThreadClass cls, Task beat) {
+        const std::size_t stripe = this_thread_stripe();
+        if (!enter_post(stripe)) return false;
+        if (cls == sx::hal::IThreadScheduler::ThreadClass::kIo) {
+            post_watched(io_target(), std::move(beat));
+        } else {
+            post_cpu_unmetered(std::move(beat));
+        }
+        leave_post(stripe);
+        return true;
+    }
+
+    bool post_unmetered(asio::io_context& ctx, Task f, std::uint64_t flow = 0U, const char* category = nullptr,
+                        std::shared_ptr<IExecutor> scope = nullptr) {
+        const std::size_t stripe = this_thread_stripe();
+        if (!enter_post(stripe)) return false;
+        post_watched(ctx, std::move(f), flow, category, std::move(scope));
+        leave_post(stripe);
+        return true;
+    }
+
+    void report_stall(const StallReport& report) {
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        std::function<void(const StallReport&)> handler;
+        {
+            std::lock_guard<std::mutex> lock(stall_mutex_);
+            handler = stall_handler_;
+        }
+        if (handler) handler(report);
+    }
+
+    void post_cpu_unmetered(Task f, std::uint64_t flow = 0U) {
+        if (cpu_pool_kind_ == CpuPoolKind::kWorkStealing) {
+            ws_pool_.post(std::move(f), flow);
+        } else {
+            post_watched(cpu_ctx_, std::move(f), flow, "cpu");
+        }
     }
 };
 
-AsyncRuntime::AsyncRuntime() : pImpl_(std::make_unique<Impl>()) {}
+AsyncRuntime::AsyncRuntime() : pImpl_(std::make_unique<Impl>()) {
+    pImpl_->io_executor_ = std::make_shared<PoolExecutor>([this](Task f) { post_io_impl(std::move(f)); });
+    pImpl_->cpu_executor_ = std::make_shared<PoolExecutor>([this](Task f) { post_cpu_impl(std::move(f)); });
+}
 AsyncRuntime::~AsyncRuntime() { stop(); }
 
 void AsyncRuntime::init(std::shared_ptr<sx::hal::IThreadScheduler> scheduler, std::size_t io_n, std::size_t cpu_n) {
+    RuntimeOptions options;
+    options.io_threads = io_n;
+    options.cpu_threads = cpu_n;
+    init(std::move(scheduler), options);
+}
+
+void AsyncRuntime::init(std::shared_ptr<sx::hal::IThreadScheduler> scheduler, const RuntimeOptions& options) {
+    std::size_t io_n = options.io_threads;
+    std::size_t cpu_n = options.cpu_threads;
     if (io_n == 0U) io_n = 1U;
     if (cpu_n == 0U) cpu_n = std::max<std::size_t>(1U, std::thread::hardware_concurrency());
 
     std::lock_guard<std::mutex> lock(pImpl_->mutex_);
-    if (pImpl_->started_) return;
+    if (pImpl_->state_.load(std::memory_order_relaxed) != RuntimeState::kStopped) return;
 
     pImpl_->stop_.store(false, std::memory_order_relaxed);
     pImpl_->scheduler_ = std::move(scheduler);
+    pImpl_->cpu_pool_kind_ = options.cpu_pool;
+    pImpl_->wheel_tick_ = options.timer_wheel_tick;
+    pImpl_->elastic_ = options.elastic;
+    pImpl_->file_io_options_ = options.file_io;
+    pImpl_->cpu_max_.store(cpu_n, std::memory_order_relaxed);
+    pImpl_->cpu_min_.store(
+        options.elastic.enabled ? std::clamp<std::size_t>(options.elastic.min_threads, 1U, cpu_n) : cpu_n,
+        std::memory_order_relaxed);
+    if (pImpl_->stats_) pImpl_->retired_stats_.push_back(std::move(pImpl_->stats_));
+    pImpl_->stats_ = options.enable_metrics ? std::make_shared<RuntimeStats>(io_n, cpu_n) : nullptr;
+    pImpl_->setup_io_shards_locked(options.io_pool, io_n);
+    pImpl_->watchdog_ = nullptr;
+    if (options.watchdog.enabled) {
+        pImpl_->watchdog_ = std::make_shared<Watchdog>(
+            options.watchdog, io_n, cpu_n, pImpl_->io_shards_.size(),
+            [impl = pImpl_.get()](const StallReport& r) { impl->report_stall(r); });
+    }
 
-    pImpl_->io_work_.emplace(asio::make_work_guard(pImpl_->io_ctx_));
     pImpl_->cpu_work_.emplace(asio::make_work_guard(pImpl_->cpu_ctx_));
 
     pImpl_->start_threads_locked(io_n, cpu_n);
-    pImpl_->started_ = true;
+    pImpl_->cpu_threads_n_.store(cpu_n, std::memory_order_relaxed);
+    pImpl_->state_.store(RuntimeState::kRunning, std::memory_order_release);
+    pImpl_->start_elastic_locked();
+    {
+        std::lock_guard<std::mutex> groups_lock(pImpl_->groups_mutex_);
+        pImpl_->groups_open_ = true;
+    }
+
+    if (pImpl_->watchdog_) {
+        pImpl_->watchdog_->start(
+            [impl = pImpl_.get()](sx::hal::IThreadScheduler::ThreadClass cls, std::size_t shard, Task beat) {
+                if (cls == sx::hal::IThreadScheduler::ThreadClass::kIo) {
+                    return impl->post_unmetered(impl->io_shard_for(shard), std::move(beat));
+                }
+                return impl->post_unmetered(cls, std::move(beat));
+            });
+    }
 }
 
 void AsyncRuntime::stop() {
     std::lock_guard<std::mutex> lock(pImpl_->mutex_);
-    if (!pImpl_->started_) return;
+    if (pImpl_->state_.load(std::memory_order_relaxed) != RuntimeState::kRunning) return;
     pImpl_->stop_and_join_locked();
 }
 
-void AsyncRuntime::post_io_impl(std::function<void()> f) {
-    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
-    if (!pImpl_->started_) return;
-    asio::post(pImpl_->io_ctx_, std::move(f));
+void AsyncRuntime::stop(std::chrono::milliseconds drain_timeout) {
+    // Not under mutex_: group tasks may still create strands or timers while draining.
+    if (pImpl_->running()) pImpl_->drain_groups(std::chrono::steady_clock::now() + drain_timeout);
+    stop();
+}
+
+void AsyncRuntime::register_task_group(const std::shared_ptr<detail::TaskGroupState>& group) {
+    std::lock_guard<std::mutex> lock(pImpl_->groups_mutex_);
+    if (!pImpl_->groups_open_) return;  // stays abandoned until a post after init()
+    {
+        std::lock_guard<std::mutex> group_lock(group->mutex);
+        if (!group->abandoned.load(std::memory_order_relaxed)) return;  // a concurrent post was first
+        // Tasks of the session that gave up on the group are gone with its workers.
+        group->drain_expired.store(false, std::memory_order_release);
+        group->abandoned.store(false, std::memory_order_release);
+    }
+    auto& groups = pImpl_->groups_;
+    groups.erase(std::remove_if(groups.begin(), groups.end(), [](const auto& g) { return g.expired(); }), groups.end());
+    groups.push_back(group);
+}
+
+void AsyncRuntime::post_io_impl(Task f) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->post_io_admitted(pImpl_->io_target(), std::move(f));
+    pImpl_->leave_post(stripe);
+}
+
+void AsyncRuntime::post_io_keyed_impl(std::size_t key, Task f) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->post_io_admitted(pImpl_->io_shard_for(key), std::move(f));
+    pImpl_->leave_post(stripe);
+}
+
+void AsyncRuntime::dispatch_io_impl(Task f) { pImpl_->io_executor_->dispatch(std::move(f)); }
+
+void AsyncRuntime::dispatch_cpu_impl(Task f) { pImpl_->cpu_executor_->dispatch(std::move(f)); }
+
+std::shared_ptr<IExecutor> AsyncRuntime::io_executor() const { return pImpl_->io_executor_; }
+
+std::shared_ptr<IExecutor> AsyncRuntime::cpu_executor() const { return pImpl_->cpu_executor_; }
+
+std::size_t AsyncRuntime::io_shards() const noexcept {
+    return pImpl_->running() ? pImpl_->io_shards_.size() : 0U;
+}
+
+void AsyncRuntime::post_cpu_impl(Task f) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->post_cpu_admitted(std::move(f));
+    pImpl_->leave_post(stripe);
+}
+
+void AsyncRuntime::post_cpu_prioritized_impl(const TaskOptions& options, Task f) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->lanes_.push(options, std::move(f));
+    pImpl_->post_cpu_admitted([impl = pImpl_.get()]() { impl->lanes_.run_one(); });
+    pImpl_->leave_post(stripe);
+}
+
+void AsyncRuntime::async_read(int fd, void* data, std::size_t size, std::uint64_t offset, FileIoCallback callback,
+                              std::shared_ptr<IExecutor> executor) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->file_io().read(fd, data, size, offset, std::move(callback), std::move(executor));
+    pImpl_->leave_post(stripe);
 }
 
-void AsyncRuntime::post_cpu_impl(std::function<void()> f) {
+void AsyncRuntime::async_write(int fd, const void* data, std::size_t size, std::uint64_t offset,
+                               FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->file_io().write(fd, data, size, offset, std::move(callback), std::move(executor));
+    pImpl_->leave_post(stripe);
+}
+
+void AsyncRuntime::async_read(int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset,
+                              FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->file_io().read(fd, buffer, size, offset, std::move(callback), std::move(executor));
+    pImpl_->leave_post(stripe);
+}
+
+void AsyncRuntime::async_write(int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset,
+                               FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->file_io().write(fd, buffer, size, offset, std::move(callback), std::move(executor));
+    pImpl_->leave_post(stripe);
+}
+
+void AsyncRuntime::async_fsync(int fd, FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->file_io().sync(fd, false, std::move(callback), std::move(executor));
+    pImpl_->leave_post(stripe);
+}
+
+void AsyncRuntime::async_fdatasync(int fd, FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return;
+    pImpl_->file_io().sync(fd, true, std::move(callback), std::move(executor));
+    pImpl_->leave_post(stripe);
+}
+
+FileBuffer AsyncRuntime::acquire_file_buffer() {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return {};
+    FileBuffer buffer = pImpl_->file_io().acquire_buffer();
+    pImpl_->leave_post(stripe);
+    return buffer;
+}
+
+FileIoBackend AsyncRuntime::file_io_backend() {
+    const std::size_t stripe = this_thread_stripe();
+    if (!pImpl_->enter_post(stripe)) return FileIoBackend::kAuto;
+    const FileIoBackend backend = pImpl_->file_io().backend();
+    pImpl_->leave_post(stripe);
+    return backend;
+}
+
+std::uint64_t AsyncRuntime::expired_task_drops() const noexcept { return pImpl_->lanes_.expired_drops(); }
+
+RuntimeMetrics AsyncRuntime::metrics() const {
+    std::shared_ptr<RuntimeStats> stats;
+    {
+        std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+        stats = pImpl_->stats_;
+    }
+    return stats ? stats->snapshot() : RuntimeMetrics{};
+}
+
+CpuPoolSize AsyncRuntime::cpu_pool_size() const noexcept {
+    CpuPoolSize size;
+    if (!pImpl_->running()) return size;
+    size.live = pImpl_->cpu_live();
+    size.min = pImpl_->cpu_min_.load(std::memory_order_relaxed);
+    size.max = pImpl_->cpu_max_.load(std::memory_order_relaxed);
+    return size;
+}
+
+void AsyncRuntime::set_cpu_pool_limits(std::size_t min_threads, std::size_t max_threads) {
     std::lock_guard<std::mutex> lock(pImpl_->mutex_);
-    if (!pImpl_->started_) return;
-    asio::post(pImpl_->cpu_ctx_, std::move(f));
+    if (!pImpl_->running() || !pImpl_->elastic_.enabled) return;
+    const std::size_t max = std::clamp<std::size_t>(max_threads, 1U, pImpl_->cpu_threads_n_.load(std::memory_order_relaxed));
+    const std::size_t min = std::clamp<std::size_t>(min_threads, 1U, max);
+    pImpl_->cpu_min_.store(min, std::memory_order_relaxed);
+    pImpl_->cpu_max_.store(max, std::memory_order_relaxed);
+    if (pImpl_->cpu_pool_kind_ == CpuPoolKind::kWorkStealing) {
+        pImpl_->ws_pool_.set_limits(min, max);
+        return;
+    }
+    // Wake parked asio workers so the surplus notices the new ceiling now, not after retire_after.
+    const std::size_t live = pImpl_->cpu_live();
+    for (std::size_t i = max; i < live; ++i) {
+        (void)pImpl_->post_unmetered(sx::hal::IThreadScheduler::ThreadClass::kCpu, []() {});
+    }
+}
+
+void AsyncRuntime::set_stall_handler(std::function<void(const StallReport&)> handler) {
+    std::lock_guard<std::mutex> lock(pImpl_->stall_mutex_);
+    pImpl_->stall_handler_ = std::move(handler);
+}
+
+std::uint64_t AsyncRuntime::stalls_detected() const noexcept { return pImpl_->stalls_.load(std::memory_order_relaxed); }
+
+void AsyncRuntime::watchdog_kick() noexcept { Watchdog::kick(); }
+
+std::size_t AsyncRuntime::parallel_slots() const noexcept {
+    return pImpl_->cpu_threads_n_.load(std::memory_order_relaxed) + 1U;
+}
+
+void AsyncRuntime::parallel_for_impl(std::size_t first, std::size_t last, std::size_t grain, std::size_t slots,
+                                     RangeBody body, void* ctx) {
+    if (first >= last) return;
+    if (grain == 0U) grain = 1U;
+    const std::size_t total = last - first;
+    const std::size_t max_chunks = (total + grain - 1U) / grain;
+
+    std::size_t helpers = 0;
+    if (pImpl_->running()) helpers = std::min({slots - 1U, parallel_slots() - 1U, max_chunks - 1U});
+    if (helpers == 0U) {
+        body(ctx, 0U, first, last);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelState>();
+    state->next.store(first, std::memory_order_relaxed);
+    state->remaining.store(total, std::memory_order_relaxed);
+    state->last = last;
+    state->grain = grain;
+    state->participants = helpers + 1U;
+    state->body = body;
+    state->ctx = ctx;
+
+    // The caller claims its first chunk before waking helpers, so it always contributes.
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    const bool claimed = state->claim(begin, end);
+    for (std::size_t i = 1; i <= helpers; ++i) {
+        post_cpu_impl([state, i]() { state->run(i); });
+    }
+    if (claimed) state->run_chunk(0U, begin, end);
+    state->run(0U);
+    state->wait();
+
+    if (state->error) std::rethrow_exception(state->error);
 }
 
 std::shared_ptr<ITimer> AsyncRuntime::create_timer() {
     std::lock_guard<std::mutex> lock(pImpl_->mutex_);
-    assert(pImpl_->started_ && "AsyncRuntime::init() must be called before create_timer()");
-    return std::make_shared<AsioTimer>(pImpl_->io_ctx_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_timer()");
+    return std::make_shared<AsioTimer>(pImpl_->io_target());
+}
+
+std::shared_ptr<ITimer> AsyncRuntime::create_timer(std::size_t key) {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_timer()");
+    return std::make_shared<AsioTimer>(pImpl_->io_shard_for(key));
+}
+
+std::shared_ptr<ITimer> AsyncRuntime::create_wheel_timer() {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_wheel_timer()");
+    return make_wheel_timer(pImpl_->wheel_locked(pImpl_->io_target_index()));
+}
+
+std::shared_ptr<ITimer> AsyncRuntime::create_wheel_timer(std::size_t key) {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_wheel_timer()");
+    return make_wheel_timer(pImpl_->wheel_locked(key % pImpl_->io_shards_.size()));
+}
+
+std::shared_ptr<IPeriodicTimer> AsyncRuntime::create_periodic_timer() {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_periodic_timer()");
+    return std::make_shared<AsioPeriodicTimer>(pImpl_->io_target());
 }
 
 std::shared_ptr<IExecutor> AsyncRuntime::create_cpu_strand() {
     std::lock_guard<std::mutex> lock(pImpl_->mutex_);
-    assert(pImpl_->started_ && "AsyncRuntime::init() must be called before create_cpu_strand()");
-    return std::make_shared<AsioExecutor>(pImpl_->cpu_ctx_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_cpu_strand()");
+    return pImpl_->make_strand(sx::hal::IThreadScheduler::ThreadClass::kCpu, pImpl_->task_hooks(false));
 }
 
 std::shared_ptr<IExecutor> AsyncRuntime::create_io_strand() {
     std::lock_guard<std::mutex> lock(pImpl_->mutex_);
-    assert(pImpl_->started_ && "AsyncRuntime::init() must be called before create_io_strand()");
-    return std::make_shared<AsioExecutor>(pImpl_->io_ctx_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_io_strand()");
+    return pImpl_->make_strand(sx::hal::IThreadScheduler::ThreadClass::kIo, pImpl_->task_hooks(true));
 }
 
-void AsyncRuntime::spawn_critical_loop_impl(const sx::types::ThreadPolicy& policy,
+std::shared_ptr<IExecutor> AsyncRuntime::create_cpu_strand(std::string name) {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_cpu_strand()");
+    auto strand = pImpl_->stats_ ? pImpl_->stats_->register_strand(std::move(name)) : nullptr;
+    return pImpl_->make_strand(sx::hal::IThreadScheduler::ThreadClass::kCpu, pImpl_->task_hooks(false, std::move(strand)));
+}
+
+std::shared_ptr<IExecutor> AsyncRuntime::create_io_strand(std::string name) {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    assert(pImpl_->running() && "AsyncRuntime::init() must be called before create_io_strand()");
+    auto strand = pImpl_->stats_ ? pImpl_->stats_->register_strand(std::move(name)) : nullptr;
+    return pImpl_->make_strand(sx::hal::IThreadScheduler::ThreadClass::kIo, pImpl_->task_hooks(true, std::move(strand)));
+}
+
+bool AsyncRuntime::spawn_critical_loop_impl(const sx::types::ThreadPolicy& policy,
                                            std::function<void(std::atomic<bool>&)> f) {
     std::lock_guard<std::mutex> lock(pImpl_->mutex_);
-    if (!pImpl_->started_) return;
+    if (!pImpl_->running()) return false;
 
     // The critical loop shares the runtime stop flag. Business code should check it.
-    pImpl_->critical_threads_.emplace_back([this, policy, fn = std::move(f)]() mutable {
+    // Loops are numbered in spawn order so a scheduler can give each one its own core.
+    const std::size_t index = pImpl_->critical_threads_.size();
+    pImpl_->critical_threads_.emplace_back([this, index, policy, fn = std::move(f)]() mutable {
+        Tracer::set_thread_name("sx-critical-" + std::to_string(index));
         if (pImpl_->scheduler_) {
-            pImpl_->scheduler_->on_thread_start(sx::hal::IThreadScheduler::ThreadClass::kCritical, 0U);
+            pImpl_->scheduler_->on_thread_start(sx::hal::IThreadScheduler::ThreadClass::kCritical, index);
             pImpl_->scheduler_->apply_current_thread_policy(policy);
         }
+        if (pImpl_->watchdog_) pImpl_->watchdog_->bind_critical(index);
         if (fn) fn(pImpl_->stop_);
+        Watchdog::release_current();
     });
+    return true;
 }
 
 void* AsyncRuntime::internal_get_io_context() {
     return static_cast<void*>(&pImpl_->io_ctx_);
 }
 
+void* AsyncRuntime::internal_get_io_context(std::size_t key) {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    if (pImpl_->io_shards_.empty()) return static_cast<void*>(&pImpl_->io_ctx_);
+    return static_cast<void*>(&pImpl_->io_shard_for(key));
+}
+
 }  // namespace sx::infra
 
 
@@ -0,0 +1,116 @@
+/**
+ * @file critical_loop.cpp
+ * @brief CriticalLoop implementation (hybrid clock_nanosleep / busy-poll pacing)
+ */
+
+#include "sx/infra/critical_loop.h"
+
+#include <algorithm>
+
+#include "sx/infra/loop_rate.h"
+#include "task_stats.h"
+#include "watchdog.h"
+
+namespace sx::infra {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+uint64_t to_ns(Clock::duration d) noexcept {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    return ns > 0 ? static_cast<uint64_t>(ns) : 0U;
+}
+
+}  // namespace
+
+// Written by the loop thread only; read by stats() from anywhere.
+struct CriticalLoop::Impl {
+    std::atomic<bool> stop_requested{false};
+    std::atomic<uint64_t> iterations{0};
+    std::atomic<uint64_t> overruns{0};
+    AtomicHistogram wake_latency;
+    AtomicHistogram exec_time;
+};
+
+CriticalLoop::CriticalLoop(const CriticalLoopOptions& options)
+    : options_([&options]() {
+          CriticalLoopOptions o = options;
+          o.period = std::max(o.period, std::chrono::nanoseconds{1});
+          o.spin_budget = std::max(o.spin_budget, std::chrono::nanoseconds{0});
+          return o;
+      }()),
+      pImpl_(std::make_unique<Impl>()) {}
+
+CriticalLoop::~CriticalLoop() = default;
+
+sx::types::ThreadPolicy CriticalLoop::thread_policy() const noexcept {
+    sx::types::ThreadPolicy policy;
+    policy.cpu_id = options_.cpu;
+    policy.realtime = options_.realtime;
+    policy.realtime_priority = options_.realtime_priority;
+    return policy;
+}
+
+void CriticalLoop::stop() noexcept { pImpl_->stop_requested.store(true, std::memory_order_relaxed); }
+
+void CriticalLoop::run(const std::atomic<bool>& stop, const Body& body) {
+    Impl& impl = *pImpl_;
+    auto stopping = [&]() {
+        return stop.load(std::memory_order_relaxed) || impl.stop_requested.load(std::memory_order_relaxed);
+    };
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(options_.period);
+    const auto spin = std::chrono::duration_cast<Clock::duration>(options_.spin_budget);
+    const auto origin = Clock::now();
+    LoopIteration it;
+    it.index = 1;
+    it.deadline = origin + period;
+
+    while (!stopping()) {
+        // Sleep through the bulk of the wait, then busy-poll the last `spin` of it.
+        if (spin < period) sleep_until(it.deadline - spin);
+        Clock::time_point wake = Clock::now();
+        while (wake < it.deadline && !stopping()) {
+            cpu_relax();
+            wake = Clock::now();
+        }
+        if (wake < it.deadline) break;
+
+        it.wake_latency = std::chrono::duration_cast<std::chrono::nanoseconds>(wake - it.deadline);
+        impl.wake_latency.record(to_ns(wake - it.deadline));
+        // Counted as the body is told, so the stats always match what the bodies saw.
+        if (it.missed > 0U) impl.overruns.fetch_add(it.missed, std::memory_order_relaxed);
+        Watchdog::kick();
+        if (body) body(it);
+        const auto end = Clock::now();
+        impl.exec_time.record(to_ns(end - wake));
+        impl.iterations.fetch_add(1, std::memory_order_relaxed);
+
+        // Stay on the grid: deadlines already behind us are skipped, not caught up.
+        const auto late = end - it.deadline;
+        const auto missed = late >= period ? static_cast<uint64_t>(late / period) : 0U;
+        it.missed = missed;
+        it.index += missed + 1U;
+        it.deadline += period * static_cast<int64_t>(missed + 1U);
+    }
+}
+
+CriticalLoopStats CriticalLoop::stats() const {
+    CriticalLoopStats out;
+    out.iterations = pImpl_->iterations.load(std::memory_order_relaxed);
+    out.overruns = pImpl_->overruns.load(std::memory_order_relaxed);
+    out.wake_latency = pImpl_->wake_latency.snapshot();
+    out.exec_time = pImpl_->exec_time.snapshot();
+    return out;
+}
+
+}  // namespace sx::infra
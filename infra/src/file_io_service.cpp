@@ -0,0 +1,567 @@
+/**
+ * @file file_io_service.cpp
+ * @brief io_uring and thread-pool file I/O engines, FileBuffer pool
+ */
+
+#include "file_io_service.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "sx/infra/trace.h"
+
+namespace sx::infra {
+
+namespace {
+
+constexpr std::size_t kBufferAlignment = 4096U;
+// Largest single read/write Linux performs; longer requests are continued.
+constexpr std::size_t kMaxTransfer = 0x7ffff000U;
+// Pause before the io_uring reaper resubmits SQEs the kernel refused.
+constexpr int kRetryMs = 1;
+
+std::error_code errno_code(int err) noexcept { return {err, std::system_category()}; }
+
+std::error_code last_errno() noexcept { return errno_code(errno); }
+
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------
+// FileBuffer / FileBufferPool
+
+FileBuffer::FileBuffer(FileBuffer&& other) noexcept
+    : pool_(std::move(other.pool_)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0U)),
+      index_(std::exchange(other.index_, -1)) {}
+
+FileBuffer& FileBuffer::operator=(FileBuffer&& other) noexcept {
+    if (this != &other) {
+        FileBuffer old(std::move(*this));
+        pool_ = std::move(other.pool_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0U);
+        index_ = std::exchange(other.index_, -1);
+    }
+    return *this;
+}
+
+FileBuffer::~FileBuffer() {
+    if (pool_) pool_->release(index_);
+}
+
+namespace detail {
+
+FileBufferPool::FileBufferPool(std::size_t count, std::size_t size)
+    : size_((std::max<std::size_t>(size, 1U) + kBufferAlignment - 1U) / kBufferAlignment * kBufferAlignment) {
+    buffers_.reserve(count);
+    free_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto* p = static_cast<std::byte*>(std::aligned_alloc(kBufferAlignment, size_));
+        if (p == nullptr) break;
+        free_.push_back(static_cast<int>(buffers_.size()));
+        buffers_.push_back(p);
+    }
+    std::reverse(free_.begin(), free_.end());  // hand out slot 0 first
+}
+
+FileBufferPool::~FileBufferPool() {
+    for (auto* p : buffers_) std::free(p);
+}
+
+FileBuffer FileBufferPool::acquire() {
+    FileBuffer buffer;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) return buffer;
+    buffer.index_ = free_.back();
+    free_.pop_back();
+    buffer.pool_ = shared_from_this();
+    buffer.data_ = buffers_[static_cast<std::size_t>(buffer.index_)];
+    buffer.size_ = size_;
+    return buffer;
+}
+
+void FileBufferPool::release(int slot) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(slot);
+}
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------------------------
+// FileIoService
+
+void FileIoService::read(int fd, void* data, std::size_t size, std::uint64_t offset, FileIoCallback callback,
+                         std::shared_ptr<IExecutor> executor) {
+    submit_data(FileOpKind::kRead, fd, static_cast<std::byte*>(data), size, offset, std::move(callback),
+                std::move(executor));
+}
+
+void FileIoService::write(int fd, const void* data, std::size_t size, std::uint64_t offset,
+                          FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    // Writes only read through `data`; FileRequest keeps one non-const pointer for both.
+    submit_data(FileOpKind::kWrite, fd, static_cast<std::byte*>(const_cast<void*>(data)), size, offset,
+                std::move(callback), std::move(executor));
+}
+
+void FileIoService::read(int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset,
+                         FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    submit_buffer(FileOpKind::kRead, fd, buffer, size, offset, std::move(callback), std::move(executor));
+}
+
+void FileIoService::write(int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset,
+                          FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    submit_buffer(FileOpKind::kWrite, fd, buffer, size, offset, std::move(callback), std::move(executor));
+}
+
+void FileIoService::submit_data(FileOpKind kind, int fd, std::byte* data, std::size_t size, std::uint64_t offset,
+                                FileIoCallback callback, std::shared_ptr<IExecutor> executor, int buf_index) {
+    auto request = std::make_unique<FileRequest>();
+    request->kind = kind;
+    request->fd = fd;
+    request->data = data;
+    request->size = size;
+    request->offset = offset;
+    request->buf_index = buf_index;
+    request->callback = std::move(callback);
+    request->executor = std::move(executor);
+    submit(std::move(request));
+}
+
+void FileIoService::submit_buffer(FileOpKind kind, int fd, const FileBuffer& buffer, std::size_t size,
+                                  std::uint64_t offset, FileIoCallback callback,
+                                  std::shared_ptr<IExecutor> executor) {
+    if (!buffer || size > buffer.size_) {
+        auto request = std::make_unique<FileRequest>();
+        request->callback = std::move(callback);
+        request->executor = std::move(executor);
+        finish(std::move(request), std::make_error_code(std::errc::invalid_argument));
+        return;
+    }
+    // A buffer from an earlier session's pool is not registered with this ring.
+    const int index = buffer.pool_ == pool_ && pool_->registered() ? buffer.index_ : -1;
+    submit_data(kind, fd, buffer.data_, size, offset, std::move(callback), std::move(executor), index);
+}
+
+void FileIoService::sync(int fd, bool data_only, FileIoCallback callback, std::shared_ptr<IExecutor> executor) {
+    auto request = std::make_unique<FileRequest>();
+    request->kind = data_only ? FileOpKind::kFdatasync : FileOpKind::kFsync;
+    request->fd = fd;
+    request->callback = std::move(callback);
+    request->executor = std::move(executor);
+    submit(std::move(request));
+}
+
+FileBuffer FileIoService::acquire_buffer() { return pool_ ? pool_->acquire() : FileBuffer{}; }
+
+void FileIoService::finish(std::unique_ptr<FileRequest> request, std::error_code ec) {
+    if (!request->callback) return;
+    deliver_(request->executor, [cb = std::move(request->callback), ec, n = request->done]() { cb(ec, n); });
+}
+
+namespace {
+
+// ---------------------------------------------------------------------------------------------
+// io_uring backend (raw syscalls; liburing is not required)
+//
+// Submitters fill SQEs under sq_mutex_ and enter the kernel right away; one reaper thread
+// polls the ring fd and turns CQEs into deliveries. At most sq_entries operations are in
+// flight - the CQ ring is twice that, so it never overflows - and the rest wait in a backlog
+// that completions drain. SQEs the kernel refuses (EAGAIN / EBUSY) are retried by the reaper,
+// which an eventfd wakes since no completion may be coming to do it.
+class UringFileIo final : public FileIoService {
+public:
+    UringFileIo(Deliver deliver, std::shared_ptr<detail::FileBufferPool> pool)
+        : FileIoService(std::move(deliver), std::move(pool)) {}
+    ~UringFileIo() override { shutdown(); }
+
+    UringFileIo(const UringFileIo&) = delete;
+    UringFileIo& operator=(const UringFileIo&) = delete;
+    UringFileIo(UringFileIo&&) = delete;
+    UringFileIo& operator=(UringFileIo&&) = delete;
+
+    // False when the kernel (or a seccomp filter) refuses the ring; submit() then fails every
+    // operation with that error, for FileIoBackend::kIoUring.
+    bool open(unsigned depth) {
+        io_uring_params params{};
+        const long fd = ::syscall(__NR_io_uring_setup, std::max(depth, 1U), &params);
+        if (fd < 0) {
+            setup_error_ = last_errno();
+            return false;
+        }
+        ring_fd_ = static_cast<int>(fd);
+        if (!map_rings(params) || !supports_ops()) {
+            close_ring();
+            return false;
+        }
+        register_buffers();
+        wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wake_fd_ < 0) {
+            setup_error_ = last_errno();
+            close_ring();
+            return false;
+        }
+        reaper_ = std::thread([this]() {
+            Tracer::set_thread_name("sx-uring");
+            reap_loop();
+        });
+        return true;
+    }
+
+    [[nodiscard]] FileIoBackend backend() const noexcept override { return FileIoBackend::kIoUring; }
+
+    void shutdown() override {
+        {
+            std::lock_guard<std::mutex> lock(sq_mutex_);
+            if (stopping_ || ring_fd_ < 0) return;
+            stopping_ = true;
+            backlog_.clear();
+            wake_reaper();
+        }
+        if (reaper_.joinable()) reaper_.join();
+        close_ring();
+    }
+
+protected:
+    void submit(std::unique_ptr<FileRequest> request) override {
+        if (ring_fd_ < 0) {
+            finish(std::move(request), setup_error_);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(sq_mutex_);
+        if (stopping_) return;
+        if (in_flight_ == capacity_) {
+            backlog_.push_back(std::move(request));
+            return;
+        }
+        ++in_flight_;
+        push_locked(request.release());
+    }
+
+private:
+    bool map_rings(const io_uring_params& p) {
+        sq_bytes_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_bytes_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0U;
+        if (single) sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+
+        sq_ring_ = map(sq_bytes_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == nullptr) return false;
+        cq_ring_ = single ? sq_ring_ : map(cq_bytes_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == nullptr) return false;
+        sqes_bytes_ = p.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_bytes_, IORING_OFF_SQES));
+        if (sqes_ == nullptr) return false;
+
+        auto* sq = static_cast<char*>(sq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        auto* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        capacity_ = p.sq_entries;
+        return true;
+    }
+
+    void* map(std::size_t bytes, unsigned long long offset) {
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                         static_cast<off_t>(offset));
+        if (p != MAP_FAILED) return p;
+        setup_error_ = last_errno();
+        return nullptr;
+    }
+
+    // IORING_OP_READ / WRITE need 5.6; older kernels take kAuto down the thread-pool path.
+    bool supports_ops() {
+        constexpr unsigned kOps = 64U;
+        const std::size_t bytes = sizeof(io_uring_probe) + kOps * sizeof(io_uring_probe_op);
+        std::vector<unsigned char> storage(bytes, 0U);
+        auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+        bool ok = ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe, kOps) == 0;
+        for (const unsigned op : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC}) {
+            ok = ok && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0U;
+        }
+        if (!ok) setup_error_ = std::make_error_code(std::errc::operation_not_supported);
+        return ok;
+    }
+
+    // Best effort: without RLIMIT_MEMLOCK headroom the buffers still work, just unregistered.
+    void register_buffers() {
+        if (!pool_ || pool_->count() == 0U) return;
+        std::vector<iovec> iov(pool_->count());
+        for (std::size_t i = 0; i < iov.size(); ++i) iov[i] = iovec{pool_->buffer(i), pool_->buffer_size()};
+        const long rc = ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS, iov.data(),
+                                  static_cast<unsigned>(iov.size()));
+        pool_->set_registered(rc == 0);
+    }
+
+    void close_ring() {
+        if (sqes_ != nullptr) ::munmap(sqes_, sqes_bytes_);
+        if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_bytes_);
+        if (sq_ring_ != nullptr) ::munmap(sq_ring_, sq_bytes_);
+        sqes_ = nullptr;
+        cq_ring_ = sq_ring_ = nullptr;
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+        ring_fd_ = -1;
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        wake_fd_ = -1;
+        if (pool_) pool_->set_registered(false);
+    }
+
+    // Queues one SQE and submits everything not yet taken by the kernel.
+    void push_locked(FileRequest* r) {
+        const unsigned tail = *sq_tail_;
+        const unsigned idx = tail & sq_mask_;
+        io_uring_sqe& sqe = sqes_[idx];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.user_data = reinterpret_cast<std::uint64_t>(r);
+        if (r->kind == FileOpKind::kFsync || r->kind == FileOpKind::kFdatasync) {
+            sqe.opcode = IORING_OP_FSYNC;
+            sqe.fd = r->fd;
+            if (r->kind == FileOpKind::kFdatasync) sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+        } else {
+            const bool fixed = r->buf_index >= 0;
+            if (r->kind == FileOpKind::kRead) {
+                sqe.opcode = static_cast<std::uint8_t>(fixed ? IORING_OP_READ_FIXED : IORING_OP_READ);
+            } else {
+                sqe.opcode = static_cast<std::uint8_t>(fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE);
+            }
+            sqe.fd = r->fd;
+            sqe.addr = reinterpret_cast<std::uint64_t>(r->data + r->done);
+            sqe.len = static_cast<std::uint32_t>(std::min(r->size - r->done, kMaxTransfer));
+            sqe.off = r->offset + r->done;
+            if (fixed) sqe.buf_index = static_cast<std::uint16_t>(r->buf_index);
+        }
+        sq_array_[idx] = idx;
+        __atomic_store_n(sq_tail_, tail + 1U, __ATOMIC_RELEASE);
+        ++unsubmitted_;
+        if (!submit_locked()) wake_reaper();
+    }
+
+    // Without SQPOLL the kernel consumes SQEs inside this call. False if it left some behind
+    // (EAGAIN / EBUSY: out of resources, or completions it has yet to post).
+    bool submit_locked() {
+        for (;;) {
+            const long n = ::syscall(__NR_io_uring_enter, ring_fd_, unsubmitted_, 0U, 0U, nullptr, 0);
+            if (n >= 0) {
+                unsubmitted_ -= std::min(unsubmitted_, static_cast<unsigned>(n));
+                return unsubmitted_ == 0U;
+            }
+            if (errno != EINTR) return false;
+        }
+    }
+
+    void wake_reaper() noexcept {
+        const std::uint64_t one = 1U;
+        (void)::write(wake_fd_, &one, sizeof(one));
+    }
+
+    void reap_loop() {
+        struct Completion {
+            std::uint64_t user_data;
+            std::int32_t res;
+        };
+        std::vector<Completion> batch;
+        for (;;) {
+            bool stalled = false;
+            {
+                std::lock_guard<std::mutex> lock(sq_mutex_);
+                if (stopping_ && in_flight_ == 0U) break;
+                stalled = unsubmitted_ != 0U && !submit_locked();
+            }
+            // While the kernel refuses SQEs, retry after a short pause; otherwise sleep until a
+            // CQE is posted or a refused submission wakes us.
+            pollfd fds[2] = {{ring_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+            const int rc = ::poll(fds, 2U, stalled ? kRetryMs : -1);
+            if (rc < 0 && errno != EINTR) break;
+            if ((fds[1].revents & POLLIN) != 0) {
+                std::uint64_t value = 0;
+                (void)::read(wake_fd_, &value, sizeof(value));
+            }
+
+            // Copy the CQEs out and free their slots before handling them: handling resubmits.
+            unsigned head = *cq_head_;
+            const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            batch.clear();
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                batch.push_back(Completion{cqe.user_data, cqe.res});
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+            for (const auto& c : batch) complete(reinterpret_cast<FileRequest*>(c.user_data), c.res);
+        }
+    }
+
+    void complete(FileRequest* r, std::int32_t res) {
+        if (res == -EINTR || res == -EAGAIN) {
+            std::lock_guard<std::mutex> lock(sq_mutex_);
+            push_locked(r);
+            return;
+        }
+        std::error_code ec;
+        if (res < 0) {
+            ec = errno_code(-res);
+        } else if (r->kind == FileOpKind::kRead || r->kind == FileOpKind::kWrite) {
+            r->done += static_cast<std::size_t>(res);
+            if (res > 0 && r->done < r->size) {  // short transfer: continue; 0 is end of file
+                std::lock_guard<std::mutex> lock(sq_mutex_);
+                push_locked(r);
+                return;
+            }
+        }
+        finish(std::unique_ptr<FileRequest>(r), ec);
+
+        std::lock_guard<std::mutex> lock(sq_mutex_);
+        --in_flight_;
+        if (!backlog_.empty() && !stopping_) {
+            ++in_flight_;
+            push_locked(backlog_.front().release());
+            backlog_.pop_front();
+        }
+    }
+
+    int ring_fd_ = -1;
+    int wake_fd_ = -1;
+    std::error_code setup_error_;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sq_bytes_ = 0;
+    std::size_t cq_bytes_ = 0;
+    std::size_t sqes_bytes_ = 0;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::mutex sq_mutex_;
+    unsigned capacity_ = 0;
+    unsigned in_flight_ = 0;    // guarded by sq_mutex_
+    unsigned unsubmitted_ = 0;  // guarded by sq_mutex_
+    bool stopping_ = false;     // guarded by sq_mutex_
+    std::deque<std::unique_ptr<FileRequest>> backlog_;
+    std::thread reaper_;
+};
+
+// ---------------------------------------------------------------------------------------------
+// Thread-pool backend: blocking syscalls on dedicated threads, never on the IO pool.
+class ThreadPoolFileIo final : public FileIoService {
+public:
+    ThreadPoolFileIo(Deliver deliver, std::shared_ptr<detail::FileBufferPool> pool, std::size_t threads)
+        : FileIoService(std::move(deliver), std::move(pool)) {
+        threads_.reserve(std::max<std::size_t>(threads, 1U));
+        for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1U); ++i) {
+            threads_.emplace_back([this, i]() {
+                Tracer::set_thread_name("sx-file-" + std::to_string(i));
+                worker_loop();
+            });
+        }
+    }
+    ~ThreadPoolFileIo() override { shutdown(); }
+
+    ThreadPoolFileIo(const ThreadPoolFileIo&) = delete;
+    ThreadPoolFileIo& operator=(const ThreadPoolFileIo&) = delete;
+    ThreadPoolFileIo(ThreadPoolFileIo&&) = delete;
+    ThreadPoolFileIo& operator=(ThreadPoolFileIo&&) = delete;
+
+    [[nodiscard]] FileIoBackend backend() const noexcept override { return FileIoBackend::kThreadPool; }
+
+    void shutdown() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            queue_.clear();
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+protected:
+    void submit(std::unique_ptr<FileRequest> request) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) return;
+            queue_.push_back(std::move(request));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void worker_loop() {
+        for (;;) {
+            std::unique_ptr<FileRequest> request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) return;
+                request = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            const std::error_code ec = perform(*request);
+            finish(std::move(request), ec);
+        }
+    }
+
+    static std::error_code perform(FileRequest& r) {
+        if (r.kind == FileOpKind::kFsync) return ::fsync(r.fd) == 0 ? std::error_code{} : last_errno();
+        if (r.kind == FileOpKind::kFdatasync) return ::fdatasync(r.fd) == 0 ? std::error_code{} : last_errno();
+        while (r.done < r.size) {
+            const std::size_t len = std::min(r.size - r.done, kMaxTransfer);
+            const auto off = static_cast<off_t>(r.offset + r.done);
+            const ssize_t n = r.kind == FileOpKind::kRead ? ::pread(r.fd, r.data + r.done, len, off)
+                                                          : ::pwrite(r.fd, r.data + r.done, len, off);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return last_errno();
+            }
+            if (n == 0) break;
+            r.done += static_cast<std::size_t>(n);
+        }
+        return {};
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::deque<std::unique_ptr<FileRequest>> queue_;
+    std::vector<std::thread> threads_;
+};
+
+}  // namespace
+
+std::unique_ptr<FileIoService> FileIoService::create(const FileIoOptions& options, Deliver deliver) {
+    std::shared_ptr<detail::FileBufferPool> pool;
+    if (options.registered_buffers > 0U) {
+        pool = std::make_shared<detail::FileBufferPool>(options.registered_buffers, options.registered_buffer_size);
+    }
+    if (options.backend != FileIoBackend::kThreadPool) {
+        auto uring = std::make_unique<UringFileIo>(deliver, pool);
+        if (uring->open(options.queue_depth) || options.backend == FileIoBackend::kIoUring) return uring;
+    }
+    return std::make_unique<ThreadPoolFileIo>(std::move(deliver), std::move(pool), options.fallback_threads);
+}
+
+}  // namespace sx::infra
@@ -0,0 +1,129 @@
+/**
+ * @file file_io_service.h
+ * @brief Asynchronous file I/O engines behind AsyncRuntime::async_read/async_write (private header)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+#include "sx/infra/executor.h"
+#include "sx/infra/file_io.h"
+#include "sx/utils/task.h"
+
+namespace sx::infra {
+
+namespace detail {
+
+// Page-aligned buffers for FileBuffer leases. Outlives the engine that created it while any
+// lease is alive, so a buffer kept across stop() stays valid (it is just no longer registered).
+class FileBufferPool : public std::enable_shared_from_this<FileBufferPool> {
+public:
+    FileBufferPool(std::size_t count, std::size_t size);
+    ~FileBufferPool();
+
+    // Empty buffer when all are leased.
+    FileBuffer acquire();
+    void release(int slot) noexcept;
+
+    [[nodiscard]] std::size_t count() const noexcept { return buffers_.size(); }
+    [[nodiscard]] std::size_t buffer_size() const noexcept { return size_; }
+    [[nodiscard]] std::byte* buffer(std::size_t slot) const noexcept { return buffers_[slot]; }
+
+    // Set once the io_uring engine registered every buffer; slots are then registration indices.
+    void set_registered(bool registered) noexcept { registered_ = registered; }
+    [[nodiscard]] bool registered() const noexcept { return registered_; }
+
+    FileBufferPool(const FileBufferPool&) = delete;
+    FileBufferPool& operator=(const FileBufferPool&) = delete;
+    FileBufferPool(FileBufferPool&&) = delete;
+    FileBufferPool& operator=(FileBufferPool&&) = delete;
+
+private:
+    std::size_t size_;
+    std::vector<std::byte*> buffers_;
+    bool registered_ = false;
+
+    std::mutex mutex_;
+    std::vector<int> free_;
+};
+
+}  // namespace detail
+
+enum class FileOpKind : std::uint8_t { kRead, kWrite, kFsync, kFdatasync };
+
+// One queued operation; owned by the engine until its callback has been handed to an executor.
+struct FileRequest {
+    FileOpKind kind = FileOpKind::kRead;
+    int fd = -1;
+    std::byte* data = nullptr;
+    std::size_t size = 0;
+    std::uint64_t offset = 0;
+    int buf_index = -1;    // registered buffer, for READ_FIXED / WRITE_FIXED
+    std::size_t done = 0;  // bytes transferred so far; short transfers are continued
+    FileIoCallback callback;
+    std::shared_ptr<IExecutor> executor;  // null: the runtime's IO pool
+};
+
+// Runs file operations off the IO pool and hands each completion to an executor. Submission
+// never blocks on the disk. shutdown() drops operations that have not started and waits for
+// those the kernel (or a fallback thread) is already working on, so their buffers are no
+// longer touched once it returns. Dropped operations get no callback; the callbacks of those
+// that finish meanwhile are handed to their executor, which drops them too when it is the
+// stopping IO pool.
+class FileIoService {
+public:
+    // Hands a completion to `executor`, or to the IO pool when it is null.
+    using Deliver = std::function<void(const std::shared_ptr<IExecutor>& executor, sx::utils::Task task)>;
+
+    // Picks the backend from options.backend; kAuto falls back to the thread pool when the
+    // kernel refuses io_uring.
+    static std::unique_ptr<FileIoService> create(const FileIoOptions& options, Deliver deliver);
+
+    virtual ~FileIoService() = default;
+
+    void read(int fd, void* data, std::size_t size, std::uint64_t offset, FileIoCallback callback,
+              std::shared_ptr<IExecutor> executor);
+    void write(int fd, const void* data, std::size_t size, std::uint64_t offset, FileIoCallback callback,
+               std::shared_ptr<IExecutor> executor);
+    void read(int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset, FileIoCallback callback,
+              std::shared_ptr<IExecutor> executor);
+    void write(int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset, FileIoCallback callback,
+               std::shared_ptr<IExecutor> executor);
+    void sync(int fd, bool data_only, FileIoCallback callback, std::shared_ptr<IExecutor> executor);
+
+    [[nodiscard]] FileBuffer acquire_buffer();
+
+    [[nodiscard]] virtual FileIoBackend backend() const noexcept = 0;
+    virtual void shutdown() = 0;
+
+    FileIoService(const FileIoService&) = delete;
+    FileIoService& operator=(const FileIoService&) = delete;
+    FileIoService(FileIoService&&) = delete;
+    FileIoService& operator=(FileIoService&&) = delete;
+
+protected:
+    FileIoService(Deliver deliver, std::shared_ptr<detail::FileBufferPool> pool)
+        : deliver_(std::move(deliver)), pool_(std::move(pool)) {}
+
+    virtual void submit(std::unique_ptr<FileRequest> request) = 0;
+    // Delivers the callback with `ec` and request->done.
+    void finish(std::unique_ptr<FileRequest> request, std::error_code ec);
+
+    Deliver deliver_;
+    std::shared_ptr<detail::FileBufferPool> pool_;
+
+private:
+    void submit_data(FileOpKind kind, int fd, std::byte* data, std::size_t size, std::uint64_t offset,
+                     FileIoCallback callback, std::shared_ptr<IExecutor> executor, int buf_index = -1);
+    void submit_buffer(FileOpKind kind, int fd, const FileBuffer& buffer, std::size_t size, std::uint64_t offset,
+                       FileIoCallback callback, std::shared_ptr<IExecutor> executor);
+};
+
+}  // namespace sx::infra
@@ -6,13 +6,37 @@
 #include "sx/infra/infra_service.h"
 
 #include <cassert>
+#include <utility>
 
+#include "sx/hal/cpu_topology.h"
+#include "sx/hal/linux_thread_scheduler.h"
 #include "sx/infra/async_runtime.h"
 #include "sx/infra/config_manager.h"
 #include "sx/infra/unified_bus.h"
 
 namespace sx::infra {
 
+namespace {
+
+std::error_code make_placed_scheduler(const sx::hal::PlacementPolicy& policy, sx::hal::PlacementPlan& plan,
+                                      std::shared_ptr<sx::hal::IThreadScheduler>& out) {
+    sx::hal::CpuTopology topology;
+    if (const auto ec = topology.load()) return ec;
+
+    sx::hal::PlacementPolicy effective = policy;
+    if (effective.allowed_cpus.empty()) effective.allowed_cpus = sx::hal::LinuxThreadScheduler::current_affinity();
+    plan = sx::hal::plan_placement(topology, effective);
+
+    sx::hal::LinuxSchedulerConfig config;
+    plan.apply(config);
+    auto scheduler = std::make_shared<sx::hal::LinuxThreadScheduler>(std::move(config));
+    if (const auto ec = scheduler->init()) return ec;
+    out = std::move(scheduler);
+    return {};
+}
+
+}  // namespace
+
 InfraService::InfraService() = default;
 InfraService::~InfraService() { shutdown(); }
 
@@ -54,8 +78,26 @@ std::error_code InfraService::init(const InfraConfig& cfg) {
     }
 
     // 2) Runtime
+    std::shared_ptr<sx::hal::IThreadScheduler> scheduler = cfg_.scheduler;
+    placement_ = {};
+    if (!scheduler && cfg_.placement.enabled) {
+        if (const auto ec = make_placed_scheduler(cfg_.placement, placement_, scheduler)) {
+            cleanup_on_error();
+            return ec;
+        }
+    }
     if (!runtime_) runtime_ = std::make_unique<AsyncRuntime>();
-    runtime_->init(cfg_.scheduler, cfg_.io_threads, cfg_.cpu_threads);
+    if (cfg_.watchdog.enabled && cfg_.enable_logging) {
+        runtime_->set_stall_handler([logger = logging_->get_logger("watchdog")](const StallReport& report) {
+            logger->warn(to_string(report));
+        });
+    }
+    RuntimeOptions runtime_options;
+    runtime_options.io_threads = cfg_.io_threads;
+    runtime_options.cpu_threads = cfg_.cpu_threads;
+    runtime_options.cpu_pool = cfg_.cpu_pool;
+    runtime_options.watchdog = cfg_.watchdog;
+    runtime_->init(std::move(scheduler), runtime_options);
 
     // 3) Config (optional)
     if (!cfg_.config_path.empty()) {
@@ -0,0 +1,52 @@
+/**
+ * @file loop_rate.cpp
+ * @brief LoopRate / sleep_until implementation (Linux clock_nanosleep)
+ */
+
+#include "sx/infra/loop_rate.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+
+namespace sx::infra {
+
+void sleep_until(std::chrono::steady_clock::time_point deadline) noexcept {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    if (ns <= 0) return;
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    // Absolute sleeps can simply be restarted after EINTR.
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
+
+LoopRate::LoopRate(std::chrono::nanoseconds period) noexcept
+    : period_(std::max(period, std::chrono::nanoseconds{1})) {
+    reset();
+}
+
+void LoopRate::reset() noexcept {
+    next_ = Clock::now() + period_;
+    cycles_ = 0;
+    overruns_ = 0;
+}
+
+bool LoopRate::sleep() noexcept {
+    ++cycles_;
+    uint64_t skipped = 0;
+    const auto now = Clock::now();
+    if (now >= next_) {
+        // Overran: drop the missed deadlines and stay on the original grid.
+        const auto late = std::chrono::duration_cast<std::chrono::nanoseconds>(now - next_);
+        skipped = static_cast<uint64_t>(late.count() / period_.count()) + 1U;
+        overruns_ += skipped;
+        next_ += period_ * static_cast<int64_t>(skipped);
+    }
+    sleep_until(next_);
+    next_ += period_;
+    return skipped == 0U;
+}
+
+}  // namespace sx::infra
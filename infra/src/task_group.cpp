@@ -0,0 +1,28 @@
+/**
+ * @file task_group.cpp
+ * @brief TaskGroup implementation
+ */
+
+#include "sx/infra/task_group.h"
+
+namespace sx::infra {
+
+TaskGroup::TaskGroup(AsyncRuntime& runtime)
+    : runtime_(runtime), state_(std::make_shared<detail::TaskGroupState>()) {
+    runtime_.register_task_group(state_);
+}
+
+TaskGroup::~TaskGroup() { cancel(); }
+
+void TaskGroup::cancel() noexcept { state_->cancelled.store(true, std::memory_order_release); }
+
+void TaskGroup::wait() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->cv.wait(lock, [this]() { return state_->idle_locked(); });
+}
+
+bool TaskGroup::wait_for(std::chrono::nanoseconds timeout) {
+    return state_->wait_until(std::chrono::steady_clock::now() + timeout);
+}
+
+}  // namespace sx::infra
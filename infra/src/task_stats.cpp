@@ -0,0 +1,188 @@
+/**
+ * @file task_stats.cpp
+ * @brief Task instrumentation and RuntimeMetrics snapshots
+ */
+
+#include "task_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace sx::infra {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+thread_local WorkerSlot* t_worker_slot = nullptr;
+
+uint64_t elapsed_ns(Clock::time_point from, Clock::time_point to) noexcept {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+    return ns > 0 ? static_cast<uint64_t>(ns) : 0U;
+}
+
+std::size_t bucket_of(uint64_t ns) noexcept {
+    if (ns == 0U) return 0U;
+    const auto width = static_cast<std::size_t>(64 - __builtin_clzll(ns));
+    return std::min(width, LatencyHistogram::kBuckets - 1U);
+}
+
+}  // namespace
+
+std::chrono::nanoseconds LatencyHistogram::mean() const noexcept {
+    if (count == 0U) return std::chrono::nanoseconds{0};
+    return std::chrono::nanoseconds{static_cast<int64_t>(sum_ns / count)};
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double q) const noexcept {
+    if (count == 0U) return std::chrono::nanoseconds{0};
+    const double clamped = std::clamp(q, 0.0, 1.0);
+    const auto target = std::max<uint64_t>(1U, static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+        seen += buckets[b];
+        if (seen >= target) {
+            const uint64_t upper = b == 0U ? 0U : (uint64_t{1} << b) - 1U;
+            return std::chrono::nanoseconds{static_cast<int64_t>(std::min(upper, max_ns))};
+        }
+    }
+    return std::chrono::nanoseconds{static_cast<int64_t>(max_ns)};
+}
+
+void AtomicHistogram::record(uint64_t ns) noexcept {
+    buckets_[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t prev = max_ns_.load(std::memory_order_relaxed);
+    while (prev < ns && !max_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram AtomicHistogram::snapshot() const noexcept {
+    LatencyHistogram out;
+    for (std::size_t b = 0; b < out.buckets.size(); ++b) {
+        out.buckets[b] = buckets_[b].load(std::memory_order_relaxed);
+        out.count += out.buckets[b];
+    }
+    out.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+    out.max_ns = max_ns_.load(std::memory_order_relaxed);
+    return out;
+}
+
+TaskMetrics TaskStats::snapshot() const noexcept {
+    TaskMetrics out;
+    out.completed = completed.load(std::memory_order_acquire);
+    out.started = started.load(std::memory_order_acquire);
+    out.posted = posted.load(std::memory_order_acquire);
+    out.queue_delay = queue_delay.snapshot();
+    out.run_time = run_time.snapshot();
+    return out;
+}
+
+PoolStats::PoolStats(std::size_t worker_count, Clock::time_point now) : started_at(now) {
+    workers.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        workers.push_back(std::make_unique<WorkerSlot>());
+        workers.back()->owner = this;
+    }
+}
+
+void PoolStats::bind_current_thread(std::size_t index) noexcept {
+    t_worker_slot = index < workers.size() ? workers[index].get() : nullptr;
+}
+
+PoolMetrics PoolStats::snapshot(Clock::time_point now) const {
+    PoolMetrics out;
+    out.tasks = tasks.snapshot();
+    const uint64_t uptime = elapsed_ns(started_at, now);
+    out.uptime = std::chrono::nanoseconds{static_cast<int64_t>(uptime)};
+    out.workers.reserve(workers.size());
+    for (const auto& slot : workers) {
+        WorkerMetrics worker;
+        const uint64_t busy = slot->busy_ns.load(std::memory_order_relaxed);
+        worker.busy = std::chrono::nanoseconds{static_cast<int64_t>(busy)};
+        worker.busy_ratio = uptime == 0U ? 0.0 : std::min(1.0, static_cast<double>(busy) / static_cast<double>(uptime));
+        out.workers.push_back(worker);
+    }
+    return out;
+}
+
+RuntimeStats::RuntimeStats(std::size_t io_n, std::size_t cpu_n)
+    : io(io_n, Clock::now()), cpu(cpu_n, io.started_at) {}
+
+std::shared_ptr<TaskStats> RuntimeStats::register_strand(std::string name) {
+    auto stats = std::make_unique<TaskStats>();
+    // The handle shares ownership of a token and points at the registry's counters.
+    auto token = std::make_shared<char>();
+    std::shared_ptr<TaskStats> handle(token, stats.get());
+    std::lock_guard<std::mutex> lock(strands_mutex);
+    strands.push_back(Strand{std::move(name), std::move(stats), token});
+    return handle;
+}
+
+RuntimeMetrics RuntimeStats::snapshot() {
+    RuntimeMetrics out;
+    out.enabled = true;
+    const auto now = Clock::now();
+    out.io = io.snapshot(now);
+    out.cpu = cpu.snapshot(now);
+
+    std::lock_guard<std::mutex> lock(strands_mutex);
+    auto live = strands.begin();
+    for (auto& entry : strands) {
+        if (!entry.handle.expired()) {
+            out.strands.push_back(StrandMetrics{entry.name, entry.stats->snapshot()});
+        } else {
+            // Pairs with the handle's last release: every post made through it is visible.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.stats->completed.load(std::memory_order_acquire) ==
+                entry.stats->posted.load(std::memory_order_relaxed)) {
+                continue;  // nothing can post to it any more, and no task of it is left
+            }
+        }
+        if (&*live != &entry) *live = std::move(entry);
+        ++live;
+    }
+    strands.erase(live, strands.end());
+    return out;
+}
+
+sx::utils::Task meter_task(sx::utils::Task task, PoolStats* pool, TaskStats* strand) {
+    pool->tasks.posted.fetch_add(1, std::memory_order_relaxed);
+    if (strand != nullptr) strand->posted.fetch_add(1, std::memory_order_relaxed);
+
+    return [task = std::move(task), pool, strand, posted_at = Clock::now()]() mutable {
+        const auto start = Clock::now();
+        const uint64_t delay = elapsed_ns(posted_at, start);
+        pool->tasks.started.fetch_add(1, std::memory_order_release);
+        pool->tasks.queue_delay.record(delay);
+        if (strand != nullptr) {
+            strand->started.fetch_add(1, std::memory_order_release);
+            strand->queue_delay.record(delay);
+        }
+
+        // Recorded on unwind too: a throwing task still completes. `completed` is the last
+        // access to the strand counters, which snapshot() relies on to drop them.
+        struct Finish {
+            PoolStats* pool;
+            TaskStats* strand;
+            Clock::time_point start;
+            ~Finish() {
+                const uint64_t run = elapsed_ns(start, Clock::now());
+                pool->tasks.run_time.record(run);
+                pool->tasks.completed.fetch_add(1, std::memory_order_release);
+                WorkerSlot* slot = t_worker_slot;
+                if (slot != nullptr && slot->owner == pool) slot->busy_ns.fetch_add(run, std::memory_order_relaxed);
+                if (strand != nullptr) {
+                    strand->run_time.record(run);
+                    strand->completed.fetch_add(1, std::memory_order_release);
+                }
+            }
+        } finish{pool, strand, start};
+
+        if (task) task();
+    };
+}
+
+}  // namespace sx::infra
@@ -0,0 +1,107 @@
+/**
+ * @file task_stats.h
+ * @brief Lock-free task instrumentation behind AsyncRuntime::metrics() (private header)
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sx/infra/runtime_metrics.h"
+#include "sx/utils/task.h"
+
+namespace sx::infra {
+
+// Writers only do relaxed fetch_add / CAS-max, so recording never blocks.
+class AtomicHistogram {
+public:
+    void record(uint64_t ns) noexcept;
+    [[nodiscard]] LatencyHistogram snapshot() const noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, LatencyHistogram::kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+};
+
+struct TaskStats {
+    std::atomic<uint64_t> posted{0};
+    std::atomic<uint64_t> started{0};
+    std::atomic<uint64_t> completed{0};
+    AtomicHistogram queue_delay;
+    AtomicHistogram run_time;
+
+    [[nodiscard]] TaskMetrics snapshot() const noexcept;
+};
+
+struct PoolStats;
+
+struct alignas(64) WorkerSlot {
+    const PoolStats* owner = nullptr;
+    std::atomic<uint64_t> busy_ns{0};
+};
+
+struct PoolStats {
+    TaskStats tasks;
+    std::chrono::steady_clock::time_point started_at;
+    std::vector<std::unique_ptr<WorkerSlot>> workers;
+
+    PoolStats(std::size_t worker_count, std::chrono::steady_clock::time_point now);
+
+    // Called first thing inside worker `index`, so its run time is charged to that worker.
+    void bind_current_thread(std::size_t index) noexcept;
+
+    [[nodiscard]] PoolMetrics snapshot(std::chrono::steady_clock::time_point now) const;
+};
+
+// Allocated by init() when RuntimeOptions::enable_metrics is set, and shared with the
+// executors created from the runtime so they can outlive it.
+struct RuntimeStats {
+    // The registry owns the counters; the executor only holds a handle. Metered tasks point at
+    // the counters without owning them, so an entry is dropped only once its handle is gone
+    // and every posted task has completed (tasks discarded by stop() keep it until the end).
+    struct Strand {
+        std::string name;
+        std::unique_ptr<TaskStats> stats;
+        std::weak_ptr<const void> handle;
+    };
+
+    PoolStats io;
+    PoolStats cpu;
+
+    std::mutex strands_mutex;
+    std::vector<Strand> strands;
+
+    RuntimeStats(std::size_t io_n, std::size_t cpu_n);
+
+    std::shared_ptr<TaskStats> register_strand(std::string name);
+    [[nodiscard]] RuntimeMetrics snapshot();
+};
+
+// Counts `task` as posted now and returns it wrapped to record its delay and run time. The
+// wrapper holds plain pointers: the runtime keeps every RuntimeStats it created, and with it
+// the strand counters, until it is destroyed, and no task runs after that.
+[[nodiscard]] sx::utils::Task meter_task(sx::utils::Task task, PoolStats* pool, TaskStats* strand);
+
+// What an executor needs to instrument its tasks; empty when metrics are off.
+struct StatsHook {
+    std::shared_ptr<RuntimeStats> runtime;
+    PoolStats* pool = nullptr;  // owned by `runtime`
+    std::shared_ptr<TaskStats> strand;
+
+    [[nodiscard]] sx::utils::Task wrap(sx::utils::Task task) const {
+        if (pool == nullptr) return task;
+        return meter_task(std::move(task), pool, strand.get());
+    }
+};
+
+}  // namespace sx::infra
@@ -0,0 +1,216 @@
+/**
+ * @file timing_wheel.cpp
+ * @brief TimingWheel implementation
+ */
+
+#include "timing_wheel.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace sx::infra {
+
+TimingWheel::TimingWheel(asio::io_context& io, std::chrono::nanoseconds tick)
+    : io_(io), tick_(std::max(tick, std::chrono::nanoseconds{1})), origin_(Clock::now()) {
+    for (auto& level : slots_) {
+        for (auto& head : level) head.prev = head.next = &head;
+    }
+    strand_.emplace(asio::make_strand(io_));
+    tick_timer_.emplace(*strand_);
+}
+
+uint64_t TimingWheel::tick_of(Clock::time_point t, bool round_up) const noexcept {
+    if (t <= origin_) return 0;
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(t - origin_).count();
+    return static_cast<uint64_t>((elapsed + (round_up ? tick_.count() - 1 : 0)) / tick_.count());
+}
+
+void TimingWheel::link_locked(Node& node) {
+    const uint64_t expiry = std::max(node.expiry_tick, next_tick_);
+    const uint64_t delta = expiry - next_tick_;
+
+    std::size_t level = 0;
+    while (level + 1U < kLevels && delta >= (uint64_t{1} << (kLevelBits * (level + 1U)))) ++level;
+    // Beyond the top level: park in the farthest slot; cascading re-links it later.
+    const uint64_t target = level + 1U == kLevels
+                                ? std::min(expiry, next_tick_ + (uint64_t{1} << (kLevelBits * kLevels)) - 1U)
+                                : expiry;
+    Node& head = slots_[level][static_cast<std::size_t>(target >> (kLevelBits * level)) & (kSlots - 1U)];
+
+    node.prev = head.prev;
+    node.next = &head;
+    head.prev->next = &node;
+    head.prev = &node;
+}
+
+void TimingWheel::unlink(Node& node) noexcept {
+    if (node.next == nullptr) return;
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    node.prev = node.next = nullptr;
+}
+
+// Re-links every node of one higher-level slot; returns the slot index that was cascaded.
+std::size_t TimingWheel::cascade_locked(std::size_t level) {
+    const std::size_t index = static_cast<std::size_t>(next_tick_ >> (kLevelBits * level)) & (kSlots - 1U);
+    Node& head = slots_[level][index];
+    Node* node = head.next;
+    head.prev = head.next = &head;
+    while (node != &head) {
+        Node* next = node->next;
+        node->prev = node->next = nullptr;
+        link_locked(*node);
+        node = next;
+    }
+    return index;
+}
+
+void TimingWheel::advance_locked(uint64_t until, std::vector<Callback>& due) {
+    while (next_tick_ <= until && armed_ > 0U) {
+        const std::size_t index = static_cast<std::size_t>(next_tick_) & (kSlots - 1U);
+        if (index == 0U) {
+            for (std::size_t level = 1; level < kLevels && cascade_locked(level) == 0U; ++level) {
+            }
+        }
+
+        Node& head = slots_[0][index];
+        while (head.next != &head) {
+            Node* node = head.next;
+            unlink(*node);
+            due.push_back(std::move(node->callback));
+            node->callback = nullptr;
+            --armed_;
+        }
+        ++next_tick_;
+    }
+    // Nothing armed: jump straight to the present instead of walking idle ticks later.
+    if (armed_ == 0U) next_tick_ = std::max(next_tick_, until + 1U);
+}
+
+void TimingWheel::schedule_locked() {
+    const std::chrono::nanoseconds due = tick_ * static_cast<int64_t>(next_tick_);
+    tick_timer_->expires_at(origin_ + std::chrono::duration_cast<Clock::duration>(due));
+    tick_timer_->async_wait(
+        [self = shared_from_this()](const std::error_code& ec) { self->on_tick(ec); });
+}
+
+void TimingWheel::on_tick(const std::error_code& ec) {
+    if (ec == asio::error::operation_aborted) return;
+
+    std::vector<Callback> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shut_down_) return;
+        advance_locked(tick_of(Clock::now(), /*round_up=*/false), due);
+        if (armed_ == 0U) {
+            ticking_ = false;
+        } else {
+            schedule_locked();
+        }
+    }
+    for (auto& cb : due) {
+        if (cb) cb(std::error_code{});
+    }
+}
+
+void TimingWheel::abort_locked(Node& node, Callback& dropped) {
+    if (!node.callback) return;
+    unlink(node);
+    --armed_;
+    if (shut_down_) {
+        dropped = std::move(node.callback);
+    } else {
+        asio::post(io_, [cb = std::move(node.callback)]() { cb(asio::error::operation_aborted); });
+    }
+    node.callback = nullptr;
+}
+
+void TimingWheel::arm(Node& node, Callback callback) {
+    Callback dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    abort_locked(node, dropped);
+    if (shut_down_ || !callback) return;
+
+    if (armed_ == 0U) next_tick_ = std::max(next_tick_, tick_of(Clock::now(), /*round_up=*/false));
+    node.expiry_tick = tick_of(node.expiry, /*round_up=*/true);
+    node.callback = std::move(callback);
+    link_locked(node);
+    ++armed_;
+
+    if (!ticking_) {
+        ticking_ = true;
+        asio::post(*strand_, [self = shared_from_this()]() {
+            std::lock_guard<std::mutex> l(self->mutex_);
+            if (self->shut_down_) return;
+            if (self->armed_ == 0U) {
+                self->ticking_ = false;
+                return;
+            }
+            self->schedule_locked();
+        });
+    }
+}
+
+void TimingWheel::cancel(Node& node) {
+    Callback dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    abort_locked(node, dropped);
+}
+
+void TimingWheel::detach(Node& node) {
+    Callback dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!node.callback) return;
+    unlink(node);
+    --armed_;
+    dropped = std::move(node.callback);
+    node.callback = nullptr;
+}
+
+void TimingWheel::shutdown() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shut_down_ = true;
+    ticking_ = false;
+    tick_timer_.reset();
+    strand_.reset();
+}
+
+namespace {
+
+class WheelTimer final : public ITimer {
+public:
+    explicit WheelTimer(std::shared_ptr<TimingWheel> wheel) : wheel_(std::move(wheel)) {
+        node_.expiry = TimingWheel::Clock::now();
+    }
+
+    ~WheelTimer() override { wheel_->detach(node_); }
+
+    WheelTimer(const WheelTimer&) = delete;
+    WheelTimer& operator=(const WheelTimer&) = delete;
+    WheelTimer(WheelTimer&&) = delete;
+    WheelTimer& operator=(WheelTimer&&) = delete;
+
+    // As with asio timers, changing the expiry aborts a pending wait.
+    void expires_after(std::chrono::milliseconds timeout) override {
+        wheel_->cancel(node_);
+        node_.expiry = TimingWheel::Clock::now() + timeout;
+    }
+
+    void async_wait(std::function<void(const std::error_code&)> callback) override {
+        wheel_->arm(node_, std::move(callback));
+    }
+
+    void cancel() override { wheel_->cancel(node_); }
+
+private:
+    std::shared_ptr<TimingWheel> wheel_;
+    TimingWheel::Node node_;
+};
+
+}  // namespace
+
+std::shared_ptr<ITimer> make_wheel_timer(std::shared_ptr<TimingWheel> wheel) {
+    return std::make_shared<WheelTimer>(std::move(wheel));
+}
+
+}  // namespace sx::infra
@@ -0,0 +1,94 @@
+/**
+ * @file timing_wheel.h
+ * @brief Hierarchical timing wheel behind AsyncRuntime::create_wheel_timer() (private header)
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <vector>
+
+#include <asio.hpp>
+
+#include "sx/infra/async_runtime.h"
+
+namespace sx::infra {
+
+// Four levels of 256 slots, each slot an intrusive doubly-linked list, so arm, re-arm and
+// cancel are O(1). Level 0 holds timers due within 256 ticks; higher levels are cascaded
+// down one slot at a time as the lower level wraps (the classic Linux timer-wheel scheme).
+// One asio::steady_timer drives the wheel on the IO pool, and only while timers are armed.
+class TimingWheel : public std::enable_shared_from_this<TimingWheel> {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void(const std::error_code&)>;
+
+    struct Node {
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        uint64_t expiry_tick = 0;
+        Clock::time_point expiry;
+        Callback callback;  // non-empty while armed
+    };
+
+    TimingWheel(asio::io_context& io, std::chrono::nanoseconds tick);
+
+    // Arms `node` with `callback`; a pending wait on the node is aborted first.
+    void arm(Node& node, Callback callback);
+    // Aborts a pending wait: its callback is posted with asio::error::operation_aborted.
+    void cancel(Node& node);
+    // Like cancel(), but the callback is dropped (owner is going away).
+    void detach(Node& node);
+
+    // Called once the IO threads are joined. Pending callbacks are dropped.
+    void shutdown();
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+    TimingWheel(TimingWheel&&) = delete;
+    TimingWheel& operator=(TimingWheel&&) = delete;
+    ~TimingWheel() = default;
+
+private:
+    static constexpr unsigned kLevelBits = 8U;
+    static constexpr std::size_t kSlots = std::size_t{1} << kLevelBits;
+    static constexpr std::size_t kLevels = 4U;
+
+    // Expiries round up and "now" rounds down, so a timer never fires early.
+    [[nodiscard]] uint64_t tick_of(Clock::time_point t, bool round_up) const noexcept;
+    void link_locked(Node& node);
+    static void unlink(Node& node) noexcept;
+    std::size_t cascade_locked(std::size_t level);
+    void advance_locked(uint64_t until, std::vector<Callback>& due);
+    void schedule_locked();
+    void on_tick(const std::error_code& ec);
+    // Callbacks are handed back to the caller so they are destroyed outside mutex_: a
+    // callback may own another timer whose destructor takes mutex_.
+    void abort_locked(Node& node, Callback& dropped);
+
+    asio::io_context& io_;
+    const std::chrono::nanoseconds tick_;
+    const Clock::time_point origin_;
+
+    std::mutex mutex_;
+    std::array<std::array<Node, kSlots>, kLevels> slots_;  // list sentinels
+    uint64_t next_tick_ = 0;                              // next tick to process
+    std::size_t armed_ = 0;
+    bool ticking_ = false;
+    bool shut_down_ = false;
+
+    std::optional<asio::strand<asio::io_context::executor_type>> strand_;
+    std::optional<asio::steady_timer> tick_timer_;  // strand only
+};
+
+// ITimer handle on `wheel`. Destroying the handle cancels it without running its callback.
+std::shared_ptr<ITimer> make_wheel_timer(std::shared_ptr<TimingWheel> wheel);
+
+}  // namespace sx::infra
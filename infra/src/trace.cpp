@@ -0,0 +1,343 @@
+/**
+ * @file trace.cpp
+ * @brief Tracer: per-thread event rings and Chrome trace JSON export
+ */
+
+#include "sx/infra/trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace sx::infra {
+
+namespace {
+
+enum class EventKind : std::uint8_t { kComplete, kInstant, kFlowBegin };
+
+struct TraceEvent {
+    const char* name = nullptr;
+    const char* category = nullptr;
+    std::uint64_t ts_ns = 0;
+    std::uint64_t dur_ns = 0;
+    std::uint64_t flow = 0;
+    EventKind kind = EventKind::kComplete;
+    char detail[Tracer::kDetailSize] = {};
+};
+
+// A ring slot is a seqlock: `seq` is 2 * index + 1 while event `index` is being written and
+// 2 * index + 2 once it is complete. The fields are relaxed atomics so the exporter may read a
+// slot the writer is lapping; it keeps the copy only if `seq` did not move meanwhile.
+struct TraceSlot {
+    std::atomic<std::uint64_t> seq{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<std::uint64_t> ts_ns{0};
+    std::atomic<std::uint64_t> dur_ns{0};
+    std::atomic<std::uint64_t> flow{0};
+    std::atomic<EventKind> kind{EventKind::kComplete};
+    std::atomic<std::uint64_t> detail[Tracer::kDetailSize / sizeof(std::uint64_t)] = {};
+};
+static_assert(Tracer::kDetailSize % sizeof(std::uint64_t) == 0U, "detail is copied in 64-bit words");
+
+// One thread's ring. Only the owning thread writes events and bumps `head` after each one;
+// the exporter reads the last `capacity` indices below `head` and skips lapped slots.
+struct ThreadTrace {
+    std::unique_ptr<TraceSlot[]> ring;
+    std::size_t capacity = 0;
+    std::size_t mask = 0;
+    std::atomic<std::uint64_t> head{0};
+    std::uint64_t flow_seq = 0;
+    std::uint64_t flow_base = 0;  // ring index << 40, so flow ids never collide across threads
+    std::int64_t tid = 0;
+    std::string name;  // guarded by Registry::mutex
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadTrace>> threads;
+    TraceOptions options;     // guarded by mutex
+    std::uint64_t rings = 0;  // guarded by mutex; ever created, for flow id bases
+    std::atomic<std::uint64_t> epoch_ns{0};
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+thread_local std::shared_ptr<ThreadTrace> t_trace;
+thread_local std::string t_name;
+
+// Requires Registry::mutex. Drops the rings of exited threads (only the registry still holds
+// them) beyond the `keep` started last.
+void prune_exited(Registry& r, std::size_t keep) {
+    std::size_t exited = 0;
+    for (auto it = r.threads.rbegin(); it != r.threads.rend(); ++it) {
+        if (it->use_count() == 1 && ++exited > keep) it->reset();
+    }
+    r.threads.erase(std::remove(r.threads.begin(), r.threads.end(), nullptr), r.threads.end());
+}
+
+ThreadTrace& this_thread_trace() {
+    if (t_trace) return *t_trace;
+    auto trace = std::make_shared<ThreadTrace>();
+    trace->tid = static_cast<std::int64_t>(::syscall(SYS_gettid));
+    trace->name = t_name;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::size_t capacity = 1U;
+    while (capacity < std::max<std::size_t>(r.options.events_per_thread, 2U)) capacity <<= 1U;
+    trace->ring = std::make_unique<TraceSlot[]>(capacity);
+    trace->capacity = capacity;
+    trace->mask = capacity - 1U;
+    trace->flow_base = ++r.rings << 40U;
+    prune_exited(r, r.options.exited_threads_kept);
+    r.threads.push_back(trace);
+    t_trace = std::move(trace);
+    return *t_trace;
+}
+
+// Owning thread only.
+void record(ThreadTrace& t, const TraceEvent& e) noexcept {
+    const std::uint64_t index = t.head.load(std::memory_order_relaxed);
+    TraceSlot& slot = t.ring[index & t.mask];
+    slot.seq.store(2U * index + 1U, std::memory_order_relaxed);
+    // Orders the odd `seq` before the field stores: a reader that sees any of them sees it.
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(e.name, std::memory_order_relaxed);
+    slot.category.store(e.category, std::memory_order_relaxed);
+    slot.ts_ns.store(e.ts_ns, std::memory_order_relaxed);
+    slot.dur_ns.store(e.dur_ns, std::memory_order_relaxed);
+    slot.flow.store(e.flow, std::memory_order_relaxed);
+    slot.kind.store(e.kind, std::memory_order_relaxed);
+    for (std::size_t w = 0; w < std::size(slot.detail); ++w) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, e.detail + w * sizeof(word), sizeof(word));
+        slot.detail[w].store(word, std::memory_order_relaxed);
+    }
+    slot.seq.store(2U * index + 2U, std::memory_order_release);
+    t.head.store(index + 1U, std::memory_order_release);
+}
+
+// Copies event `index` out of its slot; false if the slot holds another event or was being
+// rewritten while it was read.
+bool read_event(const TraceSlot& slot, std::uint64_t index, TraceEvent& out) noexcept {
+    const std::uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != 2U * index + 2U) return false;
+    out.name = slot.name.load(std::memory_order_relaxed);
+    out.category = slot.category.load(std::memory_order_relaxed);
+    out.ts_ns = slot.ts_ns.load(std::memory_order_relaxed);
+    out.dur_ns = slot.dur_ns.load(std::memory_order_relaxed);
+    out.flow = slot.flow.load(std::memory_order_relaxed);
+    out.kind = slot.kind.load(std::memory_order_relaxed);
+    for (std::size_t w = 0; w < std::size(slot.detail); ++w) {
+        const std::uint64_t word = slot.detail[w].load(std::memory_order_relaxed);
+        std::memcpy(out.detail + w * sizeof(word), &word, sizeof(word));
+    }
+    // Orders the field loads before the re-check of `seq`.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == seq;
+}
+
+void copy_detail(TraceEvent& e, std::string_view detail) noexcept {
+    const std::size_t n = std::min(detail.size(), Tracer::kDetailSize - 1U);
+    std::copy_n(detail.data(), n, e.detail);
+    e.detail[n] = '\0';
+}
+
+void append_escaped(std::string& out, const char* s) {
+    out += '"';
+    for (; s != nullptr && *s != '\0'; ++s) {
+        const auto c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += *s;
+        } else if (c < 0x20U) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += *s;
+        }
+    }
+    out += '"';
+}
+
+// Chrome trace timestamps are microseconds; keep nanosecond precision in the fraction.
+void append_us(std::string& out, std::uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu.%03llu", static_cast<unsigned long long>(ns / 1000U),
+                  static_cast<unsigned long long>(ns % 1000U));
+    out += buf;
+}
+
+void append_head(std::string& out, const char* ph, const char* name, const char* category, std::uint64_t ts,
+                 long pid, std::int64_t tid) {
+    out += "{\"ph\":\"";
+    out += ph;
+    out += "\",\"name\":";
+    append_escaped(out, name);
+    out += ",\"cat\":";
+    append_escaped(out, category);
+    out += ",\"ts\":";
+    append_us(out, ts);
+    out += ",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(tid);
+}
+
+void append_event(std::string& out, const TraceEvent& e, long pid, std::int64_t tid) {
+    switch (e.kind) {
+        case EventKind::kComplete:
+            if (e.flow != 0U) {
+                // Flow end bound to the slice that starts here ("bp":"e").
+                append_head(out, "f", "handoff", e.category, e.ts_ns, pid, tid);
+                out += ",\"bp\":\"e\",\"id\":" + std::to_string(e.flow) + "},\n";
+            }
+            append_head(out, "X", e.name, e.category, e.ts_ns, pid, tid);
+            out += ",\"dur\":";
+            append_us(out, e.dur_ns);
+            break;
+        case EventKind::kInstant:
+            append_head(out, "i", e.name, e.category, e.ts_ns, pid, tid);
+            out += ",\"s\":\"t\"";
+            break;
+        case EventKind::kFlowBegin:
+            // A zero-length slice for the flow start to bind to, even outside any span.
+            append_head(out, "X", e.name, e.category, e.ts_ns, pid, tid);
+            out += ",\"dur\":0},\n";
+            append_head(out, "s", "handoff", e.category, e.ts_ns, pid, tid);
+            out += ",\"id\":" + std::to_string(e.flow);
+            break;
+    }
+    if (e.detail[0] != '\0') {
+        out += ",\"args\":{\"detail\":";
+        append_escaped(out, e.detail);
+        out += '}';
+    }
+    out += "},\n";
+}
+
+}  // namespace
+
+void Tracer::enable(const TraceOptions& options) {
+    Registry& r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.options = options;
+        // Rings of exited threads only hold events of earlier sessions.
+        prune_exited(r, 0U);
+    }
+    r.epoch_ns.store(now_ns(), std::memory_order_release);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void Tracer::disable() noexcept { enabled_.store(false, std::memory_order_release); }
+
+std::uint64_t Tracer::now_ns() noexcept {
+    timespec ts{};
+    (void)::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000U + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+void Tracer::complete(const char* name, const char* category, std::uint64_t start_ns, std::uint64_t end_ns,
+                      std::string_view detail, std::uint64_t flow_in) {
+    if (!enabled()) return;
+    TraceEvent e;
+    e.name = name;
+    e.category = category;
+    e.ts_ns = start_ns;
+    e.dur_ns = end_ns > start_ns ? end_ns - start_ns : 0U;
+    e.flow = flow_in;
+    e.kind = EventKind::kComplete;
+    copy_detail(e, detail);
+    record(this_thread_trace(), e);
+}
+
+void Tracer::instant(const char* name, const char* category, std::string_view detail) {
+    if (!enabled()) return;
+    TraceEvent e;
+    e.name = name;
+    e.category = category;
+    e.ts_ns = now_ns();
+    e.kind = EventKind::kInstant;
+    copy_detail(e, detail);
+    record(this_thread_trace(), e);
+}
+
+std::uint64_t Tracer::flow_begin(const char* name, const char* category) {
+    if (!enabled()) return 0U;
+    ThreadTrace& t = this_thread_trace();
+    const std::uint64_t id = t.flow_base | ++t.flow_seq;
+    TraceEvent e;
+    e.name = name;
+    e.category = category;
+    e.ts_ns = now_ns();
+    e.flow = id;
+    e.kind = EventKind::kFlowBegin;
+    record(t, e);
+    return id;
+}
+
+void Tracer::set_thread_name(std::string_view name) {
+    t_name.assign(name);
+    if (!t_trace) return;
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    t_trace->name = t_name;
+}
+
+std::string Tracer::export_chrome_json() {
+    Registry& r = registry();
+    const std::uint64_t epoch = r.epoch_ns.load(std::memory_order_acquire);
+    const long pid = static_cast<long>(::getpid());
+
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    std::vector<TraceEvent> events;
+    TraceEvent event;
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& t : r.threads) {
+        const std::uint64_t capacity = t->capacity;
+        const std::uint64_t head = t->head.load(std::memory_order_acquire);
+        const std::uint64_t first = head > capacity ? head - capacity : 0U;
+        events.clear();
+        for (std::uint64_t i = first; i < head; ++i) {
+            // Slots the writer lapped during the copy are left out.
+            if (read_event(t->ring[i & t->mask], i, event)) events.push_back(event);
+        }
+
+        bool named = false;
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            if (events[i].ts_ns < epoch) continue;
+            if (!named && !t->name.empty()) {
+                out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + std::to_string(pid) +
+                       ",\"tid\":" + std::to_string(t->tid) + ",\"args\":{\"name\":";
+                append_escaped(out, t->name.c_str());
+                out += "}},\n";
+                named = true;
+            }
+            append_event(out, events[i], pid, t->tid);
+        }
+    }
+    if (out.back() == '\n' && out[out.size() - 2U] == ',') out.erase(out.size() - 2U, 1U);
+    out += "]}\n";
+    return out;
+}
+
+std::error_code Tracer::write_chrome_json(const std::string& path) {
+    const std::string json = export_chrome_json();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return std::make_error_code(std::errc::io_error);
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    file.close();
+    return file ? std::error_code{} : std::make_error_code(std::errc::io_error);
+}
+
+}  // namespace sx::infra
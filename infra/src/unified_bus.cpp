@@ -3,14 +3,29 @@
  * @brief UnifiedBus implementation
  */
 #include "sx/infra/unified_bus.h"
+#include "sx/infra/async_runtime.h"
+#include "sx/infra/config_manager.h"
+#include "sx/infra/trace.h"
 #include "sx/utils/mpmc_queue.h"
+#include "sx/utils/mpsc_queue.h"
 #include "sx/utils/overwrite_queue.h"
 #include <zmq.h>
+#include <algorithm>
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <future>
 #include <thread>
 #include <unordered_map>
 #include <mutex>
+#include <queue>
+#include <random>
+#include <shared_mutex>
 #include <system_error>
+#include <utility>
 
 namespace sx::infra {
 
@@ -27,10 +42,56 @@ const std::error_category& zmq_category() {
     return cat;
 }
 
+// Consumer side of a stream subscription: records "bus.pop" while tracing is on. A blocking
+// pop's span covers the wait, so a starved consumer shows up on the timeline.
+class TracedStreamQueue final : public sx::utils::IQueue<std::shared_ptr<void>> {
+public:
+    using Queue = sx::utils::IQueue<std::shared_ptr<void>>;
+
+    TracedStreamQueue(std::shared_ptr<Queue> queue, std::string topic)
+        : queue_(std::move(queue)), topic_(std::move(topic)) {}
+
+    void push(std::shared_ptr<void> item) noexcept override { queue_->push(std::move(item)); }
+
+    void wait_and_pop(std::shared_ptr<void>& item) noexcept override {
+        TraceSpan span("bus.pop", "bus", topic_);
+        queue_->wait_and_pop(item);
+    }
+
+    std::shared_ptr<std::shared_ptr<void>> wait_and_pop() noexcept override {
+        TraceSpan span("bus.pop", "bus", topic_);
+        return queue_->wait_and_pop();
+    }
+
+    bool try_pop(std::shared_ptr<void>& item) noexcept override {
+        if (!queue_->try_pop(item)) return false;
+        if (Tracer::enabled()) Tracer::instant("bus.pop", "bus", topic_);
+        return true;
+    }
+
+    std::shared_ptr<std::shared_ptr<void>> try_pop() noexcept override {
+        auto item = queue_->try_pop();
+        if (item && Tracer::enabled()) Tracer::instant("bus.pop", "bus", topic_);
+        return item;
+    }
+
+    [[nodiscard]] bool empty() const noexcept override { return queue_->empty(); }
+
+private:
+    std::shared_ptr<Queue> queue_;
+    std::string topic_;
+};
+
 std::error_code make_zmq_error_from_errno() {
     return std::error_code(errno, zmq_category());
 }
 
+// inproc:// endpoints are only reachable through the ZMQ context that bound them, and each
+// UnifiedBus owns its own context, so every possible subscriber lives on this bus.
+bool is_inproc_endpoint(const std::string& endpoint) {
+    return endpoint.rfind("inproc://", 0) == 0;
+}
+
 }  // namespace
 
 class UnifiedBus::Impl {
@@ -54,7 +115,246 @@ public:
     std::unordered_map<std::string, std::vector<std::function<void(const std::string&)>>> control_topics_;
     std::mutex control_mutex_;
 
+    // ---------------- In-process control-plane (inproc://) ----------------
+    // Delivered without ZMQ. Messages of one endpoint are serialized through a combining
+    // dispatcher: whichever publisher moves `queued` off zero delivers what is queued, in push
+    // order, on its own thread. Callbacks of one endpoint therefore never run concurrently,
+    // and a callback that publishes to (or subscribes on) its own endpoint just enqueues (no
+    // re-entrancy). A dispatcher that keeps finding work hands it to the next publisher after
+    // kDrainBudget items, so no publish() call is held hostage by other threads' traffic.
+    // Callbacks must not throw: delivery is noexcept, like the SUB receive threads.
+    struct LocalMessage : sx::utils::MPSCNode {
+        std::string payload;
+        std::function<void(const std::string&)> subscriber;  // set: a subscription, not a message
+    };
+
+    struct LocalChannel {
+        using CallbackList = std::vector<std::function<void(const std::string&)>>;
+
+        static constexpr std::size_t kDrainBudget = 64;
+
+        // Dispatcher hand-off: the dispatcher asks (kWanted), a publisher answers (kClaimed)
+        // and waits until the dispatcher lets go between two items (kGranted).
+        enum Handoff : uint8_t { kNone, kWanted, kClaimed, kGranted };
+
+        // Copy-on-write: subscribe() swaps in a new list, delivery only bumps a refcount.
+        std::mutex callbacks_mutex;
+        std::shared_ptr<const CallbackList> callbacks = std::make_shared<const CallbackList>();
+        std::atomic<std::size_t> subscriber_count{0};
+
+        sx::utils::MPSCQueue<LocalMessage> pending;
+        // Items being delivered or queued. It only drops back to zero inside drain(), after the
+        // last one was handled, so it doubles as the dispatcher's ownership flag.
+        std::atomic<std::size_t> queued{0};
+        std::atomic<uint8_t> handoff{kNone};
+        std::atomic<uint64_t> delivered{0};
+
+        // Last-value cache; only touched by the current dispatcher.
+        bool last_value_cache = false;
+        bool has_last_value = false;
+        std::string last_value;
+
+        // Channels the calling thread is dispatching right now (any endpoint). Such a thread
+        // never claims a hand-off: it would wait for a dispatcher further up its own stack.
+        static inline thread_local std::size_t dispatch_depth = 0;
+
+        LocalChannel() = default;
+        ~LocalChannel() {
+            while (LocalMessage* m = pending.pop()) delete m;
+        }
+        LocalChannel(const LocalChannel&) = delete;
+        LocalChannel& operator=(const LocalChannel&) = delete;
+        LocalChannel(LocalChannel&&) = delete;
+        LocalChannel& operator=(LocalChannel&&) = delete;
+
+        void deliver(const std::string& payload) noexcept {
+            TraceSpan span("bus.dispatch", "bus");
+            if (last_value_cache) {
+                last_value = payload;
+                has_last_value = true;
+            }
+            delivered.fetch_add(1, std::memory_order_relaxed);
+
+            std::shared_ptr<const CallbackList> snapshot;
+            {
+                std::lock_guard<std::mutex> lock(callbacks_mutex);
+                snapshot = callbacks;
+            }
+            for (const auto& cb : *snapshot) {
+                cb(payload);
+            }
+        }
+
+        void handle(LocalMessage* m) noexcept {
+            if (m->subscriber) {
+                // Replay under the dispatcher so the newcomer sees the cached value exactly
+                // once and before anything published after it.
+                if (has_last_value) m->subscriber(last_value);
+                add_callback(std::move(m->subscriber));
+            } else {
+                deliver(m->payload);
+            }
+            delete m;
+        }
+
+        // Requires being the dispatcher, with the item just handled still counted. Handles
+        // queued items until `queued` drops to zero or a publisher takes over.
+        void drain() noexcept {
+            ++dispatch_depth;
+            std::size_t handled = 0;
+            while (true) {
+                // A publisher answered the request: it carries on with this item's count.
+                uint8_t claimed = kClaimed;
+                if (handoff.compare_exchange_strong(claimed, kGranted, std::memory_order_acq_rel)) break;
+
+                if (queued.fetch_sub(1, std::memory_order_acq_rel) == 1U) {
+                    if (retake_for_claimer()) continue;
+                    break;
+                }
+
+                handle(pop_counted());
+                if (++handled == kDrainBudget) {
+                    uint8_t none = kNone;
+                    (void)handoff.compare_exchange_strong(none, kWanted, std::memory_order_acq_rel);
+                }
+            }
+            --dispatch_depth;
+        }
+
+        // After letting `queued` drop to zero: withdraws a pending hand-off request. A publisher
+        // that claimed it may already wait for a grant; if nobody else dispatches yet, takes
+        // the ownership back (counting a phantom item) so drain() can grant it. Returns
+        // whether this thread is the dispatcher again.
+        bool retake_for_claimer() noexcept {
+            uint8_t state = kWanted;
+            if (handoff.compare_exchange_strong(state, kNone, std::memory_order_acq_rel) || state != kClaimed) {
+                return false;
+            }
+            std::size_t idle = 0;
+            return queued.compare_exchange_strong(idle, 1U, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        void enqueue(LocalMessage* node) {
+            pending.push(node);
+            uint8_t wanted = kWanted;
+            const bool claimed = dispatch_depth == 0U && handoff.load(std::memory_order_relaxed) == kWanted &&
+                                 handoff.compare_exchange_strong(wanted, kClaimed, std::memory_order_acq_rel);
+            if (queued.fetch_add(1, std::memory_order_acq_rel) == 0U) {
+                // Nobody was dispatching after all; a claim no longer matters.
+                if (claimed) handoff.store(kNone, std::memory_order_release);
+                take_over();
+                return;
+            }
+            if (!claimed) return;
+            while (handoff.load(std::memory_order_acquire) != kGranted) std::this_thread::yield();
+            handoff.store(kNone, std::memory_order_release);
+            // The previous dispatcher left the count of the item it handled last to us.
+            drain();
+        }
+
+        // Becomes the dispatcher for an item counted but not yet handled.
+        void take_over() noexcept {
+            ++dispatch_depth;
+            handle(pop_counted());
+            --dispatch_depth;
+            drain();
+        }
+
+        // Producers count an item after pushing it, so a counted item is always coming: pop()
+        // only misses it while its producer is between exchange and link.
+        LocalMessage* pop_counted() noexcept {
+            LocalMessage* m = pending.pop();
+            while (m == nullptr) {
+                std::this_thread::yield();
+                m = pending.pop();
+            }
+            return m;
+        }
+
+        void publish(const std::string& message) {
+            // Fast path: nothing queued and nobody delivering => deliver in place, zero copy.
+            std::size_t idle = 0;
+            if (queued.load(std::memory_order_relaxed) == 0U &&
+                queued.compare_exchange_strong(idle, 1U, std::memory_order_acquire, std::memory_order_relaxed)) {
+                ++dispatch_depth;
+                deliver(message);
+                --dispatch_depth;
+                drain();
+                return;
+            }
+
+            auto* node = new LocalMessage();
+            node->payload = message;
+            enqueue(node);
+        }
+
+        void add_subscriber(std::function<void(const std::string&)> callback) {
+            if (!last_value_cache) {
+                add_callback(std::move(callback));
+                return;
+            }
+            // Queued like a message: handled right here unless a dispatcher is running (possibly
+            // this very thread, when subscribing from a callback), which then picks it up in order.
+            auto* node = new LocalMessage();
+            node->subscriber = std::move(callback);
+            enqueue(node);
+        }
+
+        void add_callback(std::function<void(const std::string&)> callback) {
+            std::lock_guard<std::mutex> lock(callbacks_mutex);
+            auto next = std::make_shared<CallbackList>(*callbacks);
+            next->push_back(std::move(callback));
+            callbacks = std::move(next);
+            subscriber_count.fetch_add(1, std::memory_order_release);
+        }
+    };
+
+    std::unordered_map<std::string, std::shared_ptr<LocalChannel>> local_channels_;
+    std::shared_mutex local_mutex_;
+
+    std::shared_ptr<LocalChannel> find_local(const std::string& endpoint) {
+        std::shared_lock<std::shared_mutex> lock(local_mutex_);
+        auto it = local_channels_.find(endpoint);
+        return it != local_channels_.end() ? it->second : nullptr;
+    }
+
+    std::shared_ptr<LocalChannel> get_or_create_local(const std::string& endpoint,
+                                                      const sx::types::ControlChannelOptions& options) {
+        std::unique_lock<std::shared_mutex> lock(local_mutex_);
+        auto& slot = local_channels_[endpoint];
+        if (!slot) {
+            slot = std::make_shared<LocalChannel>();
+            slot->last_value_cache = options.last_value_cache;
+        }
+        return slot;
+    }
+
+    std::error_code publish_local(const std::string& endpoint, const std::string& message,
+                                  const sx::types::ControlChannelOptions* options) {
+        auto channel = find_local(endpoint);
+        if (!channel) {
+            // No subscriber: dropped, as with PUB, unless the endpoint caches its last value.
+            const auto resolved = resolve_options(endpoint, options);
+            if (!resolved.last_value_cache) return {};
+            channel = get_or_create_local(endpoint, resolved);
+        }
+        if (!channel->last_value_cache && channel->subscriber_count.load(std::memory_order_acquire) == 0U) {
+            return {};
+        }
+        channel->publish(message);
+        return {};
+    }
+
+    std::error_code subscribe_local(const std::string& endpoint, std::function<void(const std::string&)> callback,
+                                    const sx::types::ControlChannelOptions* options) {
+        auto channel = find_local(endpoint);
+        if (!channel) channel = get_or_create_local(endpoint, resolve_options(endpoint, options));
+        channel->add_subscriber(std::move(callback));
+        return {};
+    }
+
     // ---------------- ZeroMQ control-plane ----------------
+    // zmq_mutex_ guards the context and the SUB workers (cold paths only).
     void* zmq_context_ = nullptr;
     std::mutex zmq_mutex_;
 
@@ -63,10 +363,172 @@ public:
         std::thread thread;
         std::atomic<bool> stop{false};
         std::string endpoint;
+
+        // Sequence tracking (written by the worker thread, read by channel_stats()).
+        uint32_t incarnation = 0;  // of the publisher last heard from, worker thread only
+        std::atomic<uint64_t> received{0};
+        std::atomic<uint64_t> gaps{0};
+        std::atomic<uint64_t> duplicates{0};
+        std::atomic<uint64_t> last_sequence{0};
+
+        // Latest message of a last-value-cache publisher (worker thread only). The publisher
+        // only replays to new SUB connections, so a later subscribe() on this bus gets this copy.
+        bool has_last_value = false;
+        std::string last_value;
+
+        // Once the publisher turned out to cache, callbacks added later wait here; the worker
+        // replays last_value to each and registers it between deliveries (within one receive
+        // timeout when idle). Guarded by control_mutex_.
+        bool replays = false;
+        std::vector<std::function<void(const std::string&)>> joining;
+        std::atomic<bool> has_joining{false};
+    };
+
+    // A single-frame message is one payload, never inspected. A multipart message starts with a
+    // header frame (a marker, a flags byte, the publisher's incarnation and the sequence number
+    // of the first payload) and carries one payload per following frame. Headers travel in their own frame, so every
+    // subscriber strips them whatever its own options, and payloads are never touched.
+    static constexpr unsigned char kSequenceMarker[3] = {0xFFU, 0x53U, 0x51U};  // 0xFF 'S' 'Q'
+    static constexpr unsigned char kFlagSequenced = 0x01U;                      // payloads numbered
+    static constexpr unsigned char kFlagLastValue = 0x02U;                      // publisher caches
+    static constexpr std::size_t kIncarnationOffset = sizeof(kSequenceMarker) + 1U;
+    static constexpr std::size_t kSequenceOffset = kIncarnationOffset + sizeof(uint32_t);
+    static constexpr std::size_t kSequenceBytes = kSequenceOffset + sizeof(uint64_t);
+
+    // Every PUB / DEALER / ROUTER socket is owned by one reactor thread. Callers never touch
+    // a socket: they push commands onto a lock-free MPSC queue and the reactor executes them.
+    struct PubChannel {
+        std::string endpoint;
+        void* socket = nullptr;
+        sx::types::ControlChannelOptions options;
+
+        // Reactor-thread state: messages coalesced into one multipart send.
+        std::vector<zmq_msg_t> batch;
+        std::chrono::steady_clock::time_point batch_deadline;
+        uint64_t batch_sequence = 0;  // of the first message in the batch
+
+        // Reactor-thread state: sequence numbering and last-value cache. Numbering restarts
+        // with every channel; the incarnation tells subscribers it did.
+        uint32_t incarnation = 0;
+        uint64_t next_sequence = 1;
+        bool has_last_value = false;
+        uint64_t last_value_sequence = 0;
+        zmq_msg_t last_value;
+
+        PubChannel() { zmq_msg_init(&last_value); }
+        ~PubChannel() { zmq_msg_close(&last_value); }
+        PubChannel(const PubChannel&) = delete;
+        PubChannel& operator=(const PubChannel&) = delete;
+        PubChannel(PubChannel&&) = delete;
+        PubChannel& operator=(PubChannel&&) = delete;
+
+        [[nodiscard]] bool batching() const noexcept {
+            return !options.conflate && options.batch_max_messages > 1U;
+        }
+        // ZMQ_CONFLATE keeps a single frame, so conflating channels never carry headers.
+        [[nodiscard]] bool sequenced() const noexcept {
+            return !options.conflate && (options.sequenced || options.last_value_cache);
+        }
+        [[nodiscard]] bool caches() const noexcept { return !options.conflate && options.last_value_cache; }
+    };
+
+    // Client side of request(): one DEALER per endpoint, all requests multiplexed over it.
+    struct RpcClient {
+        std::string endpoint;
+        void* socket = nullptr;
+    };
+
+    // Server side of serve(): one ROUTER bound per endpoint.
+    struct RpcServer {
+        std::string endpoint;
+        void* socket = nullptr;
+        RequestHandler handler;
+        std::shared_ptr<IExecutor> executor;
+    };
+
+    struct Command : sx::utils::MPSCNode {
+        enum class Kind {
+            kPublish,
+            kFlush,
+            kWatchClient,
+            kWatchServer,
+            kWatchPublisher,
+            kRequest,
+            kReply,
+        };
+
+        Kind kind = Kind::kPublish;
+        zmq_msg_t msg;  // payload of kPublish / kRequest / kReply
+
+        PubChannel* channel = nullptr;        // kPublish
+        std::promise<void>* flushed = nullptr;  // kFlush
+        RpcClient* client = nullptr;          // kWatchClient / kRequest
+        RpcServer* server = nullptr;          // kWatchServer / kReply
+
+        // kRequest
+        ReplyCallback on_reply;
+        std::shared_ptr<IExecutor> executor;
+        std::chrono::steady_clock::time_point deadline;
+
+        // kReply
+        std::string identity;
+        uint64_t correlation_id = 0;
+
+        Command() { zmq_msg_init(&msg); }
+        ~Command() { zmq_msg_close(&msg); }
+        Command(const Command&) = delete;
+        Command& operator=(const Command&) = delete;
+        Command(Command&&) = delete;
+        Command& operator=(Command&&) = delete;
+    };
+
+    // Responders may outlive the reactor (handlers can answer later from any thread); they
+    // reach it through this gate, which is closed before the reactor stops.
+    struct ReplyGate {
+        std::shared_mutex mutex;
+        Impl* impl = nullptr;
     };
 
-    // Scheme A: control-plane topic == ZMQ endpoint, keyed by endpoint
-    std::unordered_map<std::string, void*> pub_sockets_;
+    // Scheme A: control-plane topic == ZMQ endpoint, keyed by endpoint.
+    // channel_mutex_ is shared on the publish / request hot path and exclusive only to create
+    // a channel or to tear the reactor down, so callers on any endpoint run concurrently.
+    std::unordered_map<std::string, std::unique_ptr<PubChannel>> pub_channels_;
+    std::unordered_map<std::string, std::unique_ptr<RpcClient>> rpc_clients_;
+    std::unordered_map<std::string, std::unique_ptr<RpcServer>> rpc_servers_;
+    std::shared_mutex channel_mutex_;
+    // Set by shutdown while it joins the reactor without holding channel_mutex_: callbacks
+    // running on the reactor may still publish / request / serve, and fail fast instead.
+    bool reactor_closing_ = false;  // guarded by channel_mutex_
+    std::mutex shutdown_mutex_;     // one shutdown at a time
+
+    sx::utils::MPSCQueue<Command> commands_;
+    std::thread reactor_thread_;
+    int wake_fd_ = -1;
+    std::atomic<bool> reactor_parked_{false};
+    std::atomic<bool> reactor_stop_{false};
+    std::shared_ptr<ReplyGate> reply_gate_;
+
+    // Reactor-thread state.
+    struct PendingRequest {
+        ReplyCallback on_reply;
+        std::shared_ptr<IExecutor> executor;
+        std::chrono::steady_clock::time_point deadline;
+    };
+    using DeadlineEntry = std::pair<std::chrono::steady_clock::time_point, uint64_t>;
+    std::vector<RpcClient*> watched_clients_;
+    std::vector<RpcServer*> watched_servers_;
+    std::vector<PubChannel*> watched_publishers_;  // XPUB with last-value cache
+    std::unordered_map<uint64_t, PendingRequest> pending_requests_;
+    std::vector<PendingRequest> canceled_requests_;  // left by reactor_loop() for stop_reactor_locked()
+    std::priority_queue<DeadlineEntry, std::vector<DeadlineEntry>, std::greater<>> deadlines_;
+    uint64_t next_correlation_id_ = 1;
+
+    std::vector<PubChannel*> open_batches_;
+
+    // Per-endpoint tuning registered ahead of socket creation.
+    std::unordered_map<std::string, sx::types::ControlChannelOptions> channel_options_;
+    std::mutex options_mutex_;
+
     std::unordered_map<std::string, std::unique_ptr<SubWorker>> sub_workers_;
 
     // 数据流 Topic 表
@@ -85,35 +547,742 @@ public:
         return {};
     }
 
-    [[nodiscard]] std::error_code publish_control(const std::string& endpoint, const std::string& message) {
-        std::lock_guard<std::mutex> lock(zmq_mutex_);
-        if (const auto ec = ensure_zmq_context_locked()) return ec;
+    // Requires channel_mutex_ held exclusively.
+    [[nodiscard]] std::error_code ensure_reactor_locked() {
+        {
+            std::lock_guard<std::mutex> z_lock(zmq_mutex_);
+            if (const auto ec = ensure_zmq_context_locked()) return ec;
+        }
+        if (reactor_thread_.joinable()) return {};
 
-        void*& pub = pub_sockets_[endpoint];
-        if (pub == nullptr) {
-            pub = zmq_socket(zmq_context_, ZMQ_PUB);
-            if (pub == nullptr) {
-                return make_zmq_error_from_errno();
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) return std::error_code(errno, std::generic_category());
+
+        reply_gate_ = std::make_shared<ReplyGate>();
+        reply_gate_->impl = this;
+        reactor_stop_.store(false, std::memory_order_relaxed);
+        reactor_parked_.store(false, std::memory_order_relaxed);
+        reactor_thread_ = std::thread([this]() { reactor_loop(); });
+        return {};
+    }
+
+    [[nodiscard]] sx::types::ControlChannelOptions resolve_options(
+        const std::string& endpoint, const sx::types::ControlChannelOptions* explicit_options) {
+        if (explicit_options != nullptr) return *explicit_options;
+        std::lock_guard<std::mutex> lock(options_mutex_);
+        auto it = channel_options_.find(endpoint);
+        return it != channel_options_.end() ? it->second : sx::types::ControlChannelOptions{};
+    }
+
+    // Must run before bind/connect: ZMQ applies HWM and conflate per pipe at attach time.
+    static void apply_channel_options(void* socket, const sx::types::ControlChannelOptions& options) {
+        if (options.conflate) {
+            const int on = 1;
+            (void)zmq_setsockopt(socket, ZMQ_CONFLATE, &on, sizeof(on));
+        }
+        if (options.send_hwm >= 0) {
+            (void)zmq_setsockopt(socket, ZMQ_SNDHWM, &options.send_hwm, sizeof(options.send_hwm));
+        }
+        if (options.recv_hwm >= 0) {
+            (void)zmq_setsockopt(socket, ZMQ_RCVHWM, &options.recv_hwm, sizeof(options.recv_hwm));
+        }
+    }
+
+    // Requires channel_mutex_ held exclusively and the reactor running.
+    [[nodiscard]] std::error_code open_socket_locked(int type, void*& out) {
+        out = zmq_socket(zmq_context_, type);
+        if (out == nullptr) return make_zmq_error_from_errno();
+        const int linger = 0;
+        (void)zmq_setsockopt(out, ZMQ_LINGER, &linger, sizeof(linger));
+        return {};
+    }
+
+    // Requires channel_mutex_ held exclusively.
+    [[nodiscard]] std::error_code create_pub_channel_locked(const std::string& endpoint,
+                                                            const sx::types::ControlChannelOptions& options,
+                                                            PubChannel*& out) {
+        auto it = pub_channels_.find(endpoint);
+        if (it != pub_channels_.end()) {
+            out = it->second.get();
+            return {};
+        }
+        if (const auto ec = ensure_reactor_locked()) return ec;
+
+        auto channel = std::make_unique<PubChannel>();
+        channel->endpoint = endpoint;
+        channel->options = options;
+        channel->incarnation = static_cast<uint32_t>(std::random_device{}()) ^
+                               static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        // XPUB reports every (re)subscription, which is when the cached last value is replayed.
+        const int type = channel->caches() ? ZMQ_XPUB : ZMQ_PUB;
+        if (const auto ec = open_socket_locked(type, channel->socket)) return ec;
+        apply_channel_options(channel->socket, options);
+        if (channel->caches()) {
+            const int verbose = 1;
+            (void)zmq_setsockopt(channel->socket, ZMQ_XPUB_VERBOSE, &verbose, sizeof(verbose));
+        }
+
+        if (zmq_bind(channel->socket, endpoint.c_str()) != 0) {
+            const auto ec = make_zmq_error_from_errno();
+            zmq_close(channel->socket);
+            return ec;
+        }
+
+        if (channel->caches()) {
+            auto* watch = new Command();
+            watch->kind = Command::Kind::kWatchPublisher;
+            watch->channel = channel.get();
+            push_command(watch);
+        }
+
+        // The socket migrates to the reactor thread; the command push/pop pair is the
+        // full memory barrier ZMQ requires for that hand-off.
+        out = channel.get();
+        pub_channels_[endpoint] = std::move(channel);
+        return {};
+    }
+
+    // Requires channel_mutex_ held exclusively.
+    [[nodiscard]] std::error_code create_rpc_client_locked(const std::string& endpoint, RpcClient*& out) {
+        auto it = rpc_clients_.find(endpoint);
+        if (it != rpc_clients_.end()) {
+            out = it->second.get();
+            return {};
+        }
+        if (const auto ec = ensure_reactor_locked()) return ec;
+
+        auto client = std::make_unique<RpcClient>();
+        client->endpoint = endpoint;
+        if (const auto ec = open_socket_locked(ZMQ_DEALER, client->socket)) return ec;
+
+        if (zmq_connect(client->socket, endpoint.c_str()) != 0) {
+            const auto ec = make_zmq_error_from_errno();
+            zmq_close(client->socket);
+            return ec;
+        }
+
+        auto* watch = new Command();
+        watch->kind = Command::Kind::kWatchClient;
+        watch->client = client.get();
+        push_command(watch);
+
+        out = client.get();
+        rpc_clients_[endpoint] = std::move(client);
+        return {};
+    }
+
+    void push_command(Command* cmd) {
+        commands_.push(cmd);
+        wake_reactor();
+    }
+
+    [[nodiscard]] static std::error_code copy_into(zmq_msg_t& msg, const std::string& payload) {
+        zmq_msg_close(&msg);
+        if (zmq_msg_init_size(&msg, payload.size()) != 0) return make_zmq_error_from_errno();
+        if (!payload.empty()) std::memcpy(zmq_msg_data(&msg), payload.data(), payload.size());
+        return {};
+    }
+
+    [[nodiscard]] std::error_code enqueue_publish_locked(PubChannel* channel, const std::string& message) {
+        auto* cmd = new Command();
+        cmd->kind = Command::Kind::kPublish;
+        cmd->channel = channel;
+        if (const auto ec = copy_into(cmd->msg, message)) {
+            zmq_msg_init(&cmd->msg);
+            delete cmd;
+            return ec;
+        }
+        push_command(cmd);
+        return {};
+    }
+
+    void wake_reactor() {
+        // Dekker pairing with reactor_loop(): only pay for a syscall if the reactor parked.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (reactor_parked_.load(std::memory_order_relaxed) &&
+            reactor_parked_.exchange(false, std::memory_order_seq_cst)) {
+            const uint64_t one = 1;
+            (void)::write(wake_fd_, &one, sizeof(one));
+        }
+    }
+
+    [[nodiscard]] std::error_code publish_control(const std::string& endpoint, const std::string& message,
+                                                  const sx::types::ControlChannelOptions* options = nullptr) {
+        TraceSpan span("bus.publish", "bus", endpoint);
+        if (is_inproc_endpoint(endpoint)) return publish_local(endpoint, message, options);
+
+        {
+            std::shared_lock<std::shared_mutex> lock(channel_mutex_);
+            if (reactor_closing_) return std::make_error_code(std::errc::operation_canceled);
+            auto it = pub_channels_.find(endpoint);
+            if (it != pub_channels_.end()) {
+                return enqueue_publish_locked(it->second.get(), message);
             }
-            const int linger = 0;
-            (void)zmq_setsockopt(pub, ZMQ_LINGER, &linger, sizeof(linger));
+        }
 
-            if (zmq_bind(pub, endpoint.c_str()) != 0) {
-                const auto ec = make_zmq_error_from_errno();
-                zmq_close(pub);
-                pub = nullptr;
-                return ec;
+        const auto resolved = resolve_options(endpoint, options);
+        std::unique_lock<std::shared_mutex> lock(channel_mutex_);
+        if (reactor_closing_) return std::make_error_code(std::errc::operation_canceled);
+        PubChannel* channel = nullptr;
+        if (const auto ec = create_pub_channel_locked(endpoint, resolved, channel)) return ec;
+        return enqueue_publish_locked(channel, message);
+    }
+
+    // Wait until everything published before this call has been handed to ZMQ, so a
+    // subscriber connected afterwards does not observe older messages.
+    void flush_outbox() {
+        std::promise<void> flushed;
+        auto done = flushed.get_future();
+        {
+            std::shared_lock<std::shared_mutex> lock(channel_mutex_);
+            if (reactor_closing_ || !reactor_thread_.joinable()) return;
+            if (reactor_thread_.get_id() == std::this_thread::get_id()) {
+                // Called from a handler or reply callback running on the reactor: nobody else
+                // can run the flush, so send the open batches in place. Publishes still queued
+                // behind the running command go out as soon as it returns.
+                flush_batches(/*only_due=*/false);
+                return;
             }
+            auto* cmd = new Command();
+            cmd->kind = Command::Kind::kFlush;
+            cmd->flushed = &flushed;
+            push_command(cmd);
         }
+        done.wait();
+    }
 
-        if (zmq_send(pub, message.data(), message.size(), 0) < 0) {
-            return make_zmq_error_from_errno();
+    // ---------------- Request / reply ----------------
+
+    static void complete_request(ReplyCallback on_reply, const std::shared_ptr<IExecutor>& executor,
+                                 ControlReply reply) {
+        if (!on_reply) return;
+        if (executor) {
+            executor->post([cb = std::move(on_reply), r = std::move(reply)]() mutable { cb(std::move(r)); });
+        } else {
+            on_reply(std::move(reply));
         }
+    }
+
+    void request(const std::string& endpoint, const std::string& payload, std::chrono::milliseconds timeout,
+                 ReplyCallback on_reply, std::shared_ptr<IExecutor> executor) {
+        auto cmd = std::make_unique<Command>();
+        cmd->kind = Command::Kind::kRequest;
+        cmd->deadline = std::chrono::steady_clock::now() + timeout;
+        if (const auto ec = copy_into(cmd->msg, payload)) {
+            complete_request(std::move(on_reply), executor, ControlReply{ec, {}});
+            return;
+        }
+        cmd->on_reply = std::move(on_reply);
+        cmd->executor = std::move(executor);
+
+        // While shutdown joins the reactor, callbacks running there fail fast instead of queueing.
+        const auto canceled = std::make_error_code(std::errc::operation_canceled);
+        bool closing = false;
+        {
+            std::shared_lock<std::shared_mutex> lock(channel_mutex_);
+            auto it = rpc_clients_.find(endpoint);
+            closing = reactor_closing_;
+            if (!closing && it != rpc_clients_.end()) {
+                cmd->client = it->second.get();
+                push_command(cmd.release());
+                return;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(channel_mutex_);
+        RpcClient* client = nullptr;
+        if (const auto ec = closing || reactor_closing_ ? canceled : create_rpc_client_locked(endpoint, client)) {
+            lock.unlock();
+            complete_request(std::move(cmd->on_reply), cmd->executor, ControlReply{ec, {}});
+            return;
+        }
+        cmd->client = client;
+        push_command(cmd.release());
+    }
+
+    [[nodiscard]] std::error_code serve(const std::string& endpoint, RequestHandler handler,
+                                        std::shared_ptr<IExecutor> executor) {
+        if (!handler) return std::make_error_code(std::errc::invalid_argument);
+
+        std::unique_lock<std::shared_mutex> lock(channel_mutex_);
+        if (reactor_closing_) return std::make_error_code(std::errc::operation_canceled);
+        if (rpc_servers_.find(endpoint) != rpc_servers_.end()) {
+            return std::make_error_code(std::errc::address_in_use);
+        }
+        if (const auto ec = ensure_reactor_locked()) return ec;
+
+        auto server = std::make_unique<RpcServer>();
+        server->endpoint = endpoint;
+        server->handler = std::move(handler);
+        server->executor = std::move(executor);
+        if (const auto ec = open_socket_locked(ZMQ_ROUTER, server->socket)) return ec;
+
+        if (zmq_bind(server->socket, endpoint.c_str()) != 0) {
+            const auto ec = make_zmq_error_from_errno();
+            zmq_close(server->socket);
+            return ec;
+        }
+
+        auto* watch = new Command();
+        watch->kind = Command::Kind::kWatchServer;
+        watch->server = server.get();
+        push_command(watch);
+
+        rpc_servers_[endpoint] = std::move(server);
         return {};
     }
 
+    // Called from any thread through a ControlResponder.
+    void enqueue_reply(RpcServer* server, std::string identity, uint64_t correlation_id,
+                       const std::string& reply) {
+        auto* cmd = new Command();
+        cmd->kind = Command::Kind::kReply;
+        cmd->server = server;
+        cmd->identity = std::move(identity);
+        cmd->correlation_id = correlation_id;
+        if (copy_into(cmd->msg, reply)) {
+            delete cmd;
+            return;
+        }
+        push_command(cmd);
+    }
+
+    ControlResponder make_responder(RpcServer* server, std::string identity, uint64_t correlation_id) {
+        return [gate = reply_gate_, server, id = std::move(identity), correlation_id](const std::string& reply) {
+            std::shared_lock<std::shared_mutex> lock(gate->mutex);
+            if (gate->impl != nullptr) gate->impl->enqueue_reply(server, id, correlation_id, reply);
+        };
+    }
+
+    // ---------------- Reactor thread ----------------
+
+    // Reads one frame; returns false when nothing is pending.
+    [[nodiscard]] static bool recv_frame(void* socket, zmq_msg_t& msg, bool& more) {
+        if (zmq_msg_recv(&msg, socket, ZMQ_DONTWAIT) < 0) return false;
+        more = zmq_msg_more(&msg) != 0;
+        return true;
+    }
+
+    static void skip_remaining_frames(void* socket, bool more) {
+        while (more) {
+            zmq_msg_t part;
+            zmq_msg_init(&part);
+            if (!recv_frame(socket, part, more)) more = false;
+            zmq_msg_close(&part);
+        }
+    }
+
+    void execute(Command* cmd) {
+        switch (cmd->kind) {
+            case Command::Kind::kPublish: {
+                PubChannel* channel = cmd->channel;
+                const uint64_t seq = number_and_cache(channel, cmd->msg);
+                if (channel->batching()) {
+                    append_to_batch(channel, cmd->msg, seq);
+                } else if (!channel->sequenced() || send_header(channel, seq)) {
+                    // PUB never blocks; a failed send is dropped exactly like an HWM drop.
+                    (void)zmq_msg_send(&cmd->msg, channel->socket, ZMQ_DONTWAIT);
+                }
+                break;
+            }
+            case Command::Kind::kFlush:
+                flush_batches(/*only_due=*/false);
+                cmd->flushed->set_value();
+                break;
+            case Command::Kind::kWatchClient:
+                watched_clients_.push_back(cmd->client);
+                break;
+            case Command::Kind::kWatchServer:
+                watched_servers_.push_back(cmd->server);
+                break;
+            case Command::Kind::kWatchPublisher:
+                watched_publishers_.push_back(cmd->channel);
+                break;
+            case Command::Kind::kRequest: {
+                const uint64_t id = next_correlation_id_++;
+                void* socket = cmd->client->socket;
+                if (zmq_send(socket, &id, sizeof(id), ZMQ_SNDMORE | ZMQ_DONTWAIT) < 0 ||
+                    zmq_msg_send(&cmd->msg, socket, ZMQ_DONTWAIT) < 0) {
+                    complete_request(std::move(cmd->on_reply), cmd->executor,
+                                     ControlReply{make_zmq_error_from_errno(), {}});
+                    break;
+                }
+                deadlines_.emplace(cmd->deadline, id);
+                pending_requests_.emplace(
+                    id, PendingRequest{std::move(cmd->on_reply), std::move(cmd->executor), cmd->deadline});
+                break;
+            }
+            case Command::Kind::kReply: {
+                void* socket = cmd->server->socket;
+                // ROUTER silently drops replies to peers that went away.
+                if (zmq_send(socket, cmd->identity.data(), cmd->identity.size(), ZMQ_SNDMORE | ZMQ_DONTWAIT) >= 0 &&
+                    zmq_send(socket, &cmd->correlation_id, sizeof(cmd->correlation_id),
+                             ZMQ_SNDMORE | ZMQ_DONTWAIT) >= 0) {
+                    (void)zmq_msg_send(&cmd->msg, socket, ZMQ_DONTWAIT);
+                }
+                break;
+            }
+        }
+    }
+
+    // ---------------- Sequencing / last-value cache (reactor thread) ----------------
+
+    // Returns the sequence number of the message being published (0 if the channel is plain).
+    static uint64_t number_and_cache(PubChannel* channel, zmq_msg_t& msg) {
+        if (!channel->sequenced()) return 0U;
+        const uint64_t seq = channel->next_sequence++;
+        if (channel->caches()) {
+            // zmq_msg_copy shares the buffer, no payload copy.
+            (void)zmq_msg_copy(&channel->last_value, &msg);
+            channel->has_last_value = true;
+            channel->last_value_sequence = seq;
+        }
+        return seq;
+    }
+
+    // Sends the header frame of a multipart message; `seq` numbers its first payload.
+    static bool send_header(PubChannel* channel, uint64_t seq) {
+        unsigned char header[kSequenceBytes];
+        std::memcpy(header, kSequenceMarker, sizeof(kSequenceMarker));
+        unsigned char flags = 0U;
+        if (channel->sequenced()) flags |= kFlagSequenced;
+        if (channel->caches()) flags |= kFlagLastValue;
+        header[sizeof(kSequenceMarker)] = flags;
+        std::memcpy(header + kIncarnationOffset, &channel->incarnation, sizeof(channel->incarnation));
+        std::memcpy(header + kSequenceOffset, &seq, sizeof(seq));
+        return zmq_send(channel->socket, header, sizeof(header), ZMQ_SNDMORE | ZMQ_DONTWAIT) >= 0;
+    }
+
+    // XPUB inbound frames are subscription events: 0x01 + prefix (subscribe), 0x00 (unsubscribe).
+    static void read_subscriptions(PubChannel* channel) {
+        bool replay = false;
+        while (true) {
+            zmq_msg_t event;
+            zmq_msg_init(&event);
+            bool more = false;
+            if (!recv_frame(channel->socket, event, more)) {
+                zmq_msg_close(&event);
+                break;
+            }
+            if (zmq_msg_size(&event) > 0U && static_cast<const uint8_t*>(zmq_msg_data(&event))[0] == 1U) {
+                replay = true;
+            }
+            zmq_msg_close(&event);
+            skip_remaining_frames(channel->socket, more);
+        }
+        if (!replay || !channel->has_last_value) return;
+
+        // Goes to every subscriber; the ones that already have it drop it by sequence number.
+        zmq_msg_t copy;
+        zmq_msg_init(&copy);
+        if (zmq_msg_copy(&copy, &channel->last_value) == 0 && send_header(channel, channel->last_value_sequence)) {
+            (void)zmq_msg_send(&copy, channel->socket, ZMQ_DONTWAIT);
+        }
+        zmq_msg_close(&copy);
+    }
+
+    // ---------------- Batching (reactor thread) ----------------
+
+    void append_to_batch(PubChannel* channel, zmq_msg_t& msg, uint64_t seq) {
+        if (channel->batch.empty()) {
+            channel->batch.reserve(channel->options.batch_max_messages);
+            channel->batch_deadline = std::chrono::steady_clock::now() + channel->options.batch_flush_interval;
+            channel->batch_sequence = seq;
+            open_batches_.push_back(channel);
+        }
+        channel->batch.emplace_back();
+        zmq_msg_init(&channel->batch.back());
+        (void)zmq_msg_move(&channel->batch.back(), &msg);
+        if (channel->batch.size() >= channel->options.batch_max_messages) send_batch(channel);
+    }
+
+    // Sends the batch as one multipart message: a header, then one frame per published message.
+    static void send_batch(PubChannel* channel) {
+        const std::size_t n = channel->batch.size();
+        if (send_header(channel, channel->batch_sequence)) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const int flags = ZMQ_DONTWAIT | (i + 1U < n ? ZMQ_SNDMORE : 0);
+                (void)zmq_msg_send(&channel->batch[i], channel->socket, flags);
+            }
+        }
+        for (auto& frame : channel->batch) zmq_msg_close(&frame);
+        channel->batch.clear();
+    }
+
+    void flush_batches(bool only_due) {
+        const auto now = std::chrono::steady_clock::now();
+        std::size_t keep = 0;
+        for (auto* channel : open_batches_) {
+            if (channel->batch.empty()) continue;  // already sent because it filled up
+            if (only_due && channel->batch_deadline > now) {
+                open_batches_[keep++] = channel;
+                continue;
+            }
+            send_batch(channel);
+        }
+        open_batches_.resize(keep);
+    }
+
+    // Poll timeout in ms until the earliest open batch is due (-1: none).
+    [[nodiscard]] long next_batch_timeout() const {
+        long timeout = -1;
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto* channel : open_batches_) {
+            if (channel->batch.empty()) continue;
+            const auto wait = std::chrono::ceil<std::chrono::milliseconds>(channel->batch_deadline - now);
+            const long ms = std::max<long>(0, static_cast<long>(wait.count()));
+            if (timeout < 0 || ms < timeout) timeout = ms;
+        }
+        return timeout;
+    }
+
+    std::size_t drain_commands() {
+        std::size_t n = 0;
+        while (Command* cmd = commands_.pop()) {
+            execute(cmd);
+            delete cmd;
+            ++n;
+        }
+        return n;
+    }
+
+    // DEALER frames: [correlation id][reply]
+    void read_replies(RpcClient* client) {
+        while (true) {
+            zmq_msg_t id_frame;
+            zmq_msg_init(&id_frame);
+            bool more = false;
+            if (!recv_frame(client->socket, id_frame, more)) {
+                zmq_msg_close(&id_frame);
+                return;
+            }
+            uint64_t id = 0;
+            const bool well_formed = more && zmq_msg_size(&id_frame) == sizeof(id);
+            if (well_formed) std::memcpy(&id, zmq_msg_data(&id_frame), sizeof(id));
+            zmq_msg_close(&id_frame);
+            if (!well_formed) {
+                skip_remaining_frames(client->socket, more);
+                continue;
+            }
+
+            zmq_msg_t body;
+            zmq_msg_init(&body);
+            if (!recv_frame(client->socket, body, more)) {
+                zmq_msg_close(&body);
+                return;
+            }
+            std::string reply(static_cast<const char*>(zmq_msg_data(&body)), zmq_msg_size(&body));
+            zmq_msg_close(&body);
+            skip_remaining_frames(client->socket, more);
+
+            // Unknown ids are late replies to requests that already timed out.
+            auto it = pending_requests_.find(id);
+            if (it == pending_requests_.end()) continue;
+            PendingRequest pending = std::move(it->second);
+            pending_requests_.erase(it);
+            complete_request(std::move(pending.on_reply), pending.executor, ControlReply{{}, std::move(reply)});
+        }
+    }
+
+    // ROUTER frames: [peer identity][correlation id][request]
+    void read_requests(RpcServer* server) {
+        while (true) {
+            zmq_msg_t frames[3];
+            std::size_t got = 0;
+            bool more = true;
+            for (; got < 3U && more; ++got) {
+                zmq_msg_init(&frames[got]);
+                if (!recv_frame(server->socket, frames[got], more)) {
+                    zmq_msg_close(&frames[got]);
+                    break;
+                }
+            }
+            if (got == 0U) return;
+            skip_remaining_frames(server->socket, more);
+
+            const bool well_formed = got == 3U && zmq_msg_size(&frames[1]) == sizeof(uint64_t);
+            if (well_formed) {
+                std::string identity(static_cast<const char*>(zmq_msg_data(&frames[0])), zmq_msg_size(&frames[0]));
+                uint64_t id = 0;
+                std::memcpy(&id, zmq_msg_data(&frames[1]), sizeof(id));
+                std::string request(static_cast<const char*>(zmq_msg_data(&frames[2])), zmq_msg_size(&frames[2]));
+
+                auto respond = make_responder(server, std::move(identity), id);
+                if (server->executor) {
+                    server->executor->post([handler = server->handler, req = std::move(request),
+                                            resp = std::move(respond)]() mutable { handler(req, std::move(resp)); });
+                } else {
+                    server->handler(request, std::move(respond));
+                }
+            }
+            for (std::size_t i = 0; i < got; ++i) zmq_msg_close(&frames[i]);
+        }
+    }
+
+    // Returns the poll timeout in ms until the next request deadline (-1: none).
+    long expire_requests() {
+        const auto now = std::chrono::steady_clock::now();
+        while (!deadlines_.empty()) {
+            const auto [deadline, id] = deadlines_.top();
+            if (deadline > now) {
+                const auto wait = std::chrono::ceil<std::chrono::milliseconds>(deadline - now);
+                return static_cast<long>(wait.count());
+            }
+            deadlines_.pop();
+            auto it = pending_requests_.find(id);
+            if (it == pending_requests_.end()) continue;  // already answered
+            PendingRequest pending = std::move(it->second);
+            pending_requests_.erase(it);
+            complete_request(std::move(pending.on_reply), pending.executor,
+                             ControlReply{std::make_error_code(std::errc::timed_out), {}});
+        }
+        return -1;
+    }
+
+    void reactor_loop() {
+        std::vector<zmq_pollitem_t> items;
+
+        while (true) {
+            if (drain_commands() > 0) continue;
+            flush_batches(/*only_due=*/true);
+            long timeout_ms = expire_requests();
+            const long batch_timeout_ms = next_batch_timeout();
+            if (timeout_ms < 0 || (batch_timeout_ms >= 0 && batch_timeout_ms < timeout_ms)) {
+                timeout_ms = batch_timeout_ms;
+            }
+            if (reactor_stop_.load(std::memory_order_acquire)) break;
+
+            items.clear();
+            items.push_back(zmq_pollitem_t{nullptr, wake_fd_, ZMQ_POLLIN, 0});
+            for (auto* client : watched_clients_) items.push_back(zmq_pollitem_t{client->socket, 0, ZMQ_POLLIN, 0});
+            for (auto* server : watched_servers_) items.push_back(zmq_pollitem_t{server->socket, 0, ZMQ_POLLIN, 0});
+            for (auto* pub : watched_publishers_) items.push_back(zmq_pollitem_t{pub->socket, 0, ZMQ_POLLIN, 0});
+
+            reactor_parked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // Re-check by popping: a command that arrived before we parked must not wait for the
+            // next wakeup.
+            if (Command* cmd = commands_.pop()) {
+                reactor_parked_.store(false, std::memory_order_relaxed);
+                execute(cmd);
+                delete cmd;
+                continue;
+            }
+            if (reactor_stop_.load(std::memory_order_relaxed)) {
+                reactor_parked_.store(false, std::memory_order_relaxed);
+                continue;
+            }
+
+            const int rc = zmq_poll(items.data(), static_cast<int>(items.size()), timeout_ms);
+            reactor_parked_.store(false, std::memory_order_relaxed);
+            if (rc <= 0) continue;
+
+            if ((items[0].revents & ZMQ_POLLIN) != 0) {
+                uint64_t value = 0;
+                (void)::read(wake_fd_, &value, sizeof(value));
+            }
+            std::size_t idx = 1;
+            for (auto* client : watched_clients_) {
+                if ((items[idx++].revents & ZMQ_POLLIN) != 0) read_replies(client);
+            }
+            for (auto* server : watched_servers_) {
+                if ((items[idx++].revents & ZMQ_POLLIN) != 0) read_requests(server);
+            }
+            for (auto* pub : watched_publishers_) {
+                if ((items[idx++].revents & ZMQ_POLLIN) != 0) read_subscriptions(pub);
+            }
+        }
+
+        // Callers are turned away by reactor_closing_ at this point; flush what is left and hand
+        // whatever is still waiting for a reply to finish_stop_reactor_locked(). It is failed only
+        // once shutdown released channel_mutex_, since a reply callback may publish or request.
+        (void)drain_commands();
+        flush_batches(/*only_due=*/false);
+        for (auto& [id, pending] : pending_requests_) canceled_requests_.push_back(std::move(pending));
+        pending_requests_.clear();
+        deadlines_ = {};
+        watched_clients_.clear();
+        watched_servers_.clear();
+        watched_publishers_.clear();
+    }
+
+    // Requires channel_mutex_ held exclusively and reactor_closing_ set. Tells the reactor to
+    // stop and hands its thread to the caller, who joins it after releasing channel_mutex_:
+    // handlers and reply callbacks running there may still call into the bus.
+    [[nodiscard]] std::thread begin_stop_reactor_locked() {
+        if (!reactor_thread_.joinable()) return {};
+
+        {
+            std::unique_lock<std::shared_mutex> gate_lock(reply_gate_->mutex);
+            reply_gate_->impl = nullptr;
+        }
+        reply_gate_.reset();
+
+        reactor_stop_.store(true, std::memory_order_seq_cst);
+        reactor_parked_.store(true, std::memory_order_seq_cst);
+        wake_reactor();
+        return std::move(reactor_thread_);
+    }
+
+    // Requires channel_mutex_ held exclusively and the reactor joined. Returns the requests that
+    // never got a reply; the caller fails them with fail_requests() after releasing channel_mutex_.
+    [[nodiscard]] std::vector<PendingRequest> finish_stop_reactor_locked() {
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        wake_fd_ = -1;
+        return std::exchange(canceled_requests_, {});
+    }
+
+    static void fail_requests(std::vector<PendingRequest> requests, std::errc error) {
+        for (auto& pending : requests) {
+            complete_request(std::move(pending.on_reply), pending.executor,
+                             ControlReply{std::make_error_code(error), {}});
+        }
+    }
+
+    // Header of a multipart message, if `frame` is one.
+    struct FrameHeader {
+        bool sequenced = false;
+        bool last_value = false;  // the publisher caches
+        uint32_t incarnation = 0;
+        uint64_t sequence = 0;  // of the first payload
+    };
+
+    [[nodiscard]] static bool parse_header(zmq_msg_t& frame, FrameHeader& out) {
+        const auto* data = static_cast<const unsigned char*>(zmq_msg_data(&frame));
+        if (zmq_msg_size(&frame) != kSequenceBytes || std::memcmp(data, kSequenceMarker, sizeof(kSequenceMarker)) != 0) {
+            return false;
+        }
+        const unsigned char flags = data[sizeof(kSequenceMarker)];
+        out.sequenced = (flags & kFlagSequenced) != 0U;
+        out.last_value = (flags & kFlagLastValue) != 0U;
+        std::memcpy(&out.incarnation, data + kIncarnationOffset, sizeof(out.incarnation));
+        std::memcpy(&out.sequence, data + kSequenceOffset, sizeof(out.sequence));
+        return true;
+    }
+
+    // Returns false if the payload numbered `seq` must not be delivered (duplicate).
+    static bool track_sequence(SubWorker* w, uint32_t incarnation, uint64_t seq) {
+        if (incarnation != w->incarnation) {
+            // A restarted publisher numbers from 1 again, and its first messages may be lost.
+            w->incarnation = incarnation;
+            w->last_sequence.store(0U, std::memory_order_relaxed);
+        }
+        const uint64_t last = w->last_sequence.load(std::memory_order_relaxed);
+        if (seq <= last) {
+            w->duplicates.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // The first message after joining (or after a restart) starts the count; it is not a gap.
+        if (last != 0U && seq > last + 1U) {
+            w->gaps.fetch_add(seq - last - 1U, std::memory_order_relaxed);
+        }
+        w->last_sequence.store(seq, std::memory_order_relaxed);
+        return true;
+    }
+
     void sub_worker_loop(SubWorker* w) {
         while (!w->stop.load(std::memory_order_relaxed)) {
+            if (w->has_joining.load(std::memory_order_acquire)) admit_joining(w);
             zmq_msg_t msg;
             zmq_msg_init(&msg);
 
@@ -124,31 +1293,98 @@ public:
                 // likely interrupted/shutdown
                 continue;
             }
-            const std::string recv_msg(
-                static_cast<const char*>(zmq_msg_data(&msg)),
-                static_cast<size_t>(zmq_msg_size(&msg)));
-
+            bool more = zmq_msg_more(&msg) != 0;
+            FrameHeader header;
+            // A single frame, or a multipart message from something other than this bus.
+            if (!more || !parse_header(msg, header)) deliver_control(w, msg, false);
             zmq_msg_close(&msg);
 
-            // dispatch callbacks for this endpoint (topic == endpoint)
-            std::vector<std::function<void(const std::string&)>> callbacks;
-            {
-                std::lock_guard<std::mutex> lock(control_mutex_);
-                auto it = control_topics_.find(w->endpoint);
-                if (it != control_topics_.end()) callbacks = it->second;
+            // ZMQ delivers a multipart message whole, so the rest is already here.
+            for (uint64_t seq = header.sequence; more; ++seq) {
+                zmq_msg_t frame;
+                zmq_msg_init(&frame);
+                if (zmq_msg_recv(&frame, w->socket, 0) < 0) {
+                    zmq_msg_close(&frame);
+                    break;
+                }
+                more = zmq_msg_more(&frame) != 0;
+                if (!header.sequenced || track_sequence(w, header.incarnation, seq)) deliver_control(w, frame, header.last_value);
+                zmq_msg_close(&frame);
             }
-            for (auto& cb : callbacks) {
-                cb(recv_msg);
+        }
+    }
+
+    void deliver_control(SubWorker* w, zmq_msg_t& frame, bool cached) {
+        const std::string recv_msg(static_cast<const char*>(zmq_msg_data(&frame)), zmq_msg_size(&frame));
+        w->received.fetch_add(1, std::memory_order_relaxed);
+
+        // dispatch callbacks for this endpoint (topic == endpoint)
+        TraceSpan span("bus.dispatch", "bus", w->endpoint);
+        if (cached) {
+            w->last_value = recv_msg;
+            w->has_last_value = true;
+        }
+        std::vector<std::function<void(const std::string&)>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(control_mutex_);
+            w->replays = w->replays || cached;
+            auto it = control_topics_.find(w->endpoint);
+            if (it != control_topics_.end()) callbacks = it->second;
+        }
+        for (auto& cb : callbacks) {
+            cb(recv_msg);
+        }
+    }
+
+    // Worker thread: replays the cached value to callbacks added since the last delivery, then
+    // registers them, so each gets it exactly once and before anything received later.
+    void admit_joining(SubWorker* w) {
+        std::vector<std::function<void(const std::string&)>> joining;
+        {
+            std::lock_guard<std::mutex> lock(control_mutex_);
+            joining.swap(w->joining);
+            w->has_joining.store(false, std::memory_order_relaxed);
+        }
+        for (auto& cb : joining) {
+            if (w->has_last_value) cb(w->last_value);
+            std::lock_guard<std::mutex> lock(control_mutex_);
+            control_topics_[w->endpoint].push_back(std::move(cb));
+        }
+    }
+
+    sx::types::ControlChannelStats channel_stats(const std::string& endpoint) {
+        sx::types::ControlChannelStats stats;
+        if (is_inproc_endpoint(endpoint)) {
+            if (auto channel = find_local(endpoint)) {
+                stats.received = channel->delivered.load(std::memory_order_relaxed);
             }
+            return stats;
         }
+
+        std::lock_guard<std::mutex> lock(zmq_mutex_);
+        auto it = sub_workers_.find(endpoint);
+        if (it == sub_workers_.end() || !it->second) return stats;
+        const auto& w = *it->second;
+        stats.received = w.received.load(std::memory_order_relaxed);
+        stats.gaps = w.gaps.load(std::memory_order_relaxed);
+        stats.duplicates = w.duplicates.load(std::memory_order_relaxed);
+        stats.last_sequence = w.last_sequence.load(std::memory_order_relaxed);
+        return stats;
     }
 
     [[nodiscard]] std::error_code subscribe_control(const std::string& endpoint,
-                                                    std::function<void(const std::string&)> callback) {
+                                                    std::function<void(const std::string&)> callback,
+                                                    const sx::types::ControlChannelOptions* options = nullptr) {
+        if (is_inproc_endpoint(endpoint)) return subscribe_local(endpoint, std::move(callback), options);
+
+        flush_outbox();
+        const auto resolved = resolve_options(endpoint, options);
+
         std::lock_guard<std::mutex> lock(zmq_mutex_);
         if (const auto ec = ensure_zmq_context_locked()) return ec;
 
-        if (sub_workers_.find(endpoint) == sub_workers_.end()) {
+        auto existing = sub_workers_.find(endpoint);
+        if (existing == sub_workers_.end()) {
             auto worker = std::make_unique<SubWorker>();
             worker->endpoint = endpoint;
 
@@ -161,6 +1397,7 @@ public:
             (void)zmq_setsockopt(worker->socket, ZMQ_LINGER, &linger, sizeof(linger));
             const int rcvtimeo = 100; // ms, for cooperative shutdown
             (void)zmq_setsockopt(worker->socket, ZMQ_RCVTIMEO, &rcvtimeo, sizeof(rcvtimeo));
+            apply_channel_options(worker->socket, resolved);
 
             if (zmq_connect(worker->socket, endpoint.c_str()) != 0) {
                 const auto ec = make_zmq_error_from_errno();
@@ -172,20 +1409,34 @@ public:
             // Subscribe to all messages on this endpoint.
             (void)zmq_setsockopt(worker->socket, ZMQ_SUBSCRIBE, "", 0);
 
+            // Register before the receive thread starts: a last-value replay can arrive
+            // immediately and must not be dispatched to an empty callback list.
+            {
+                std::lock_guard<std::mutex> c_lock(control_mutex_);
+                control_topics_[endpoint].push_back(std::move(callback));
+            }
+
             SubWorker* raw = worker.get();
             raw->thread = std::thread([this, raw]() { sub_worker_loop(raw); }); // TODO(luke): 使用内存池管理
             sub_workers_[endpoint] = std::move(worker);
+            return {};
         }
 
-        {
-            std::lock_guard<std::mutex> c_lock(control_mutex_);
+        // This bus's SUB socket is already subscribed, so a caching publisher will not replay
+        // to the newcomer; its worker does.
+        SubWorker* w = existing->second.get();
+        std::lock_guard<std::mutex> c_lock(control_mutex_);
+        if (w->replays) {
+            w->joining.push_back(std::move(callback));
+            w->has_joining.store(true, std::memory_order_release);
+        } else {
             control_topics_[endpoint].push_back(std::move(callback));
         }
-
         return {};
     }
 
     void shutdown_zmq() {
+        std::lock_guard<std::mutex> shutdown_lock(shutdown_mutex_);
         // stop receive threads
         {
             std::lock_guard<std::mutex> lock(zmq_mutex_);
@@ -199,21 +1450,46 @@ public:
             if (w && w->thread.joinable()) w->thread.join();
         }
 
-        // close sockets and context
-        std::lock_guard<std::mutex> lock(zmq_mutex_);
-        for (auto& [endpoint, sock] : pub_sockets_) {
-            if (sock != nullptr) zmq_close(sock);
+        // Stop the reactor and join it without channel_mutex_, then close its sockets. Callers
+        // are turned away until the context is gone (lock order: channel_mutex_ -> zmq_mutex_).
+        std::thread reactor;
+        {
+            std::unique_lock<std::shared_mutex> ch_lock(channel_mutex_);
+            reactor_closing_ = true;
+            reactor = begin_stop_reactor_locked();
         }
+        if (reactor.joinable()) reactor.join();
+
+        std::unique_lock<std::shared_mutex> ch_lock(channel_mutex_);
+        auto canceled = finish_stop_reactor_locked();
+        for (auto& [endpoint, channel] : pub_channels_) {
+            if (channel && channel->socket != nullptr) zmq_close(channel->socket);
+        }
+        for (auto& [endpoint, client] : rpc_clients_) {
+            if (client && client->socket != nullptr) zmq_close(client->socket);
+        }
+        for (auto& [endpoint, server] : rpc_servers_) {
+            if (server && server->socket != nullptr) zmq_close(server->socket);
+        }
+        pub_channels_.clear();
+        rpc_clients_.clear();
+        rpc_servers_.clear();
+
+        // close sockets and context
+        std::unique_lock<std::mutex> lock(zmq_mutex_);
         for (auto& [endpoint, w] : sub_workers_) {
             if (w && (w->socket != nullptr)) zmq_close(w->socket);
         }
-        pub_sockets_.clear();
         sub_workers_.clear();
 
         if (zmq_context_ != nullptr) {
             zmq_ctx_term(zmq_context_);
             zmq_context_ = nullptr;
         }
+        lock.unlock();
+        reactor_closing_ = false;  // the bus can be used again and starts afresh
+        ch_lock.unlock();
+        fail_requests(std::move(canceled), std::errc::operation_canceled);
     }
 
     void shutdown() {
@@ -240,11 +1516,17 @@ public:
             stream_topics_.clear();
         }
 
+        {
+            std::unique_lock<std::shared_mutex> l_lock(local_mutex_);
+            local_channels_.clear();
+        }
+
         std::lock_guard<std::mutex> c_lock(control_mutex_);
         control_topics_.clear();
     }
 
     void publish_stream(const std::string& topic, std::shared_ptr<void> data) {
+        TraceSpan span("bus.publish_stream", "bus", topic);
         std::shared_ptr<StreamTopic> topic_ptr;
         {
             std::lock_guard<std::mutex> lock(stream_mutex_);
@@ -290,7 +1572,10 @@ public:
         }
         
         // 返回 shared_ptr<void> 进行类型擦除，头文件会将其转回
-        return std::static_pointer_cast<void>(new_queue);
+        // 消费端看到的是带 trace 的包装；publish 仍直接写入内部队列
+        return std::static_pointer_cast<void>(
+            std::static_pointer_cast<sx::utils::IQueue<std::shared_ptr<void>>>(
+                std::make_shared<TracedStreamQueue>(std::move(new_queue), topic)));
     }
 };
 
@@ -311,6 +1596,70 @@ std::error_code UnifiedBus::subscribe(const std::string& topic, std::function<vo
     return impl_->subscribe_control(topic, std::move(callback));
 }
 
+std::error_code UnifiedBus::publish(const std::string& topic, const std::string& message,
+                                    const sx::types::ControlChannelOptions& options) {
+    return impl_->publish_control(topic, message, &options);
+}
+
+std::error_code UnifiedBus::subscribe(const std::string& topic, std::function<void(const std::string&)> callback,
+                                      const sx::types::ControlChannelOptions& options) {
+    return impl_->subscribe_control(topic, std::move(callback), &options);
+}
+
+void UnifiedBus::set_channel_options(const std::string& endpoint, const sx::types::ControlChannelOptions& options) {
+    std::lock_guard<std::mutex> lock(impl_->options_mutex_);
+    impl_->channel_options_[endpoint] = options;
+}
+
+std::size_t UnifiedBus::load_channel_options(const ConfigManager& config, const std::string& key_path) {
+    std::size_t loaded = 0;
+    for (std::size_t i = 0;; ++i) {
+        const std::string base = key_path + "." + std::to_string(i) + ".";
+        const auto endpoint = config.get<std::string>(base + "endpoint", "");
+        if (endpoint.empty()) break;
+
+        sx::types::ControlChannelOptions opts;
+        opts.conflate = config.get<bool>(base + "conflate", opts.conflate);
+        opts.send_hwm = config.get<int>(base + "send_hwm", opts.send_hwm);
+        opts.recv_hwm = config.get<int>(base + "recv_hwm", opts.recv_hwm);
+        const int batch = config.get<int>(base + "batch_max_messages", 0);
+        opts.batch_max_messages = batch > 0 ? static_cast<std::size_t>(batch) : 0U;
+        opts.sequenced = config.get<bool>(base + "sequenced", opts.sequenced);
+        opts.last_value_cache = config.get<bool>(base + "last_value_cache", opts.last_value_cache);
+        const int flush_us = config.get<int>(base + "batch_flush_interval_us",
+                                             static_cast<int>(opts.batch_flush_interval.count()));
+        opts.batch_flush_interval = std::chrono::microseconds(std::max(0, flush_us));
+
+        set_channel_options(endpoint, opts);
+        ++loaded;
+    }
+    return loaded;
+}
+
+void UnifiedBus::request(const std::string& endpoint, const std::string& payload,
+                         std::chrono::milliseconds timeout, ReplyCallback on_reply,
+                         std::shared_ptr<IExecutor> executor) {
+    impl_->request(endpoint, payload, timeout, std::move(on_reply), std::move(executor));
+}
+
+std::future<ControlReply> UnifiedBus::request(const std::string& endpoint, const std::string& payload,
+                                              std::chrono::milliseconds timeout) {
+    auto promise = std::make_shared<std::promise<ControlReply>>();
+    auto fut = promise->get_future();
+    impl_->request(endpoint, payload, timeout,
+                   [promise](ControlReply reply) { promise->set_value(std::move(reply)); }, nullptr);
+    return fut;
+}
+
+std::error_code UnifiedBus::serve(const std::string& endpoint, RequestHandler handler,
+                                  std::shared_ptr<IExecutor> executor) {
+    return impl_->serve(endpoint, std::move(handler), std::move(executor));
+}
+
+sx::types::ControlChannelStats UnifiedBus::channel_stats(const std::string& endpoint) const {
+    return impl_->channel_stats(endpoint);
+}
+
 void UnifiedBus::shutdown() {
     impl_->shutdown();
 }
@@ -0,0 +1,203 @@
+/**
+ * @file watchdog.cpp
+ * @brief Watchdog implementation and StallReport formatting
+ */
+
+#include "watchdog.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace sx::infra {
+
+namespace {
+
+using ThreadClass = sx::hal::IThreadScheduler::ThreadClass;
+
+int64_t now_ns() noexcept {
+    timespec ts{};
+    (void)::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int64_t to_ns(std::chrono::milliseconds ms) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ms).count();
+}
+
+const char* class_name(ThreadClass cls) noexcept {
+    switch (cls) {
+        case ThreadClass::kIo: return "io";
+        case ThreadClass::kCpu: return "cpu";
+        case ThreadClass::kCritical: return "critical";
+    }
+    return "?";
+}
+
+}  // namespace
+
+thread_local Watchdog::Slot* Watchdog::current_ = nullptr;
+
+std::string to_string(const StallReport& report) {
+    std::string out;
+    switch (report.kind) {
+        case StallKind::kTaskOverrun: out = "task overrun on "; break;
+        case StallKind::kLoopLag: out = "event loop lag on "; break;
+        case StallKind::kCriticalSilent: out = "critical loop silent on "; break;
+    }
+    out += class_name(report.thread_class);
+    if (report.kind == StallKind::kLoopLag) {
+        out += " pool";
+        if (report.thread_class == ThreadClass::kIo) out += " shard " + std::to_string(report.index);
+    } else {
+        out += report.thread_class == ThreadClass::kCritical ? " loop " : " worker ";
+        out += std::to_string(report.index);
+        out += " (tid " + std::to_string(report.thread_id) + ")";
+    }
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(report.stalled_for).count();
+    out += ": " + std::to_string(ms) + " ms";
+    return out;
+}
+
+Watchdog::Watchdog(const WatchdogOptions& options, std::size_t io_n, std::size_t cpu_n, std::size_t io_shards,
+                   Report report)
+    : options_(options), report_(std::move(report)), io_n_(io_n) {
+    workers_.reserve(io_n + cpu_n);
+    for (std::size_t i = 0; i < io_n + cpu_n; ++i) {
+        auto slot = std::make_unique<Slot>();
+        slot->cls = i < io_n ? ThreadClass::kIo : ThreadClass::kCpu;
+        slot->index = i < io_n ? i : i - io_n;
+        workers_.push_back(std::move(slot));
+    }
+    for (std::size_t i = 0; i <= io_shards; ++i) {
+        auto beat = std::make_unique<Beat>();
+        beat->cls = i < io_shards ? ThreadClass::kIo : ThreadClass::kCpu;
+        beat->shard = i < io_shards ? i : 0U;
+        beats_.push_back(std::move(beat));
+    }
+}
+
+Watchdog::~Watchdog() { stop(); }
+
+void Watchdog::bind(Slot& slot) {
+    slot.tid.store(static_cast<int64_t>(::syscall(SYS_gettid)), std::memory_order_relaxed);
+    current_ = &slot;
+}
+
+void Watchdog::bind_worker(ThreadClass cls, std::size_t index) {
+    const std::size_t i = cls == ThreadClass::kIo ? index : io_n_ + index;
+    if (i < workers_.size()) bind(*workers_[i]);
+}
+
+void Watchdog::bind_critical(std::size_t index) {
+    auto slot = std::make_unique<Slot>();
+    slot->cls = ThreadClass::kCritical;
+    slot->index = index;
+    bind(*slot);
+    std::lock_guard<std::mutex> lock(critical_mutex_);
+    critical_.push_back(std::move(slot));
+}
+
+void Watchdog::run(sx::utils::Task& task) {
+    Slot* slot = current_;
+    if (slot == nullptr) {
+        task();
+        return;
+    }
+    struct Stamp {
+        Slot* slot;
+        int64_t outer;
+        ~Stamp() { slot->since_ns.store(outer == 0 ? 0 : now_ns(), std::memory_order_release); }
+    } stamp{slot, slot->since_ns.load(std::memory_order_relaxed)};
+    slot->seq.fetch_add(1, std::memory_order_relaxed);
+    slot->since_ns.store(now_ns(), std::memory_order_release);
+    task();
+}
+
+void Watchdog::kick() noexcept {
+    Slot* slot = current_;
+    if (slot == nullptr || slot->cls != ThreadClass::kCritical) return;
+    slot->seq.fetch_add(1, std::memory_order_relaxed);
+    slot->since_ns.store(now_ns(), std::memory_order_release);
+}
+
+void Watchdog::release_current() noexcept {
+    if (current_ != nullptr) current_->since_ns.store(0, std::memory_order_release);
+    current_ = nullptr;
+}
+
+void Watchdog::start(PostHeartbeat post) {
+    post_ = std::move(post);
+    thread_ = std::thread([this]() { monitor_loop(); });
+}
+
+void Watchdog::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void Watchdog::monitor_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, options_.check_period, [this]() { return stopping_; })) {
+        lock.unlock();
+        const int64_t now = now_ns();
+        for (auto& slot : workers_) check_slot(*slot, now, to_ns(options_.task_budget));
+        {
+            std::lock_guard<std::mutex> critical_lock(critical_mutex_);
+            for (auto& slot : critical_) check_slot(*slot, now, to_ns(options_.critical_budget));
+        }
+        for (auto& beat : beats_) check_beat(*beat, now);
+        lock.lock();
+    }
+}
+
+void Watchdog::check_slot(Slot& slot, int64_t now, int64_t budget) {
+    // seq is read on both sides so a task that ends (and another starts) in between is not
+    // blamed for the old start time.
+    const uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    const int64_t since = slot.since_ns.load(std::memory_order_acquire);
+    if (since == 0 || seq != slot.seq.load(std::memory_order_relaxed)) return;
+    if (now - since <= budget || seq == slot.reported_seq) return;
+    slot.reported_seq = seq;
+
+    StallReport report;
+    report.kind = slot.cls == ThreadClass::kCritical ? StallKind::kCriticalSilent : StallKind::kTaskOverrun;
+    report.thread_class = slot.cls;
+    report.index = slot.index;
+    report.thread_id = slot.tid.load(std::memory_order_relaxed);
+    report.stalled_for = std::chrono::nanoseconds{now - since};
+    if (report_) report_(report);
+}
+
+void Watchdog::check_beat(Beat& beat, int64_t now) {
+    const int64_t pending = beat.pending_since.load(std::memory_order_acquire);
+    if (pending != 0) {
+        if (!beat.reported && now - pending > to_ns(options_.lag_budget)) {
+            beat.reported = true;
+            StallReport report;
+            report.kind = StallKind::kLoopLag;
+            report.thread_class = beat.cls;
+            report.index = beat.shard;
+            report.stalled_for = std::chrono::nanoseconds{now - pending};
+            if (report_) report_(report);
+        }
+        return;
+    }
+
+    beat.reported = false;
+    beat.pending_since.store(now, std::memory_order_release);
+    auto self = shared_from_this();
+    if (!post_(beat.cls, beat.shard, [self, b = &beat]() { b->pending_since.store(0, std::memory_order_release); })) {
+        beat.pending_since.store(0, std::memory_order_release);
+    }
+}
+
+}  // namespace sx::infra
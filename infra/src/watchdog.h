@@ -0,0 +1,105 @@
+/**
+ * @file watchdog.h
+ * @brief Stall detection behind RuntimeOptions::watchdog (private header)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sx/infra/watchdog.h"
+#include "sx/utils/task.h"
+
+namespace sx::infra {
+
+// Workers publish "running since" in a per-thread slot; the monitor thread only reads the
+// slots, so the hot path never contends. Stamps use CLOCK_MONOTONIC_COARSE (a few ns to read,
+// jiffy resolution), which is plenty for budgets in the tens of milliseconds, and tasks are
+// stamped where they run rather than wrapped, so watching a task allocates nothing.
+class Watchdog : public std::enable_shared_from_this<Watchdog> {
+public:
+    using ThreadClass = sx::hal::IThreadScheduler::ThreadClass;
+    using Report = std::function<void(const StallReport&)>;
+    // Posts a heartbeat to the pool of `cls` (IO: to context `shard`); false if the pool no
+    // longer accepts work.
+    using PostHeartbeat = std::function<bool(ThreadClass cls, std::size_t shard, sx::utils::Task beat)>;
+
+    // `io_shards` IO contexts each get their own heartbeat (see IoPoolKind::kPerThread).
+    Watchdog(const WatchdogOptions& options, std::size_t io_n, std::size_t cpu_n, std::size_t io_shards,
+             Report report);
+
+    // Inside worker `index` of `cls` (IO or CPU), before it runs any task.
+    void bind_worker(ThreadClass cls, std::size_t index);
+    // Inside critical loop `index`; the loop is watched from its first kick().
+    void bind_critical(std::size_t index);
+
+    // Runs `task` stamped on the calling thread's slot (plain call on unbound threads). A task
+    // run from inside another (e.g. a strand batch) restarts the outer stamp when it returns,
+    // so a dispatcher is judged by the time since its last completed task.
+    static void run(sx::utils::Task& task);
+    // Critical loop liveness signal; no-op on threads without a slot.
+    static void kick() noexcept;
+    // The calling thread's loop has ended; its slot is no longer checked.
+    static void release_current() noexcept;
+
+    void start(PostHeartbeat post);
+    // Joins the monitor thread. Heartbeats still queued complete harmlessly.
+    void stop();
+
+    Watchdog(const Watchdog&) = delete;
+    Watchdog& operator=(const Watchdog&) = delete;
+    Watchdog(Watchdog&&) = delete;
+    Watchdog& operator=(Watchdog&&) = delete;
+    ~Watchdog();
+
+private:
+    struct alignas(64) Slot {
+        ThreadClass cls = ThreadClass::kCpu;
+        std::size_t index = 0;
+        std::atomic<int64_t> tid{0};
+        // Workers: start of the running task, 0 while idle. Critical loops: last kick, 0 before
+        // the first one.
+        std::atomic<int64_t> since_ns{0};
+        std::atomic<uint64_t> seq{0};            // bumped on every task start / kick
+        uint64_t reported_seq = UINT64_MAX;      // monitor only
+    };
+
+    struct Beat {
+        ThreadClass cls = ThreadClass::kIo;
+        std::size_t shard = 0;
+        std::atomic<int64_t> pending_since{0};  // 0 when no heartbeat is queued
+        bool reported = false;                  // monitor only
+    };
+
+    // Slot of the calling thread, so wrap() and kick() need no Watchdog pointer.
+    static thread_local Slot* current_;
+
+    void bind(Slot& slot);
+    void monitor_loop();
+    void check_slot(Slot& slot, int64_t now, int64_t budget);
+    void check_beat(Beat& beat, int64_t now);
+
+    const WatchdogOptions options_;
+    const Report report_;
+    PostHeartbeat post_;
+
+    std::vector<std::unique_ptr<Slot>> workers_;  // IO first, then CPU
+    std::size_t io_n_ = 0;
+    std::mutex critical_mutex_;
+    std::vector<std::unique_ptr<Slot>> critical_;
+    std::vector<std::unique_ptr<Beat>> beats_;  // one per IO shard, then the CPU pool
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+}  // namespace sx::infra
@@ -0,0 +1,308 @@
+/**
+ * @file work_stealing_pool.cpp
+ * @brief WorkStealingPool implementation
+ */
+
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "sx/infra/node_cache.h"
+
+namespace sx::infra {
+
+namespace {
+
+struct CurrentWorker {
+    const void* pool = nullptr;
+    void* worker = nullptr;
+    bool housekeeping = false;  // set by the running task through mark_housekeeping()
+};
+
+thread_local CurrentWorker tls_current;
+
+// Injected tasks moved into the local deque per drain; the rest stay visible to others.
+constexpr std::size_t kInjectBatch = 32U;
+
+// Steal rounds before a worker parks.
+constexpr int kSpinRounds = 64;
+
+uint32_t next_random(uint32_t& state) noexcept {
+    // xorshift32: cheap, per-thread, good enough for victim selection.
+    state ^= state << 13U;
+    state ^= state >> 17U;
+    state ^= state << 5U;
+    return state;
+}
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool() = default;
+
+WorkStealingPool::~WorkStealingPool() { stop(); }
+
+void WorkStealingPool::start(std::size_t n, ThreadStartHook on_start, RunHook run_hook, const Elastic& elastic,
+                             AfterTaskHook after_task) {
+    stop_.store(false, std::memory_order_relaxed);
+    run_hook_ = run_hook;
+    on_start_ = std::move(on_start);
+    after_task_ = std::move(after_task);
+    retire_after_ = elastic.retire_after;
+    const std::size_t initial = elastic.initial == 0U ? n : std::min(elastic.initial, n);
+    min_live_.store(std::min(std::max<std::size_t>(elastic.min, 1U), initial), std::memory_order_relaxed);
+    max_live_.store(n, std::memory_order_relaxed);
+
+    workers_.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto w = std::make_unique<Worker>();
+        w->index = i;
+        workers_.push_back(std::move(w));
+    }
+    // Start threads only after the worker table is complete: thieves index into it.
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    for (std::size_t i = 0; i < initial; ++i) launch_locked(*workers_[i]);
+}
+
+void WorkStealingPool::launch_locked(Worker& worker) {
+    if (worker.thread.joinable()) worker.thread.join();  // a retired worker, already exiting
+    worker.running = true;
+    live_.fetch_add(1, std::memory_order_relaxed);
+    Worker* raw = &worker;
+    worker.thread = std::thread([this, raw]() { worker_loop(raw); });
+}
+
+bool WorkStealingPool::grow(std::size_t max) {
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    if (stop_.load(std::memory_order_relaxed)) return false;
+    max = std::min(max, max_live_.load(std::memory_order_relaxed));
+    if (live_.load(std::memory_order_relaxed) >= max) return false;
+    for (auto& w : workers_) {
+        if (!w->running) {
+            launch_locked(*w);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::set_limits(std::size_t min, std::size_t max) noexcept {
+    max = std::min(std::max<std::size_t>(max, 1U), workers_.size());
+    min_live_.store(std::min(std::max<std::size_t>(min, 1U), max), std::memory_order_relaxed);
+    max_live_.store(max, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    park_cv_.notify_all();  // surplus workers re-check their limits
+}
+
+bool WorkStealingPool::try_retire(std::size_t floor) noexcept {
+    std::size_t live = live_.load(std::memory_order_relaxed);
+    while (live > floor) {
+        if (live_.compare_exchange_weak(live, live - 1U, std::memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::stop() {
+    {
+        // Under grow_mutex_ so no grow() starts a slot after this; joined outside it because
+        // retiring workers take it on their way out.
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        stop_.store(true, std::memory_order_seq_cst);
+    }
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_cv_.notify_all();
+    }
+    for (auto& w : workers_) {
+        if (w->thread.joinable()) w->thread.join();
+        w->running = false;
+    }
+    live_.store(0, std::memory_order_relaxed);
+    discard_pending();
+    workers_.clear();
+}
+
+void WorkStealingPool::post(Task task, std::uint64_t flow) {
+    Node* node = NodeCache<Node>::acquire();
+    node->fn = std::move(task);
+    node->flow = flow;
+
+    if (tls_current.pool == this) {
+        static_cast<Worker*>(tls_current.worker)->deque.push(node);
+    } else {
+        injection_.push(node);
+    }
+    notify_one();
+}
+
+bool WorkStealingPool::running_in_this_thread() const noexcept { return tls_current.pool == this; }
+
+void WorkStealingPool::mark_housekeeping() noexcept { tls_current.housekeeping = true; }
+
+void WorkStealingPool::notify_one() {
+    // Dekker pairing with the park path in worker_loop().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) == 0U) return;
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    park_cv_.notify_one();
+}
+
+WorkStealingPool::Node* WorkStealingPool::take_injected(Worker* self, bool* busy) {
+    // Only the current consumer can tell whether the queue is empty, so just try to become it.
+    // `busy` reports that another worker was: the queue may hold a task it already looked past.
+    if (injection_busy_.load(std::memory_order_relaxed) ||
+        injection_busy_.exchange(true, std::memory_order_acquire)) {
+        if (busy != nullptr) *busy = true;
+        return nullptr;
+    }
+
+    Node* first = injection_.pop();
+    if (first != nullptr) {
+        for (std::size_t i = 1; i < kInjectBatch; ++i) {
+            Node* more = injection_.pop();
+            if (more == nullptr) break;
+            self->deque.push(more);
+        }
+    }
+    injection_busy_.store(false, std::memory_order_release);
+    return first;
+}
+
+WorkStealingPool::Node* WorkStealingPool::steal(Worker* self, uint32_t& rng_state) {
+    const std::size_t n = workers_.size();
+    if (n <= 1U) return nullptr;
+    const std::size_t start = next_random(rng_state) % n;
+    for (std::size_t i = 0; i < n; ++i) {
+        Worker* victim = workers_[(start + i) % n].get();
+        if (victim == self) continue;
+        Node* node = nullptr;
+        if (victim->deque.steal(node)) return node;
+    }
+    return nullptr;
+}
+
+WorkStealingPool::Node* WorkStealingPool::find_work(Worker* self, uint32_t& rng_state) {
+    Node* node = nullptr;
+    if (self->deque.pop(node)) return node;
+    if ((node = take_injected(self)) != nullptr) {
+        // Others may steal what was just moved into our deque.
+        if (!self->deque.empty()) notify_one();
+        return node;
+    }
+    return steal(self, rng_state);
+}
+
+bool WorkStealingPool::has_visible_work() const noexcept {
+    for (const auto& w : workers_) {
+        if (!w->deque.empty()) return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(Worker* self) {
+    tls_current.pool = this;
+    tls_current.worker = self;
+    if (on_start_) on_start_(self->index);
+
+    uint32_t rng_state = static_cast<uint32_t>(self->index * 2654435761U + 1U);
+    int idle_rounds = 0;
+    const bool elastic = retire_after_.count() > 0;
+    auto last_work = std::chrono::steady_clock::now();
+    bool idle = false;  // counted in idle_
+
+    while (!stop_.load(std::memory_order_relaxed)) {
+        if (Node* node = find_work(self, rng_state)) {
+            if (idle) idle_.fetch_sub(1, std::memory_order_relaxed);
+            idle = false;
+            idle_rounds = 0;
+            tls_current.housekeeping = false;
+            if (node->fn) {
+                if (run_hook_ != nullptr) {
+                    run_hook_(node->fn, node->flow);
+                } else {
+                    node->fn();
+                }
+            }
+            node->fn.reset();
+            NodeCache<Node>::release(node);
+            if (after_task_) after_task_();
+            if (!elastic) continue;
+            const auto now = std::chrono::steady_clock::now();
+            if (!tls_current.housekeeping) {
+                last_work = now;
+            } else if (now - last_work >= retire_after_ && self->deque.empty() &&
+                       try_retire(min_live_.load(std::memory_order_relaxed))) {
+                // Only supervisor probes for a whole retire_after; on a busy box one is nearly
+                // always queued by the time we would park, so do not wait for the park path.
+                break;
+            }
+            continue;
+        }
+
+        if (!idle) idle_.fetch_add(1, std::memory_order_relaxed);
+        idle = true;
+
+        // Idle with an empty deque: a surplus worker (limits were lowered) leaves right away.
+        if (try_retire(max_live_.load(std::memory_order_relaxed))) break;
+
+        if (++idle_rounds < kSpinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        bool retire = false;
+        // Pop, not peek: a task injected before we counted ourselves as a sleeper must not wait
+        // for the next post. Whatever take_injected() moved into our deque is run next round.
+        // If another worker held the queue, a task may have arrived after its last pop and
+        // before our count; that worker may be busy with a long task by now, so retry instead
+        // of parking.
+        bool injection_busy = false;
+        Node* injected = stop_.load(std::memory_order_relaxed) ? nullptr : take_injected(self, &injection_busy);
+        if (injected == nullptr && injection_busy) {
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+        if (injected == nullptr && !stop_.load(std::memory_order_relaxed) && !has_visible_work()) {
+            if (elastic) {
+                // No real work for a whole retire_after: hand the thread back.
+                const auto idle_for = std::chrono::steady_clock::now() - last_work;
+                if (idle_for < retire_after_) (void)park_cv_.wait_for(lock, retire_after_ - idle_for);
+                if (std::chrono::steady_clock::now() - last_work >= retire_after_ && !has_visible_work()) {
+                    injection_busy = false;
+                    injected = take_injected(self, &injection_busy);
+                    retire = injected == nullptr && !injection_busy &&
+                             try_retire(min_live_.load(std::memory_order_relaxed));
+                }
+            } else {
+                park_cv_.wait(lock);
+            }
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        // Others may steal the rest of the batch; we hold park_mutex_, so no notify_one().
+        if (injected != nullptr && !self->deque.empty()) park_cv_.notify_one();
+        lock.unlock();
+        idle_rounds = 0;
+        if (injected != nullptr) self->deque.push(injected);
+        if (retire) break;
+    }
+
+    if (idle) idle_.fetch_sub(1, std::memory_order_relaxed);
+    tls_current = CurrentWorker{};
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    self->running = false;
+}
+
+void WorkStealingPool::discard_pending() {
+    // Workers are joined: every deque and the injection queue are quiescent.
+    for (auto& w : workers_) {
+        Node* node = nullptr;
+        while (w->deque.pop(node)) delete node;
+    }
+    while (Node* node = injection_.pop()) delete node;
+}
+
+}  // namespace sx::infra
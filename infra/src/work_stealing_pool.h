@@ -0,0 +1,127 @@
+/**
+ * @file work_stealing_pool.h
+ * @brief Work-stealing CPU pool used by AsyncRuntime (private header)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sx/utils/mpsc_queue.h"
+#include "sx/utils/task.h"
+#include "sx/utils/work_stealing_deque.h"
+
+namespace sx::infra {
+
+// One Chase-Lev deque per worker. Tasks posted from a worker go to its own deque and are
+// popped LIFO (cache-hot); idle workers steal FIFO from a random victim. Tasks posted from
+// outside the pool go through a lock-free MPSC injection queue that one worker at a time
+// drains into its deque. Idle workers park on a condition variable, which posters only
+// touch when somebody is actually parked.
+class WorkStealingPool {
+public:
+    using Task = sx::utils::Task;
+    using ThreadStartHook = std::function<void(std::size_t index)>;
+
+    WorkStealingPool();
+    ~WorkStealingPool();
+
+    // Called by workers instead of task() when set, with the `flow` the task was posted with.
+    using RunHook = void (*)(Task& task, std::uint64_t flow);
+
+    // Elastic sizing: `initial` of the worker slots start running (0: all); a worker that has
+    // run no task for `retire_after` exits while more than `min` are running (0: never).
+    struct Elastic {
+        std::size_t initial = 0;
+        std::size_t min = 0;
+        std::chrono::nanoseconds retire_after{0};
+    };
+
+    // Called by workers after each task, e.g. to let urgent work cut in ahead of the queues.
+    using AfterTaskHook = std::function<void()>;
+
+    // Creates `n` worker slots and starts them all (or elastic.initial of them); `on_start`
+    // runs first inside each worker thread, again whenever a slot is restarted.
+    void start(std::size_t n, ThreadStartHook on_start, RunHook run_hook, const Elastic& elastic,
+               AfterTaskHook after_task = nullptr);
+
+    // Joins all workers. Tasks that have not started are discarded.
+    void stop();
+
+    // `flow` is handed to the run hook with the task (AsyncRuntime: its tracing flow id).
+    void post(Task task, std::uint64_t flow = 0U);
+
+    // Starts one more worker in a free slot, unless `max` are running. Returns false if none
+    // was started.
+    bool grow(std::size_t max);
+    // New floor / ceiling for running workers; surplus workers retire when they next go idle.
+    void set_limits(std::size_t min, std::size_t max) noexcept;
+    [[nodiscard]] std::size_t live() const noexcept { return live_.load(std::memory_order_relaxed); }
+    // Workers that found no work, spinning or parked; a woken one counts until it has a task.
+    [[nodiscard]] std::size_t idle() const noexcept { return idle_.load(std::memory_order_relaxed); }
+
+    // From inside a task: this task does not count as work for retire_after (supervisor probes).
+    static void mark_housekeeping() noexcept;
+
+    // True when called from one of this pool's workers.
+    [[nodiscard]] bool running_in_this_thread() const noexcept;
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    WorkStealingPool(WorkStealingPool&&) = delete;
+    WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+
+private:
+    struct Node : sx::utils::MPSCNode {
+        Task fn;
+        std::uint64_t flow = 0U;
+    };
+
+    struct Worker {
+        sx::utils::WorkStealingDeque<Node*> deque;
+        std::thread thread;
+        std::size_t index = 0;
+        bool running = false;  // guarded by grow_mutex_
+    };
+
+    void launch_locked(Worker& worker);
+    void worker_loop(Worker* self);
+    [[nodiscard]] bool try_retire(std::size_t floor) noexcept;
+    Node* find_work(Worker* self, uint32_t& rng_state);
+    Node* take_injected(Worker* self, bool* busy = nullptr);
+    Node* steal(Worker* self, uint32_t& rng_state);
+    [[nodiscard]] bool has_visible_work() const noexcept;
+    void notify_one();
+    void discard_pending();
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    sx::utils::MPSCQueue<Node> injection_;
+    std::atomic<bool> injection_busy_{false};  // single-consumer guard for injection_
+
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+    std::atomic<std::size_t> sleepers_{0};
+    std::atomic<std::size_t> idle_{0};
+    std::atomic<bool> stop_{false};
+    RunHook run_hook_ = nullptr;  // written by start() before the workers exist
+    ThreadStartHook on_start_;    // likewise
+    AfterTaskHook after_task_;    // likewise
+
+    std::mutex grow_mutex_;  // worker slot (re)starts and joins
+    std::atomic<std::size_t> live_{0};
+    std::atomic<std::size_t> min_live_{0};
+    std::atomic<std::size_t> max_live_{0};
+    std::chrono::nanoseconds retire_after_{0};
+};
+
+}  // namespace sx::infra
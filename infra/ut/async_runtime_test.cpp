@@ -1,11 +1,26 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
 #include <vector>
 
+#include <stdlib.h>
+#include <unistd.h>
+
 #include "sx/infra/async_runtime.h"
+#include "sx/infra/loop_rate.h"
+#include "sx/infra/task_group.h"
 
 TEST(AsyncRuntime, PostIoExecutes) {
     sx::infra::AsyncRuntime rt;
@@ -83,3 +98,1392 @@ TEST(AsyncRuntime, CpuStrandSerializes) {
 }
 
 
+
+namespace {
+
+sx::infra::RuntimeOptions WorkStealingOptions(std::size_t cpu_threads) {
+    sx::infra::RuntimeOptions options;
+    options.io_threads = 1U;
+    options.cpu_threads = cpu_threads;
+    options.cpu_pool = sx::infra::CpuPoolKind::kWorkStealing;
+    return options;
+}
+
+}  // namespace
+
+TEST(AsyncRuntime, WorkStealingPoolRunsExternalAndNestedTasks) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, WorkStealingOptions(4U));
+
+    // Each external task fans out nested tasks from inside the pool (local deque path).
+    constexpr int kOuter = 64;
+    constexpr int kInner = 32;
+    std::atomic<int> remaining{kOuter * kInner};
+    std::promise<void> done;
+    auto fut = done.get_future();
+
+    for (int i = 0; i < kOuter; ++i) {
+        rt.post_cpu([&rt, &remaining, &done]() {
+            for (int j = 0; j < kInner; ++j) {
+                rt.post_cpu([&remaining, &done]() {
+                    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) done.set_value();
+                });
+            }
+        });
+    }
+
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(remaining.load(), 0);
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, WorkStealingPoolNeverParksOnAnInjectedTask) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, WorkStealingOptions(2U));
+
+    // Each post lands while the workers are going idle or parked; it must run without
+    // another post to wake the pool. Several producers race the injection queue's consumer.
+    // Every other round one worker is held by a long task: the other one must not park on a
+    // task that worker's last pop missed.
+    for (int round = 0; round < 200; ++round) {
+        std::atomic<bool> release{false};
+        std::promise<void> holding;
+        std::promise<void> released;
+        if (round % 2 == 1) {
+            rt.post_cpu([&]() {
+                holding.set_value();
+                const auto until = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+                while (!release.load() && std::chrono::steady_clock::now() < until) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+                released.set_value();
+            });
+            holding.get_future().wait();
+        } else {
+            released.set_value();
+        }
+        std::atomic<int> ran{0};
+        std::promise<void> done;
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 3; ++p) {
+            producers.emplace_back([&]() {
+                rt.post_cpu([&]() {
+                    if (ran.fetch_add(1, std::memory_order_acq_rel) == 2) done.set_value();
+                });
+            });
+        }
+        for (auto& t : producers) t.join();
+        const auto status = done.get_future().wait_for(std::chrono::seconds(2));
+        release = true;
+        released.get_future().wait();
+        ASSERT_EQ(status, std::future_status::ready) << round;
+        if (round % 20 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(2));  // let workers park
+    }
+    rt.stop();
+}
+
+TEST(AsyncRuntime, WorkStealingCpuStrandSerializes) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, WorkStealingOptions(4U));
+
+    auto ex = rt.create_cpu_strand();
+    ASSERT_TRUE(ex);
+
+    auto seq = std::make_shared<std::vector<int>>();
+    std::atomic<int> concurrent{0};
+    std::atomic<bool> overlapped{false};
+    std::promise<void> done;
+    auto fut = done.get_future();
+
+    for (int i = 0; i < 500; ++i) {
+        ex->post([seq, i, &concurrent, &overlapped]() {
+            if (concurrent.fetch_add(1) != 0) overlapped.store(true);
+            seq->push_back(i);
+            concurrent.fetch_sub(1);
+        });
+    }
+    ex->post([&done]() { done.set_value(); });
+
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_FALSE(overlapped.load());
+    ASSERT_EQ(seq->size(), 500U);
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ((*seq)[static_cast<std::size_t>(i)], i);
+    }
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, StrandsAreIndependentAndSerializeConcurrentProducers) {
+    for (auto kind : {sx::infra::CpuPoolKind::kAsio, sx::infra::CpuPoolKind::kWorkStealing}) {
+        SCOPED_TRACE(kind == sx::infra::CpuPoolKind::kAsio ? "asio" : "work-stealing");
+        sx::infra::RuntimeOptions options = WorkStealingOptions(2U);
+        options.cpu_pool = kind;
+        options.io_threads = 2U;  // one of them gets blocked below
+        sx::infra::AsyncRuntime rt;
+        rt.init(nullptr, options);
+
+        // Four producers hammer one strand: no overlap, and each producer's tasks keep their order.
+        constexpr int kProducers = 4;
+        constexpr int kPerProducer = 2000;
+        auto strand = rt.create_cpu_strand();
+        std::array<int, kProducers> last{};
+        last.fill(-1);
+        std::atomic<int> concurrent{0};
+        std::atomic<bool> overlapped{false};
+        std::atomic<bool> reordered{false};
+        std::atomic<int> remaining{kProducers * kPerProducer};
+        std::promise<void> all_ran;
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&, p]() {
+                for (int i = 0; i < kPerProducer; ++i) {
+                    strand->post([&, p, i]() {
+                        if (concurrent.fetch_add(1) != 0) overlapped = true;
+                        if (last[static_cast<std::size_t>(p)] != i - 1) reordered = true;
+                        last[static_cast<std::size_t>(p)] = i;
+                        concurrent.fetch_sub(1);
+                        if (remaining.fetch_sub(1) == 1) all_ran.set_value();
+                    });
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+        ASSERT_EQ(all_ran.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_FALSE(overlapped.load());
+        EXPECT_FALSE(reordered.load());
+
+        // A strand blocked inside a task holds up nothing but itself, however many strands exist
+        // (asio::strand hashes onto a fixed pool of implementations and could collide here).
+        auto blocked = rt.create_io_strand();
+        std::promise<void> unblock;
+        auto unblocked = unblock.get_future().share();
+        blocked->post([unblocked]() { unblocked.wait(); });
+        constexpr int kStrands = 300;
+        std::vector<std::shared_ptr<sx::infra::IExecutor>> strands;
+        std::atomic<int> others{kStrands};
+        std::promise<void> others_ran;
+        for (int i = 0; i < kStrands; ++i) {
+            strands.push_back(i % 2 == 0 ? rt.create_io_strand() : rt.create_cpu_strand());
+            strands.back()->post([&]() {
+                if (others.fetch_sub(1) == 1) others_ran.set_value();
+            });
+        }
+        EXPECT_EQ(others_ran.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        unblock.set_value();
+        rt.stop();
+    }
+}
+
+TEST(AsyncRuntime, PerThreadIoContextsKeepKeyedWorkTimersAndStrandsOnOneThread) {
+    sx::infra::RuntimeOptions options;
+    options.io_threads = 3U;
+    options.cpu_threads = 1U;
+    options.io_pool = sx::infra::IoPoolKind::kPerThread;
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, options);
+    ASSERT_EQ(rt.io_shards(), 3U);
+
+    constexpr std::size_t kKeys = 6U;
+    constexpr int kPerKey = 200;
+    struct KeyLog {
+        std::mutex mutex;
+        std::vector<std::thread::id> threads;
+        std::vector<int> order;
+        bool nested_stayed = true;
+    };
+    std::array<KeyLog, kKeys> logs;
+    std::atomic<int> remaining{static_cast<int>(kKeys) * kPerKey};
+    std::promise<void> done;
+    for (int i = 0; i < kPerKey; ++i) {
+        for (std::size_t key = 0; key < kKeys; ++key) {
+            rt.post_io_keyed(key, [&, key, i]() {
+                auto& log = logs[key];
+                {
+                    std::lock_guard<std::mutex> lock(log.mutex);
+                    log.threads.push_back(std::this_thread::get_id());
+                    log.order.push_back(i);
+                }
+                // Unkeyed work posted from an IO worker stays on that worker.
+                rt.post_io([&, key, self = std::this_thread::get_id()]() {
+                    if (std::this_thread::get_id() != self) {
+                        std::lock_guard<std::mutex> lock(logs[key].mutex);
+                        logs[key].nested_stayed = false;
+                    }
+                    if (remaining.fetch_sub(1) == 1) done.set_value();
+                });
+            });
+        }
+    }
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    std::array<std::thread::id, kKeys> owner{};
+    for (std::size_t key = 0; key < kKeys; ++key) {
+        std::lock_guard<std::mutex> lock(logs[key].mutex);
+        ASSERT_EQ(logs[key].order.size(), static_cast<std::size_t>(kPerKey));
+        owner[key] = logs[key].threads.front();
+        for (int i = 0; i < kPerKey; ++i) {
+            EXPECT_EQ(logs[key].order[static_cast<std::size_t>(i)], i);
+            EXPECT_EQ(logs[key].threads[static_cast<std::size_t>(i)], owner[key]);
+        }
+        EXPECT_TRUE(logs[key].nested_stayed);
+    }
+    // key % 3 picks the worker.
+    EXPECT_NE(owner[0], owner[1]);
+    EXPECT_NE(owner[1], owner[2]);
+    EXPECT_NE(owner[0], owner[2]);
+    EXPECT_EQ(owner[0], owner[3]);
+    EXPECT_EQ(owner[2], owner[5]);
+
+    // Keyed timers fire on the key's worker.
+    auto timer = rt.create_timer(4U);
+    std::promise<std::thread::id> fired;
+    timer->expires_after(std::chrono::milliseconds(1));
+    timer->async_wait([&fired](const std::error_code&) { fired.set_value(std::this_thread::get_id()); });
+    auto fired_on = fired.get_future();
+    ASSERT_EQ(fired_on.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(fired_on.get(), owner[1]);
+
+    // So do keyed wheel timers: each context runs its own wheel.
+    for (std::size_t key : {1U, 2U}) {
+        auto wheel_timer = rt.create_wheel_timer(key);
+        std::promise<std::thread::id> wheel_fired;
+        wheel_timer->expires_after(std::chrono::milliseconds(2));
+        wheel_timer->async_wait([&wheel_fired](const std::error_code&) {
+            wheel_fired.set_value(std::this_thread::get_id());
+        });
+        auto wheel_fired_on = wheel_fired.get_future();
+        ASSERT_EQ(wheel_fired_on.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        EXPECT_EQ(wheel_fired_on.get(), owner[key]);
+    }
+
+    // An IO strand is pinned to a single worker, and its tasks see it as the current executor.
+    auto strand = rt.create_io_strand();
+    std::mutex strand_mutex;
+    std::vector<std::thread::id> strand_threads;
+    int strand_current = 0;
+    std::promise<void> strand_done;
+    for (int i = 0; i < 50; ++i) {
+        strand->post([&, i]() {
+            std::lock_guard<std::mutex> lock(strand_mutex);
+            strand_threads.push_back(std::this_thread::get_id());
+            if (sx::infra::IExecutor::current() == strand.get() && strand->running_in_this_thread()) {
+                ++strand_current;
+            }
+            if (i == 49) strand_done.set_value();
+        });
+    }
+    ASSERT_EQ(strand_done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(std::count(strand_threads.begin(), strand_threads.end(), strand_threads.front()), 50);
+    EXPECT_EQ(strand_current, 50);
+    rt.stop();
+
+    // Re-init with the shared layout reuses the runtime.
+    options.io_pool = sx::infra::IoPoolKind::kShared;
+    rt.init(nullptr, options);
+    EXPECT_EQ(rt.io_shards(), 1U);
+    std::promise<void> shared_ran;
+    rt.post_io_keyed(7U, [&shared_ran]() { shared_ran.set_value(); });
+    EXPECT_EQ(shared_ran.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    rt.stop();
+}
+
+TEST(AsyncRuntime, ConcurrentPostersRaceWithStop) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 2U, 2U);
+
+    // Posts racing with stop() must either run or be dropped, never block or crash.
+    std::atomic<int> executed{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> posters;
+    for (int t = 0; t < 8; ++t) {
+        posters.emplace_back([&rt, &executed, &go]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (int i = 0; i < 5000; ++i) {
+                rt.post_cpu([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+                rt.post_io([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    rt.stop();
+    const int after_stop = executed.load();
+
+    for (auto& t : posters) t.join();
+    EXPECT_EQ(executed.load(), after_stop);
+    EXPECT_LE(after_stop, 8 * 5000 * 2);
+
+    // The runtime can be restarted and accepts work again.
+    rt.init(nullptr, 1U, 1U);
+    std::promise<void> done;
+    auto fut = done.get_future();
+    rt.post_cpu([&done]() { done.set_value(); });
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    rt.stop();
+}
+
+TEST(AsyncRuntime, MoveOnlyTasksRunOnPoolsAndStrands) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 2U);
+
+    auto payload = std::make_unique<int>(7);
+    auto small = [p = std::move(payload)]() { (void)p; };
+    static_assert(sx::infra::Task::stored_inline<decltype(small)>, "small captures stay inline");
+
+    std::promise<int> io_done;
+    std::promise<int> cpu_done;
+    std::promise<int> strand_done;
+    std::promise<int> large_done;
+    auto io_fut = io_done.get_future();
+    auto cpu_fut = cpu_done.get_future();
+    auto strand_fut = strand_done.get_future();
+    auto large_fut = large_done.get_future();
+
+    rt.post_io([p = std::make_unique<int>(1), &io_done]() { io_done.set_value(*p); });
+    rt.post_cpu([p = std::make_unique<int>(2), &cpu_done]() { cpu_done.set_value(*p); });
+    rt.create_cpu_strand()->post([p = std::make_unique<int>(3), &strand_done]() { strand_done.set_value(*p); });
+
+    // Captures beyond the inline buffer fall back to the heap but behave the same.
+    std::array<int, 32> big{};
+    big.back() = 4;
+    auto large = [big, p = std::make_unique<int>(0), &large_done]() { large_done.set_value(big.back() + *p); };
+    static_assert(!sx::infra::Task::stored_inline<decltype(large)>, "large captures go to the heap");
+    rt.post_cpu(std::move(large));
+
+    ASSERT_EQ(io_fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    ASSERT_EQ(cpu_fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    ASSERT_EQ(strand_fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    ASSERT_EQ(large_fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(io_fut.get(), 1);
+    EXPECT_EQ(cpu_fut.get(), 2);
+    EXPECT_EQ(strand_fut.get(), 3);
+    EXPECT_EQ(large_fut.get(), 4);
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, ParallelForCoversRangeOnceAndCallerParticipates) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 4U);
+
+    constexpr std::size_t kCount = 100000U;
+    std::vector<std::atomic<int>> hits(kCount);
+    const auto caller = std::this_thread::get_id();
+    std::atomic<bool> caller_ran{false};
+
+    rt.parallel_for(0U, kCount, 256U, [&](std::size_t begin, std::size_t end) {
+        if (std::this_thread::get_id() == caller) caller_ran.store(true, std::memory_order_relaxed);
+        for (std::size_t i = begin; i < end; ++i) hits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    for (std::size_t i = 0; i < kCount; ++i) {
+        ASSERT_EQ(hits[i].load(std::memory_order_relaxed), 1) << "index " << i;
+    }
+    EXPECT_TRUE(caller_ran.load());
+
+    // Per-index form, empty range, and exceptions propagating to the caller.
+    std::atomic<std::size_t> sum{0};
+    rt.parallel_for(10U, 20U, 1U, [&sum](std::size_t i) { sum.fetch_add(i, std::memory_order_relaxed); });
+    EXPECT_EQ(sum.load(), 145U);
+    rt.parallel_for(5U, 5U, 1U, [](std::size_t) { FAIL() << "empty range must not run"; });
+    EXPECT_THROW(rt.parallel_for(0U, 1000U, 1U,
+                                 [](std::size_t i) {
+                                     if (i == 500U) throw std::runtime_error("boom");
+                                 }),
+                 std::runtime_error);
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, ParallelReduceAndInvokeNestInsideWorkStealingPool) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, WorkStealingOptions(4U));
+
+    std::promise<uint64_t> result;
+    auto fut = result.get_future();
+    std::atomic<int> invoked{0};
+
+    // Called from a CPU worker: the caller must not deadlock waiting on its own pool.
+    rt.post_cpu([&]() {
+        const uint64_t total = rt.parallel_reduce(
+            0U, 1000000U, 1024U, uint64_t{0},
+            [](std::size_t begin, std::size_t end) {
+                uint64_t s = 0;
+                for (std::size_t i = begin; i < end; ++i) s += i;
+                return s;
+            },
+            [](uint64_t a, uint64_t b) { return a + b; });
+        rt.parallel_invoke([&invoked]() { invoked.fetch_add(1); }, [&invoked]() { invoked.fetch_add(10); },
+                           [&invoked]() { invoked.fetch_add(100); });
+        result.set_value(total);
+    });
+
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(fut.get(), uint64_t{999999} * 1000000U / 2U);
+    EXPECT_EQ(invoked.load(), 111);
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, ParallelReduceFoldsInIndexOrder) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, WorkStealingOptions(4U));
+
+    // Concatenation is associative but not commutative: any other order shows in the result.
+    std::string expected;
+    for (std::size_t i = 0; i < 5000U; ++i) expected += static_cast<char>('a' + i % 26U);
+    for (int round = 0; round < 20; ++round) {
+        const std::string joined = rt.parallel_reduce(
+            0U, expected.size(), 7U, std::string{},
+            [&expected](std::size_t begin, std::size_t end) { return expected.substr(begin, end - begin); },
+            [](std::string a, const std::string& b) { return a + b; });
+        ASSERT_EQ(joined, expected) << "round " << round;
+    }
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, SubmitChainsContinuationsAcrossExecutors) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 2U);
+    auto io = rt.create_io_strand();
+
+    // decode -> detect (on the IO strand) -> publish, plus a failing stage that skips the rest.
+    auto result = rt.submit([]() { return 20; })
+                      .then(io, [](int v) { return v + 1; })
+                      .then([](int v) { return std::to_string(v * 2); });
+    EXPECT_EQ(result.get(), "42");
+
+    bool skipped_stage_ran = false;
+    auto failed = rt.submit([]() -> int { throw std::runtime_error("decode failed"); })
+                      .then([&skipped_stage_ran](int v) {
+                          skipped_stage_ran = true;
+                          return v;
+                      });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+    EXPECT_FALSE(skipped_stage_ran);
+
+    // A continuation on a ready future runs inline, on the calling thread.
+    auto ready = sx::infra::make_ready_future(5);
+    std::thread::id ran_on;
+    auto inline_result = std::move(ready).then([&ran_on](int v) {
+        ran_on = std::this_thread::get_id();
+        return v;
+    });
+    EXPECT_TRUE(inline_result.ready());
+    EXPECT_EQ(ran_on, std::this_thread::get_id());
+    EXPECT_EQ(inline_result.get(), 5);
+
+    rt.stop();
+
+    // Dropped by a stopped runtime: the promise is broken rather than left hanging.
+    auto dropped = rt.submit([]() { return 1; });
+    EXPECT_THROW(dropped.get(), std::future_error);
+}
+
+TEST(AsyncRuntime, WhenAllAndWhenAnyCombineFutures) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 4U);
+
+    std::vector<sx::infra::Future<int>> parts;
+    for (int i = 0; i < 8; ++i) parts.push_back(rt.submit([i]() { return i * i; }));
+    auto all = sx::infra::when_all(std::move(parts));
+    const std::vector<int> squares = all.get();
+    ASSERT_EQ(squares.size(), 8U);
+    for (int i = 0; i < 8; ++i) EXPECT_EQ(squares[static_cast<std::size_t>(i)], i * i);
+
+    sx::infra::Promise<int> never;
+    std::vector<sx::infra::Future<int>> racers;
+    racers.push_back(never.get_future());
+    racers.push_back(rt.submit([]() { return 7; }));
+    auto first = sx::infra::when_any(std::move(racers)).get();
+    EXPECT_EQ(first.first, 1U);
+    EXPECT_EQ(first.second, 7);
+
+    std::vector<sx::infra::Future<void>> voids;
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 4; ++i) voids.push_back(rt.submit([&ran]() { ran.fetch_add(1); }));
+    sx::infra::when_all(std::move(voids)).get();
+    EXPECT_EQ(ran.load(), 4);
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, PrioritizedTasksRunByPriorityThenDeadlineAndDropExpired) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+
+    // Hold the only CPU worker so everything below queues up.
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    rt.post_cpu([gate]() { gate.wait(); });
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&order_mutex, &order](std::string name) {
+        return [&order_mutex, &order, name = std::move(name)]() {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(name);
+        };
+    };
+
+    const auto now = std::chrono::steady_clock::now();
+    sx::infra::TaskOptions background;
+    background.priority = sx::infra::TaskPriority::kBackground;
+    for (int i = 0; i < 3; ++i) rt.post_cpu(background, record("bg" + std::to_string(i)));
+
+    sx::infra::TaskOptions late;
+    late.deadline = now + std::chrono::seconds(2);
+    rt.post_cpu(late, record("late"));
+    sx::infra::TaskOptions soon;
+    soon.deadline = now + std::chrono::seconds(1);
+    rt.post_cpu(soon, record("soon"));
+
+    sx::infra::TaskOptions stale;
+    stale.priority = sx::infra::TaskPriority::kHigh;
+    stale.deadline = now + std::chrono::milliseconds(1);
+    stale.drop_if_expired = true;
+    rt.post_cpu(stale, record("stale"));
+
+    sx::infra::TaskOptions critical;
+    critical.priority = sx::infra::TaskPriority::kHigh;
+    rt.post_cpu(critical, record("critical"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    release.set_value();
+
+    std::promise<void> done;
+    auto fut = done.get_future();
+    rt.post_cpu(background, [&done]() { done.set_value(); });
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+
+    const std::vector<std::string> expected{"critical", "soon", "late", "bg0", "bg1", "bg2"};
+    std::lock_guard<std::mutex> lock(order_mutex);
+    EXPECT_EQ(order, expected);
+    EXPECT_EQ(rt.expired_task_drops(), 1U);
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, HighPriorityTasksOvertakeQueuedPlainTasksOnBothPools) {
+    for (const auto pool : {sx::infra::CpuPoolKind::kAsio, sx::infra::CpuPoolKind::kWorkStealing}) {
+        sx::infra::RuntimeOptions options;
+        options.io_threads = 1U;
+        options.cpu_threads = 1U;
+        options.cpu_pool = pool;
+        sx::infra::AsyncRuntime rt;
+        rt.init(nullptr, options);
+
+        std::promise<void> release;
+        auto gate = release.get_future().share();
+        rt.post_cpu([gate]() { gate.wait(); });
+
+        // Only the worker appends, one task at a time.
+        std::vector<std::string> order;
+        std::promise<void> done;
+        auto record = [&order, &done](std::string name) {
+            return [&order, &done, name = std::move(name)]() {
+                order.push_back(name);
+                if (order.size() == 5U) done.set_value();
+            };
+        };
+        for (int i = 0; i < 3; ++i) rt.post_cpu(record("plain" + std::to_string(i)));
+        sx::infra::TaskOptions background;
+        background.priority = sx::infra::TaskPriority::kBackground;
+        rt.post_cpu(background, record("background"));
+        sx::infra::TaskOptions high;
+        high.priority = sx::infra::TaskPriority::kHigh;
+        rt.post_cpu(high, record("high"));
+
+        release.set_value();
+        ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+        // kHigh cuts ahead of the pool queue; kBackground only waits for its token's turn (the
+        // work-stealing pool does not keep FIFO order among the rest).
+        ASSERT_EQ(order.size(), 5U);
+        EXPECT_EQ(order.front(), "high");
+        if (pool == sx::infra::CpuPoolKind::kAsio) {
+            EXPECT_EQ(order, (std::vector<std::string>{"high", "plain0", "plain1", "plain2", "background"}));
+        }
+        rt.stop();
+    }
+}
+
+TEST(AsyncRuntime, WheelTimersFireInOrderAndNeverEarly) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+
+    // 300 ms is beyond level 0 (256 ticks at 1 ms) and exercises cascading.
+    const std::vector<int> delays_ms{300, 5, 50, 0};
+    std::vector<std::shared_ptr<sx::infra::ITimer>> timers;
+    std::vector<std::promise<std::chrono::steady_clock::duration>> fired(delays_ms.size());
+    std::vector<std::future<std::chrono::steady_clock::duration>> results;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < delays_ms.size(); ++i) {
+        auto timer = rt.create_wheel_timer();
+        timer->expires_after(std::chrono::milliseconds(delays_ms[i]));
+        results.push_back(fired[i].get_future());
+        timer->async_wait([&fired, i, start](const std::error_code& ec) {
+            EXPECT_FALSE(ec);
+            fired[i].set_value(std::chrono::steady_clock::now() - start);
+        });
+        timers.push_back(std::move(timer));
+    }
+
+    for (std::size_t i = 0; i < delays_ms.size(); ++i) {
+        ASSERT_EQ(results[i].wait_for(std::chrono::seconds(2)), std::future_status::ready);
+        const auto elapsed = results[i].get();
+        EXPECT_GE(elapsed, std::chrono::milliseconds(delays_ms[i]));
+        EXPECT_LT(elapsed, std::chrono::milliseconds(delays_ms[i] + 200));
+    }
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, WheelTimerRearmAndCancelAbortPendingWait) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+
+    auto timer = rt.create_wheel_timer();
+    std::promise<std::error_code> first;
+    std::promise<std::error_code> second;
+    auto first_fut = first.get_future();
+    auto second_fut = second.get_future();
+
+    timer->expires_after(std::chrono::milliseconds(20));
+    timer->async_wait([&first](const std::error_code& ec) { first.set_value(ec); });
+    timer->expires_after(std::chrono::milliseconds(30));
+    timer->async_wait([&second](const std::error_code& ec) { second.set_value(ec); });
+
+    ASSERT_EQ(first_fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_TRUE(first_fut.get() == std::errc::operation_canceled);
+    ASSERT_EQ(second_fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_FALSE(second_fut.get());
+
+    // Thousands of timers, each rescheduled many times before it is allowed to fire.
+    constexpr int kTimers = 2000;
+    std::atomic<int> ok{0};
+    std::atomic<int> aborted{0};
+    std::vector<std::shared_ptr<sx::infra::ITimer>> many;
+    for (int i = 0; i < kTimers; ++i) many.push_back(rt.create_wheel_timer());
+    for (int round = 0; round < 10; ++round) {
+        for (auto& t : many) {
+            t->expires_after(std::chrono::milliseconds(200 + round));
+            t->async_wait([&ok, &aborted](const std::error_code& ec) { (ec ? aborted : ok).fetch_add(1); });
+        }
+    }
+    many.back()->cancel();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (ok.load() + aborted.load() < kTimers * 10 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(ok.load(), kTimers - 1);
+    EXPECT_EQ(aborted.load(), kTimers * 9 + 1);
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, PeriodicTimerKeepsAbsoluteScheduleAndCountsOverruns) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+
+    constexpr auto kPeriod = std::chrono::microseconds(2000);
+    std::mutex mutex;
+    std::vector<sx::infra::PeriodicTick> ticks;
+    std::promise<void> done;
+    auto fut = done.get_future();
+
+    auto timer = rt.create_periodic_timer();
+    timer->start(kPeriod, [&](const sx::infra::PeriodicTick& tick) {
+        // Tick 5 overruns past ticks 6 and 7: 6 is skipped, 7 runs late.
+        if (tick.index == 5U) std::this_thread::sleep_for(kPeriod * 2 + kPeriod / 2);
+        std::lock_guard<std::mutex> lock(mutex);
+        ticks.push_back(tick);
+        if (ticks.size() == 20U) done.set_value();
+    });
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    timer->stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_GE(ticks.size(), 20U);
+    const auto origin = ticks[0].deadline - kPeriod * static_cast<int64_t>(ticks[0].index);
+    uint64_t missed = 0;
+    for (std::size_t i = 0; i < ticks.size(); ++i) {
+        // Deadlines stay on the original grid: no accumulated drift.
+        EXPECT_EQ(ticks[i].deadline, origin + kPeriod * static_cast<int64_t>(ticks[i].index));
+        if (i > 0U) {
+            EXPECT_EQ(ticks[i].index, ticks[i - 1U].index + 1U + ticks[i].missed);
+        }
+        missed += ticks[i].missed;
+    }
+    EXPECT_GE(missed, 1U);
+    EXPECT_EQ(timer->overruns(), missed);
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, MetricsRecordQueueDelayRunTimeAndBusyRatio) {
+    sx::infra::AsyncRuntime plain;
+    plain.init(nullptr, 1U, 1U);
+    EXPECT_FALSE(plain.metrics().enabled);
+    plain.stop();
+
+    for (const auto kind : {sx::infra::CpuPoolKind::kAsio, sx::infra::CpuPoolKind::kWorkStealing}) {
+        sx::infra::RuntimeOptions options;
+        options.io_threads = 1U;
+        options.cpu_threads = 2U;
+        options.cpu_pool = kind;
+        options.enable_metrics = true;
+        sx::infra::AsyncRuntime rt;
+        rt.init(nullptr, options);
+
+        constexpr int kTasks = 8;
+        constexpr auto kWork = std::chrono::milliseconds(2);
+        auto strand = rt.create_cpu_strand("frames");
+        std::atomic<int> remaining{2 * kTasks + 1};
+        std::promise<void> done;
+        auto fut = done.get_future();
+        auto finish = [&remaining, &done]() {
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) done.set_value();
+        };
+        for (int i = 0; i < kTasks; ++i) {
+            rt.post_cpu([&]() {
+                std::this_thread::sleep_for(kWork);
+                finish();
+            });
+            strand->post([&]() {
+                std::this_thread::sleep_for(kWork);
+                finish();
+            });
+        }
+        rt.post_io(finish);
+        ASSERT_EQ(fut.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+        // The last task signals before its own completion is recorded.
+        sx::infra::RuntimeMetrics m;
+        for (int i = 0; i < 200; ++i) {
+            m = rt.metrics();
+            if (m.cpu.tasks.completed == 2U * kTasks && m.io.tasks.completed == 1U) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(m.enabled);
+        EXPECT_EQ(m.cpu.tasks.posted, 2U * kTasks);
+        EXPECT_EQ(m.cpu.tasks.completed, 2U * kTasks);
+        EXPECT_EQ(m.cpu.tasks.queued(), 0U);
+        EXPECT_EQ(m.cpu.tasks.in_flight(), 0U);
+        EXPECT_EQ(m.io.tasks.completed, 1U);
+        EXPECT_EQ(m.cpu.tasks.run_time.count, 2U * kTasks);
+        EXPECT_GE(m.cpu.tasks.run_time.percentile(0.5), kWork / 2);
+        EXPECT_LE(m.cpu.tasks.run_time.percentile(0.5), m.cpu.tasks.run_time.percentile(1.0));
+        EXPECT_EQ(m.cpu.tasks.queue_delay.count, 2U * kTasks);
+
+        ASSERT_EQ(m.cpu.workers.size(), 2U);
+        std::chrono::nanoseconds busy{0};
+        for (const auto& worker : m.cpu.workers) {
+            busy += worker.busy;
+            EXPECT_LE(worker.busy_ratio, 1.0);
+        }
+        EXPECT_GE(busy, kWork * (2 * kTasks));
+
+        ASSERT_EQ(m.strands.size(), 1U);
+        EXPECT_EQ(m.strands[0].name, "frames");
+        EXPECT_EQ(m.strands[0].tasks.completed, static_cast<uint64_t>(kTasks));
+
+        strand.reset();
+        EXPECT_TRUE(rt.metrics().strands.empty());
+        rt.stop();
+    }
+}
+
+TEST(AsyncRuntime, MeteredTasksSurviveDroppingTheirPerThreadStrandAndARestart) {
+    sx::infra::RuntimeOptions options;
+    options.io_threads = 2U;
+    options.cpu_threads = 1U;
+    options.io_pool = sx::infra::IoPoolKind::kPerThread;
+    options.enable_metrics = true;
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, options);
+
+    // A per-thread IO strand posts straight to its context; queued tasks keep it alive.
+    constexpr int kTasks = 4;
+    auto strand = rt.create_io_strand("shard");
+    std::promise<void> gate;
+    auto gate_fut = gate.get_future().share();
+    std::atomic<int> remaining{kTasks};
+    std::promise<void> done;
+    strand->post([gate_fut]() { gate_fut.wait(); });
+    for (int i = 0; i < kTasks; ++i) {
+        strand->post([&remaining, &done]() {
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) done.set_value();
+        });
+    }
+    strand.reset();
+    EXPECT_EQ(rt.metrics().strands.size(), 1U);
+    gate.set_value();
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    sx::infra::RuntimeMetrics m;
+    for (int i = 0; i < 200; ++i) {
+        m = rt.metrics();
+        // The last handler releases the strand just after its completion is recorded.
+        if (m.io.tasks.completed == static_cast<uint64_t>(kTasks) + 1U && m.strands.empty()) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(m.io.tasks.completed, static_cast<uint64_t>(kTasks) + 1U);
+    EXPECT_TRUE(m.strands.empty());
+
+    // A new session counts from zero.
+    rt.stop();
+    rt.init(nullptr, options);
+    std::promise<void> ran;
+    rt.post_io([&ran]() { ran.set_value(); });
+    ASSERT_EQ(ran.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(rt.metrics().io.tasks.posted, 1U);
+    rt.stop();
+}
+
+TEST(AsyncRuntime, WatchdogReportsBlockedWorkerLoopLagAndSilentCriticalLoop) {
+    sx::infra::RuntimeOptions options;
+    options.io_threads = 1U;
+    options.cpu_threads = 1U;
+    options.watchdog.enabled = true;
+    options.watchdog.check_period = std::chrono::milliseconds(5);
+    options.watchdog.task_budget = std::chrono::milliseconds(40);
+    options.watchdog.lag_budget = std::chrono::milliseconds(40);
+    options.watchdog.critical_budget = std::chrono::milliseconds(40);
+
+    std::mutex mutex;
+    std::vector<sx::infra::StallReport> reports;
+    sx::infra::AsyncRuntime rt;
+    rt.set_stall_handler([&](const sx::infra::StallReport& report) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(report);
+    });
+    rt.init(nullptr, options);
+
+    // A blocking call on the only IO worker starves the IO pool.
+    std::promise<void> blocked;
+    rt.post_io([&blocked]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        blocked.set_value();
+    });
+    // A critical loop that kicks for a while, then hangs.
+    rt.spawn_critical_loop(sx::types::ThreadPolicy{}, [](std::atomic<bool>& stop) {
+        for (int i = 0; i < 10 && !stop.load(); ++i) {
+            sx::infra::AsyncRuntime::watchdog_kick();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    });
+    ASSERT_EQ(blocked.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    rt.stop();
+
+    using Class = sx::hal::IThreadScheduler::ThreadClass;
+    auto find = [&reports](sx::infra::StallKind kind, Class cls) -> const sx::infra::StallReport* {
+        for (const auto& r : reports) {
+            if (r.kind == kind && r.thread_class == cls) return &r;
+        }
+        return nullptr;
+    };
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto* overrun = find(sx::infra::StallKind::kTaskOverrun, Class::kIo);
+    ASSERT_NE(overrun, nullptr);
+    EXPECT_EQ(overrun->index, 0U);
+    EXPECT_GT(overrun->thread_id, 0);
+    EXPECT_GE(overrun->stalled_for, std::chrono::milliseconds(40));
+    EXPECT_NE(sx::infra::to_string(*overrun).find("task overrun on io worker 0"), std::string::npos);
+    EXPECT_NE(find(sx::infra::StallKind::kLoopLag, Class::kIo), nullptr);
+    EXPECT_NE(find(sx::infra::StallKind::kCriticalSilent, Class::kCritical), nullptr);
+    EXPECT_EQ(find(sx::infra::StallKind::kTaskOverrun, Class::kCpu), nullptr);
+    EXPECT_EQ(rt.stalls_detected(), reports.size());
+    // Each stall is reported once, not on every check.
+    EXPECT_EQ(std::count_if(reports.begin(), reports.end(),
+                            [](const auto& r) { return r.kind == sx::infra::StallKind::kTaskOverrun; }),
+              1);
+}
+
+TEST(AsyncRuntime, WatchdogSendsAHeartbeatToEveryPerThreadIoContext) {
+    sx::infra::RuntimeOptions options;
+    options.io_threads = 3U;
+    options.cpu_threads = 1U;
+    options.io_pool = sx::infra::IoPoolKind::kPerThread;
+    options.watchdog.enabled = true;
+    options.watchdog.check_period = std::chrono::milliseconds(5);
+    options.watchdog.task_budget = std::chrono::seconds(10);
+    options.watchdog.lag_budget = std::chrono::milliseconds(40);
+
+    std::mutex mutex;
+    std::vector<sx::infra::StallReport> reports;
+    sx::infra::AsyncRuntime rt;
+    rt.set_stall_handler([&](const sx::infra::StallReport& report) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(report);
+    });
+    rt.init(nullptr, options);
+
+    // One blocked context lags while the other two keep answering.
+    std::promise<void> blocked;
+    rt.post_io_keyed(2U, [&blocked]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        blocked.set_value();
+    });
+    ASSERT_EQ(blocked.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    rt.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(reports.size(), 1U);
+    EXPECT_EQ(reports[0].kind, sx::infra::StallKind::kLoopLag);
+    EXPECT_EQ(reports[0].thread_class, sx::hal::IThreadScheduler::ThreadClass::kIo);
+    EXPECT_EQ(reports[0].index, 2U);
+    EXPECT_NE(sx::infra::to_string(reports[0]).find("event loop lag on io pool shard 2"), std::string::npos);
+}
+
+TEST(AsyncRuntime, ManagedCriticalLoopPacesSpinsAndRecordsJitter) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+
+    sx::infra::CriticalLoopOptions options;
+    options.period = std::chrono::microseconds(500);
+    options.spin_budget = std::chrono::microseconds(100);
+
+    std::atomic<uint64_t> seen{0};
+    std::atomic<uint64_t> missed{0};
+    std::promise<void> done;
+    bool overran = false;  // loop thread only; a loaded machine may skip index 20 itself
+    auto loop = rt.spawn_critical_loop(options, [&](const sx::infra::LoopIteration& it) {
+        if (it.index >= 20U && !overran) {
+            overran = true;
+            std::this_thread::sleep_for(std::chrono::microseconds(1800));  // overrun
+        }
+        missed += it.missed;
+        if (seen.fetch_add(1) + 1U == 100U) done.set_value();
+    });
+    ASSERT_TRUE(loop);
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    loop->stop();
+
+    // Give the loop a cycle to notice stop(), then the counters are final.
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const auto stats = loop->stats();
+    EXPECT_EQ(stats.iterations, seen.load());
+    EXPECT_EQ(stats.wake_latency.count, stats.iterations);
+    EXPECT_EQ(stats.exec_time.count, stats.iterations);
+    // The long cycle skipped at least the 3 deadlines it spanned; the body saw the same count.
+    EXPECT_GE(stats.overruns, 3U);
+    EXPECT_EQ(stats.overruns, missed.load());
+    EXPECT_GE(stats.exec_time.max_ns, 1800000U);
+    // Wake-up latency depends on the machine, not on the loop: only its sample count is checked.
+
+    rt.stop();
+}
+
+TEST(AsyncRuntime, ElasticCpuPoolGrowsOnBacklogRetiresWhenIdleAndParksOnDemand) {
+    for (auto kind : {sx::infra::CpuPoolKind::kAsio, sx::infra::CpuPoolKind::kWorkStealing}) {
+        SCOPED_TRACE(kind == sx::infra::CpuPoolKind::kAsio ? "asio" : "work-stealing");
+        sx::infra::RuntimeOptions options;
+        options.io_threads = 1U;
+        options.cpu_threads = 4U;
+        options.cpu_pool = kind;
+        options.elastic.enabled = true;
+        options.elastic.min_threads = 1U;
+        options.elastic.spawn_after = std::chrono::milliseconds(2);
+        options.elastic.retire_after = std::chrono::milliseconds(50);
+
+        sx::infra::AsyncRuntime rt;
+        rt.init(nullptr, options);
+        auto size = rt.cpu_pool_size();
+        EXPECT_EQ(size.live, 1U);
+        EXPECT_EQ(size.min, 1U);
+        EXPECT_EQ(size.max, 4U);
+
+        auto wait_for = [](auto pred) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+            while (!pred() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return pred();
+        };
+
+        // Four tasks that only finish together need four workers: the backlog has to grow the pool.
+        std::atomic<int> running{0};
+        std::atomic<bool> release{false};
+        std::atomic<int> finished{0};
+        for (int i = 0; i < 4; ++i) {
+            rt.post_cpu([&]() {
+                running.fetch_add(1);
+                while (!release.load()) std::this_thread::sleep_for(std::chrono::microseconds(200));
+                finished.fetch_add(1);
+            });
+        }
+        ASSERT_TRUE(wait_for([&]() { return running.load() == 4; }));
+        EXPECT_EQ(rt.cpu_pool_size().live, 4U);
+        release = true;
+        ASSERT_TRUE(wait_for([&]() { return finished.load() == 4; }));
+
+        // Idle for retire_after: back down to the floor, never below it.
+        ASSERT_TRUE(wait_for([&]() { return rt.cpu_pool_size().live == 1U; }));
+
+        // A contended box delays the idle worker's probe; that is no backlog, so the pool settles
+        // at the floor while other processes hog every CPU.
+        {
+            std::atomic<bool> hogging{true};
+            std::vector<std::thread> hogs;
+            for (unsigned i = 0; i < std::max(1U, std::thread::hardware_concurrency()) + 2U; ++i) {
+                hogs.emplace_back([&hogging]() {
+                    while (hogging.load(std::memory_order_relaxed)) {
+                    }
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            EXPECT_TRUE(wait_for([&]() { return rt.cpu_pool_size().live == 1U; }));
+            hogging = false;
+            for (auto& hog : hogs) hog.join();
+        }
+
+        // Raising the floor spawns without load; lowering the ceiling parks the surplus.
+        rt.set_cpu_pool_limits(3U, 4U);
+        EXPECT_TRUE(wait_for([&]() { return rt.cpu_pool_size().live == 3U; }));
+        rt.set_cpu_pool_limits(2U, 2U);
+        EXPECT_TRUE(wait_for([&]() { return rt.cpu_pool_size().live == 2U; }));
+        size = rt.cpu_pool_size();
+        EXPECT_EQ(size.min, 2U);
+        EXPECT_EQ(size.max, 2U);
+
+        // Still fully functional after shrinking.
+        std::promise<void> done;
+        rt.post_cpu([&done]() { done.set_value(); });
+        EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        rt.stop();
+        EXPECT_EQ(rt.cpu_pool_size().live, 0U);
+    }
+}
+
+TEST(AsyncRuntime, TaskGroupCancelSkipsQueuedTasksAndSignalsRunningOnes) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+    auto strand = rt.create_io_strand();
+
+    sx::infra::TaskGroup group(rt);
+    std::promise<void> started;
+    std::atomic<bool> saw_cancel{false};
+    // Occupies the only CPU worker until the group is cancelled.
+    group.post_cpu([&](const sx::infra::CancellationToken& token) {
+        started.set_value();
+        while (!token.cancelled()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        saw_cancel = true;
+    });
+    std::atomic<int> ran{0};
+    auto payload = std::make_shared<int>(0);
+    for (int i = 0; i < 100; ++i) group.post_cpu([&ran, payload]() { ran.fetch_add(1); });
+    ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(group.pending(), 101U);
+    EXPECT_FALSE(group.wait_for(std::chrono::milliseconds(5)));
+
+    group.cancel();
+    group.wait();
+    EXPECT_TRUE(saw_cancel.load());
+    EXPECT_EQ(ran.load(), 0);
+    EXPECT_EQ(group.skipped(), 100U);
+    EXPECT_EQ(group.pending(), 0U);
+    EXPECT_EQ(payload.use_count(), 1);  // skipped tasks released their captures
+
+    // A new generation runs normally, on pools and strands alike.
+    sx::infra::TaskGroup next(rt);
+    for (int i = 0; i < 10; ++i) {
+        next.post_cpu([&ran]() { ran.fetch_add(1); });
+        next.post(*strand, [&ran]() { ran.fetch_add(1); });
+    }
+    next.post_io([&ran](const sx::infra::CancellationToken& token) {
+        if (!token.cancelled()) ran.fetch_add(1);
+    });
+    EXPECT_TRUE(next.wait_for(std::chrono::seconds(2)));
+    EXPECT_EQ(ran.load(), 21);
+    EXPECT_EQ(next.skipped(), 0U);
+    rt.stop();
+
+    // Posting to a stopped runtime drops the task without leaving the group pending forever.
+    sx::infra::TaskGroup late(rt);
+    late.post_cpu([&ran]() { ran.fetch_add(1); });
+    EXPECT_EQ(late.pending(), 0U);
+    late.wait();
+}
+
+TEST(AsyncRuntime, StopDrainsTaskGroupsUntilDeadlineThenCancels) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 2U);
+
+    // Finishes well inside the drain window: all of it runs.
+    sx::infra::TaskGroup quick(rt);
+    std::atomic<int> quick_ran{0};
+    for (int i = 0; i < 20; ++i) {
+        quick.post_cpu([&quick_ran]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            quick_ran.fetch_add(1);
+        });
+    }
+
+    // Never finishes on its own: both workers block until cancelled, the rest stays queued.
+    sx::infra::TaskGroup stuck(rt);
+    std::atomic<int> stuck_ran{0};
+    for (int i = 0; i < 50; ++i) {
+        stuck.post_cpu([&stuck_ran](const sx::infra::CancellationToken& token) {
+            while (!token.cancelled()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+            stuck_ran.fetch_add(1);
+        });
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    rt.stop(std::chrono::milliseconds(100));
+    const auto took = std::chrono::steady_clock::now() - begin;
+    EXPECT_GE(took, std::chrono::milliseconds(100));
+    EXPECT_LT(took, std::chrono::seconds(2));
+
+    EXPECT_EQ(quick_ran.load(), 20);
+    EXPECT_FALSE(quick.cancelled());
+    EXPECT_TRUE(stuck.cancelled());
+    // Only the tasks already running when the deadline hit got to finish.
+    EXPECT_LE(stuck_ran.load(), 2);
+    // Waiters are released even though the discarded tasks never ran.
+    EXPECT_TRUE(stuck.wait_for(std::chrono::seconds(1)));
+
+    // A group outlives a restart: its next post makes wait() cover the new task again.
+    rt.init(nullptr, 1U, 2U);
+    std::promise<void> gate;
+    auto gate_fut = gate.get_future().share();
+    quick.post_cpu([gate_fut, &quick_ran]() {
+        gate_fut.wait();
+        quick_ran.fetch_add(1);
+    });
+    EXPECT_FALSE(quick.wait_for(std::chrono::milliseconds(50)));
+    gate.set_value();
+    quick.wait();
+    EXPECT_EQ(quick_ran.load(), 21);
+
+    // The drain's cancellation was for the last session; stuck runs again once it rejoins.
+    const auto skipped_before = stuck.skipped();
+    stuck.post_cpu([&stuck_ran](const sx::infra::CancellationToken& token) {
+        if (!token.cancelled()) stuck_ran.store(100);
+    });
+    stuck.wait();
+    EXPECT_EQ(stuck_ran.load(), 100);
+    EXPECT_FALSE(stuck.cancelled());
+    EXPECT_EQ(stuck.skipped(), skipped_before);
+    rt.stop();
+}
+
+TEST(AsyncRuntime, FileIoRoundTripsOnEveryBackendAndCompletesOnTheIoPool) {
+    using sx::infra::FileIoBackend;
+    struct Result {
+        std::error_code ec;
+        std::size_t bytes = 0;
+        std::thread::id thread;
+    };
+    // Starts one operation and waits for its callback.
+    auto complete = [](const auto& start) {
+        auto promise = std::make_shared<std::promise<Result>>();
+        auto future = promise->get_future();
+        start([promise](const std::error_code& ec, std::size_t n) {
+            promise->set_value(Result{ec, n, std::this_thread::get_id()});
+        });
+        EXPECT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        return future.get();
+    };
+
+    for (const auto backend : {FileIoBackend::kAuto, FileIoBackend::kThreadPool}) {
+        sx::infra::RuntimeOptions options;
+        options.io_threads = 1U;
+        options.cpu_threads = 1U;
+        options.file_io.backend = backend;
+        options.file_io.registered_buffers = 2U;
+        options.file_io.registered_buffer_size = 8192U;
+        sx::infra::AsyncRuntime rt;
+        rt.init(nullptr, options);
+        // kAuto resolves to io_uring where the kernel allows it.
+        const FileIoBackend used = rt.file_io_backend();
+        EXPECT_NE(used, FileIoBackend::kAuto);
+        if (backend == FileIoBackend::kThreadPool) {
+            EXPECT_EQ(used, FileIoBackend::kThreadPool);
+        }
+
+        std::promise<std::thread::id> io_thread;
+        rt.post_io([&io_thread]() { io_thread.set_value(std::this_thread::get_id()); });
+        const auto io_id = io_thread.get_future().get();
+
+        char path[] = "/tmp/sx_file_io_XXXXXX";
+        const int fd = ::mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ::unlink(path);
+
+        // Plain buffers: 1 MiB at an offset, fsync, then a read that runs past end of file.
+        std::vector<unsigned char> out(1U << 20U);
+        for (std::size_t i = 0; i < out.size(); ++i) out[i] = static_cast<unsigned char>(i * 7U + 3U);
+        auto r = complete([&](auto cb) { rt.async_write(fd, out.data(), out.size(), 4096U, std::move(cb)); });
+        EXPECT_FALSE(r.ec);
+        EXPECT_EQ(r.bytes, out.size());
+        EXPECT_EQ(r.thread, io_id);
+
+        auto strand = rt.create_io_strand();
+        r = complete([&](auto cb) { rt.async_fsync(fd, std::move(cb), strand); });
+        EXPECT_FALSE(r.ec);
+        EXPECT_EQ(r.thread, io_id);
+
+        std::vector<unsigned char> in(out.size() + 100U);
+        r = complete([&](auto cb) { rt.async_read(fd, in.data(), in.size(), 4096U, std::move(cb)); });
+        EXPECT_FALSE(r.ec);
+        EXPECT_EQ(r.bytes, out.size());
+        EXPECT_TRUE(std::equal(out.begin(), out.end(), in.begin()));
+
+        // Pool buffers (registered with the ring under io_uring).
+        auto a = rt.acquire_file_buffer();
+        auto b = rt.acquire_file_buffer();
+        ASSERT_TRUE(a && b);
+        EXPECT_FALSE(rt.acquire_file_buffer());
+        EXPECT_EQ(a.size(), 8192U);
+        for (std::size_t i = 0; i < a.size(); ++i) a.data()[i] = static_cast<std::byte>(i % 251U);
+        r = complete([&](auto cb) { rt.async_write(fd, a, a.size(), 0U, std::move(cb)); });
+        EXPECT_FALSE(r.ec);
+        EXPECT_EQ(r.bytes, a.size());
+        r = complete([&](auto cb) { rt.async_fdatasync(fd, std::move(cb)); });
+        EXPECT_FALSE(r.ec);
+        r = complete([&](auto cb) { rt.async_read(fd, b, b.size(), 0U, std::move(cb)); });
+        EXPECT_FALSE(r.ec);
+        EXPECT_EQ(r.bytes, b.size());
+        EXPECT_TRUE(std::equal(a.data(), a.data() + a.size(), b.data()));
+        r = complete([&](auto cb) { rt.async_write(fd, a, a.size() + 1U, 0U, std::move(cb)); });
+        EXPECT_EQ(r.ec, std::errc::invalid_argument);
+        b = sx::infra::FileBuffer{};  // back to the pool
+        EXPECT_TRUE(rt.acquire_file_buffer());
+
+        // Errors come back through the callback.
+        r = complete([&](auto cb) { rt.async_read(-1, in.data(), 16U, 0U, std::move(cb)); });
+        EXPECT_EQ(r.ec, std::errc::bad_file_descriptor);
+
+        rt.stop();
+        EXPECT_FALSE(rt.acquire_file_buffer());
+        ::close(fd);
+    }
+}
+
+TEST(LoopRate, SleepsToAbsoluteDeadlinesAndSkipsOverruns) {
+    constexpr auto kPeriod = std::chrono::microseconds(1000);
+    sx::infra::LoopRate rate(kPeriod);
+    const auto start = std::chrono::steady_clock::now();
+
+    // Wake-ups land on start + k * period; an occasional late wake-up (loaded machine) only
+    // skips grid points, it never shifts the grid.
+    for (int i = 0; i < 50; ++i) (void)rate.sleep();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto grid_points = static_cast<int64_t>(50U + rate.overruns());
+    EXPECT_GE(elapsed, kPeriod * grid_points);
+    EXPECT_LT(elapsed, kPeriod * grid_points + std::chrono::milliseconds(20));
+
+    const auto grid = rate.next_deadline();
+    const uint64_t before = rate.overruns();
+    std::this_thread::sleep_for(kPeriod * 3 + kPeriod / 2);
+    EXPECT_FALSE(rate.sleep());
+    EXPECT_GE(rate.overruns() - before, 3U);
+    // Still on the original grid after skipping.
+    EXPECT_EQ((rate.next_deadline() - grid) % kPeriod, std::chrono::steady_clock::duration::zero());
+}
+
+TEST(AsyncRuntime, StrandDispatchRunsInlineFromItsOwnWorkUpToTheDepthBound) {
+    using sx::infra::IExecutor;
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+    EXPECT_EQ(IExecutor::current(), nullptr);
+    auto strand = rt.create_cpu_strand();
+
+    // Only strand tasks touch `order` until `done` is ready.
+    std::vector<std::string> order;
+    std::promise<void> done;
+    strand->post([&]() {
+        EXPECT_EQ(IExecutor::current(), strand.get());
+        strand->post([&]() {
+            order.emplace_back("queued");
+            done.set_value();
+        });
+        strand->dispatch([&]() {
+            EXPECT_TRUE(strand->running_in_this_thread());
+            order.emplace_back("dispatched");
+        });
+        order.emplace_back("after");
+    });
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(order, (std::vector<std::string>{"dispatched", "after", "queued"}));
+
+    // From a thread outside the strand dispatch() posts.
+    std::promise<std::thread::id> outside;
+    strand->dispatch([&]() { outside.set_value(std::this_thread::get_id()); });
+    auto outside_id = outside.get_future();
+    ASSERT_EQ(outside_id.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_NE(outside_id.get(), std::this_thread::get_id());
+
+    // A chain that keeps dispatching nests kMaxDispatchDepth levels deep, then continues queued.
+    constexpr int kLevels = 20;
+    int deepest = 0;
+    int inline_levels = 0;
+    std::promise<void> chain_done;
+    std::function<void(int)> nest = [&](int level) {
+        deepest = level;
+        if (level == kLevels) {
+            chain_done.set_value();
+            return;
+        }
+        strand->dispatch([&nest, level]() { nest(level + 1); });
+    };
+    strand->post([&]() {
+        nest(0);
+        inline_levels = deepest;
+    });
+    ASSERT_EQ(chain_done.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    strand->post([&]() { EXPECT_EQ(inline_levels, IExecutor::kMaxDispatchDepth); });
+    rt.stop();
+    EXPECT_EQ(deepest, kLevels);
+}
+
+TEST(AsyncRuntime, PoolWorkersReportTheirExecutorAndDispatchInline) {
+    using sx::infra::IExecutor;
+    for (const auto io_pool : {sx::infra::IoPoolKind::kShared, sx::infra::IoPoolKind::kPerThread}) {
+        sx::infra::RuntimeOptions options;
+        options.io_threads = 2U;
+        options.cpu_threads = 1U;
+        options.io_pool = io_pool;
+        sx::infra::AsyncRuntime rt;
+        rt.init(nullptr, options);
+        const auto io = rt.io_executor();
+        const auto cpu = rt.cpu_executor();
+
+        std::promise<void> done;
+        rt.post_cpu([&]() {
+            EXPECT_EQ(IExecutor::current(), cpu.get());
+            EXPECT_FALSE(io->running_in_this_thread());
+            bool ran = false;
+            rt.dispatch_cpu([&]() { ran = true; });
+            EXPECT_TRUE(ran);
+            rt.dispatch_io([&]() {
+                EXPECT_EQ(IExecutor::current(), io.get());
+                if (io_pool == sx::infra::IoPoolKind::kPerThread) {
+                    // A strand made here belongs to this worker's context, so its work may run inline.
+                    auto strand = rt.create_io_strand();
+                    bool strand_inline = false;
+                    strand->dispatch([&]() { strand_inline = true; });
+                    EXPECT_TRUE(strand_inline);
+                }
+                done.set_value();
+            });
+        });
+        ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+
+        // Off the pools dispatch posts, and the pool executors post like post_io / post_cpu.
+        std::promise<bool> on_worker;
+        cpu->post([&]() { on_worker.set_value(IExecutor::current() == cpu.get()); });
+        EXPECT_TRUE(on_worker.get_future().get());
+        EXPECT_EQ(IExecutor::current(), nullptr);
+        rt.stop();
+    }
+}
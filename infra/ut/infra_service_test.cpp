@@ -1,8 +1,14 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <fstream>
+#include <future>
+#include <iterator>
 #include <string>
+#include <thread>
 
 #include <unistd.h>
 
@@ -51,3 +57,51 @@ TEST(InfraService, InitAndShutdownIdempotent) {
     EXPECT_FALSE(svc.started());
 }
 
+TEST(InfraService, PlacesThreadsFromTopology) {
+    if (::access("/sys/devices/system/cpu/online", R_OK) != 0) GTEST_SKIP() << "no sysfs CPU topology";
+
+    sx::infra::InfraConfig cfg;
+    cfg.io_threads = 1U;
+    cfg.cpu_threads = 1U;
+    cfg.placement.enabled = true;
+    cfg.placement.critical_cores = 1U;
+
+    sx::infra::InfraService svc;
+    ASSERT_FALSE(svc.init(cfg));
+    const auto& plan = svc.placement();
+    EXPECT_FALSE(plan.cpu_cpus.empty());
+    EXPECT_FALSE(plan.io_cpus.empty());
+    for (const int cpu : plan.critical_cpus) {
+        EXPECT_EQ(std::count(plan.cpu_cpus.begin(), plan.cpu_cpus.end(), cpu), 0);
+    }
+    svc.shutdown();
+}
+
+TEST(InfraService, WatchdogStallsAreLogged) {
+    const std::string log_name = "sx_infra_service_watchdog_" + std::to_string(static_cast<int64_t>(::getpid())) + ".log";
+    sx::infra::InfraConfig cfg;
+    cfg.enable_logging = true;
+    cfg.logging.log_dir = "/tmp";
+    cfg.logging.file_name = log_name;
+    cfg.io_threads = 1U;
+    cfg.cpu_threads = 1U;
+    cfg.watchdog.enabled = true;
+    cfg.watchdog.check_period = std::chrono::milliseconds(5);
+    cfg.watchdog.task_budget = std::chrono::milliseconds(30);
+
+    sx::infra::InfraService svc;
+    ASSERT_FALSE(svc.init(cfg));
+    std::promise<void> done;
+    svc.runtime().post_io([&done]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(120));  // e.g. a synchronous file read
+        done.set_value();
+    });
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    svc.logging().flush();
+    svc.shutdown();
+
+    std::ifstream in("/tmp/" + log_name);
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_NE(text.find("task overrun on io worker 0"), std::string::npos) << text;
+    std::remove(("/tmp/" + log_name).c_str());
+}
@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "sx/infra/async_runtime.h"
+#include "sx/infra/trace.h"
+#include "sx/infra/unified_bus.h"
+#include "sx/types/unified_bus_types.h"
+
+namespace {
+
+std::size_t Count(const std::string& haystack, const std::string& needle) {
+    std::size_t n = 0;
+    for (auto pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1U)) ++n;
+    return n;
+}
+
+std::set<std::string> FlowIds(const std::string& json, const char* ph) {
+    std::set<std::string> ids;
+    const std::regex re(std::string("\\{\"ph\":\"") + ph + "\"[^}]*\"id\":([0-9]+)");
+    for (std::sregex_iterator it(json.begin(), json.end(), re), end; it != end; ++it) ids.insert((*it)[1].str());
+    return ids;
+}
+
+}  // namespace
+
+TEST(Tracer, RecordsRuntimeTasksStrandHandoffsBusTrafficAndUserSpans) {
+    using sx::infra::Tracer;
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = "inproc://sx_ut_trace_control";
+    ASSERT_FALSE(bus.subscribe(endpoint, [](const std::string&) {}));
+    auto queue = bus.subscribe_stream<int>("ut.trace.stream", sx::types::StreamMode::kReliableFifo);
+
+    // Nothing is recorded before enable().
+    rt.post_io([]() {});
+    { sx::infra::TraceSpan ignored("ut.before", "ut"); }
+
+    Tracer::enable();
+    std::promise<void> done;
+    auto strand = rt.create_cpu_strand();
+    rt.post_io([&]() {
+        sx::infra::TraceSpan span("ut.io_work", "ut", "frame 7");
+        strand->post([&]() {
+            rt.post_cpu([&]() { done.set_value(); });
+        });
+    });
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    ASSERT_FALSE(bus.publish(endpoint, "ping"));
+    bus.publish_stream<int>("ut.trace.stream", std::make_shared<int>(1));
+    std::shared_ptr<int> item;
+    ASSERT_TRUE(queue->try_pop(item));
+    rt.stop();  // every task has finished recording
+    Tracer::disable();
+    { sx::infra::TraceSpan ignored("ut.after", "ut"); }
+
+    const std::string json = Tracer::export_chrome_json();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0U);
+    EXPECT_EQ(json.find("ut.before"), std::string::npos);
+    EXPECT_EQ(json.find("ut.after"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"ut.io_work\",\"cat\":\"ut\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"detail\":\"frame 7\"}"), std::string::npos);
+    EXPECT_EQ(Count(json, "\"ph\":\"X\",\"name\":\"task\",\"cat\":\"io\""), 1U);
+    EXPECT_EQ(Count(json, "\"ph\":\"X\",\"name\":\"task\",\"cat\":\"strand\""), 1U);
+    EXPECT_EQ(Count(json, "\"ph\":\"X\",\"name\":\"task\",\"cat\":\"cpu\""), 1U);
+    EXPECT_NE(json.find("\"name\":\"strand.batch\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"bus.publish\",\"cat\":\"bus\""), std::string::npos);
+    EXPECT_NE(json.find("\"detail\":\"inproc://sx_ut_trace_control\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"bus.dispatch\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"bus.publish_stream\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"i\",\"name\":\"bus.pop\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"sx-io-0\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"sx-cpu-0\"}"), std::string::npos);
+
+    // Every handoff arrow starts at a post and ends in the task it queued.
+    const auto starts = FlowIds(json, "s");
+    EXPECT_EQ(starts.size(), 3U);
+    EXPECT_EQ(starts, FlowIds(json, "f"));
+    bus.shutdown();
+}
+
+TEST(Tracer, JoinsTasksToTheirPostOnEveryPoolKind) {
+    using sx::infra::Tracer;
+    for (const auto cpu_pool : {sx::infra::CpuPoolKind::kAsio, sx::infra::CpuPoolKind::kWorkStealing}) {
+        sx::infra::RuntimeOptions options;
+        options.io_threads = 2U;
+        options.cpu_threads = 1U;
+        options.cpu_pool = cpu_pool;
+        options.io_pool = sx::infra::IoPoolKind::kPerThread;  // IO strands are shards
+        options.watchdog.enabled = cpu_pool == sx::infra::CpuPoolKind::kWorkStealing;
+        sx::infra::AsyncRuntime rt;
+        rt.init(nullptr, options);
+
+        Tracer::enable();
+        std::promise<void> done;
+        auto strand = rt.create_io_strand();
+        rt.post_io([&]() {
+            strand->post([&]() { rt.post_cpu([&]() { done.set_value(); }); });
+        });
+        ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+        rt.stop();
+        Tracer::disable();
+
+        const std::string json = Tracer::export_chrome_json();
+        EXPECT_EQ(Count(json, "\"ph\":\"X\",\"name\":\"task\",\"cat\":\"io\""), 1U);
+        EXPECT_EQ(Count(json, "\"ph\":\"X\",\"name\":\"task\",\"cat\":\"strand\""), 1U);
+        EXPECT_EQ(Count(json, "\"ph\":\"X\",\"name\":\"task\",\"cat\":\"cpu\""), 1U);
+        const auto starts = FlowIds(json, "s");
+        EXPECT_EQ(starts.size(), 3U);
+        EXPECT_EQ(starts, FlowIds(json, "f"));
+    }
+}
+
+TEST(Tracer, RingKeepsTheNewestEventsPerThread) {
+    using sx::infra::Tracer;
+    sx::infra::TraceOptions options;
+    options.events_per_thread = 8U;
+    Tracer::enable(options);
+    std::thread([]() {
+        Tracer::set_thread_name("ut-ring");
+        for (int i = 0; i < 20; ++i) Tracer::instant("ut.tick", "ut", "n" + std::to_string(i));
+    }).join();
+    Tracer::disable();
+
+    const std::string json = Tracer::export_chrome_json();
+    // A full ring holds exactly the newest eight; nothing is being overwritten, so all are kept.
+    EXPECT_EQ(Count(json, "\"name\":\"ut.tick\""), 8U);
+    EXPECT_EQ(json.find("\"detail\":\"n11\""), std::string::npos);
+    for (int i = 12; i < 20; ++i) EXPECT_NE(json.find("\"detail\":\"n" + std::to_string(i) + "\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"ut-ring\"}"), std::string::npos);
+
+    // A new session starts from a clean slate.
+    Tracer::enable();
+    Tracer::disable();
+    EXPECT_EQ(Tracer::export_chrome_json().find("ut.tick"), std::string::npos);
+}
+
+TEST(Tracer, KeepsTheRingsOfOnlyTheLastExitedThreads) {
+    using sx::infra::Tracer;
+    sx::infra::TraceOptions options;
+    options.events_per_thread = 8U;
+    options.exited_threads_kept = 3U;
+    Tracer::enable(options);
+    for (int i = 0; i < 10; ++i) {
+        std::thread([i]() { Tracer::instant("ut.churn", "ut", "t" + std::to_string(i)); }).join();
+    }
+    Tracer::disable();
+
+    // The last thread's ring was added after pruning, so it comes on top of the three kept.
+    const std::string json = Tracer::export_chrome_json();
+    EXPECT_EQ(Count(json, "\"name\":\"ut.churn\""), 4U);
+    for (int i = 6; i < 10; ++i) EXPECT_NE(json.find("\"detail\":\"t" + std::to_string(i) + "\""), std::string::npos);
+}
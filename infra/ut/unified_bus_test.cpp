@@ -3,13 +3,19 @@
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <fstream>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <unistd.h>
 
+#include "sx/infra/async_runtime.h"
+#include "sx/infra/config_manager.h"
 #include "sx/infra/unified_bus.h"
 #include "sx/types/unified_bus_types.h"
 
@@ -27,10 +33,77 @@ std::string MakeInprocEndpoint(const std::string& name) {
     return "inproc://sx_ut_" + name + "_" + UniqueSuffix();
 }
 
+std::string MakeIpcEndpoint(const std::string& name) {
+    // Goes through libzmq (inproc:// is delivered in-process without ZMQ).
+    return "ipc:///tmp/sx_ut_" + name + "_" + UniqueSuffix();
+}
+
 std::string MakeDataTopic(const std::string& name) {
     return "ut.data." + name + "." + UniqueSuffix();
 }
 
+// Four threads publish concurrently to one endpoint; each thread's messages arrive in order.
+void ExpectConcurrentPublishersKeepPerThreadOrder(sx::infra::UnifiedBus& bus, const std::string& endpoint) {
+    ASSERT_FALSE(bus.publish(endpoint, "warmup"));
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 100;
+
+    std::mutex mu;
+    std::vector<std::vector<int>> seen(kThreads);
+    std::atomic<int> received{0};
+    std::atomic<bool> joined{false};
+
+    ASSERT_FALSE(bus.subscribe(endpoint, [&](const std::string& msg) {
+        if (msg == "probe") {
+            joined.store(true, std::memory_order_relaxed);
+            return;
+        }
+        const auto sep = msg.find(':');
+        if (sep == std::string::npos) return;
+        const int t = std::stoi(msg.substr(0, sep));
+        const int i = std::stoi(msg.substr(sep + 1));
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            seen[static_cast<std::size_t>(t)].push_back(i);
+        }
+        received.fetch_add(1, std::memory_order_relaxed);
+    }));
+
+    // Wait for the subscription to be live (PUB/SUB slow joiner).
+    const auto join_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!joined.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < join_deadline) {
+        (void)bus.publish(endpoint, "probe");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(joined.load(std::memory_order_relaxed));
+
+    std::vector<std::thread> publishers;
+    for (int t = 0; t < kThreads; ++t) {
+        publishers.emplace_back([&bus, &endpoint, t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                EXPECT_FALSE(bus.publish(endpoint, std::to_string(t) + ":" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& th : publishers) th.join();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (received.load(std::memory_order_relaxed) < kThreads * kPerThread &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    ASSERT_EQ(received.load(std::memory_order_relaxed), kThreads * kPerThread);
+    std::lock_guard<std::mutex> lock(mu);
+    for (const auto& per_thread : seen) {
+        ASSERT_EQ(per_thread.size(), static_cast<std::size_t>(kPerThread));
+        for (int i = 0; i < kPerThread; ++i) {
+            EXPECT_EQ(per_thread[static_cast<std::size_t>(i)], i);
+        }
+    }
+}
+
 }  // namespace
 
 TEST(UnifiedBusDataPlane, MultipleSubscribersSameTopicBroadcast) {
@@ -122,3 +195,622 @@ TEST(UnifiedBusControlPlane, InprocMultipleCallbacksSameEndpoint) {
 }
 
 
+TEST(UnifiedBusControlPlane, ConcurrentPublishersPreservePerThreadOrder) {
+    sx::infra::UnifiedBus bus;
+    ExpectConcurrentPublishersKeepPerThreadOrder(bus, MakeInprocEndpoint("ctrl_concurrent"));
+}
+
+TEST(UnifiedBusControlPlane, ConcurrentIpcPublishersPreservePerThreadOrder) {
+    sx::infra::UnifiedBus bus;
+    ExpectConcurrentPublishersKeepPerThreadOrder(bus, MakeIpcEndpoint("ctrl_concurrent_ipc"));
+}
+
+TEST(UnifiedBusControlPlane, InprocDeliversSynchronouslyInPublishOrder) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("ctrl_local");
+
+    // No subscriber yet: dropped, like PUB/SUB.
+    ASSERT_FALSE(bus.publish(endpoint, "dropped"));
+
+    std::vector<std::string> seen;
+    ASSERT_FALSE(bus.subscribe(endpoint, [&](const std::string& msg) {
+        seen.push_back(msg);
+        // Re-entrant publish is queued behind the current message, not delivered recursively.
+        if (msg == "a") {
+            EXPECT_FALSE(bus.publish(endpoint, "c"));
+            EXPECT_EQ(seen.size(), 1U);
+        }
+    }));
+
+    ASSERT_FALSE(bus.publish(endpoint, "a"));
+    ASSERT_FALSE(bus.publish(endpoint, "b"));
+
+    ASSERT_EQ(seen.size(), 3U);
+    EXPECT_EQ(seen[0], "a");
+    EXPECT_EQ(seen[1], "c");
+    EXPECT_EQ(seen[2], "b");
+}
+
+TEST(UnifiedBusControlPlane, InprocDispatcherHandsBacklogToTheNextPublisher) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("ctrl_handoff");
+
+    std::atomic<bool> a_dispatching{false};
+    std::atomic<bool> a_returned{false};
+    std::atomic<bool> gave_up{false};
+    std::atomic<int> published{0};
+    std::atomic<bool> overlapped{false};
+    std::atomic<bool> in_callback{false};
+    std::thread::id a_id;
+    std::atomic<int> on_others{0};
+    ASSERT_FALSE(bus.subscribe(endpoint, [&](const std::string& msg) {
+        if (in_callback.exchange(true)) overlapped.store(true);
+        if (msg == "first") {
+            a_dispatching.store(true);
+            while (!gave_up.load() && published.load() == 0) std::this_thread::yield();  // queue a backlog
+        }
+        // Slower than the publisher below, so the backlog never runs dry on its own.
+        const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(20);
+        while (!gave_up.load() && std::chrono::steady_clock::now() < until) {
+        }
+        if (std::this_thread::get_id() != a_id) on_others.fetch_add(1);
+        in_callback.store(false);
+    }));
+
+    std::thread a([&]() {
+        a_id = std::this_thread::get_id();
+        EXPECT_FALSE(bus.publish(endpoint, "first"));
+        a_returned.store(true);
+    });
+    while (!a_dispatching.load()) std::this_thread::yield();
+
+    // Keeps publishing until the first publisher is let go; without a hand-off that only
+    // happens once this loop gives up and the backlog ran dry.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!a_returned.load() && std::chrono::steady_clock::now() < deadline) {
+        EXPECT_FALSE(bus.publish(endpoint, "more"));
+        published.fetch_add(1);
+    }
+    const bool let_go = a_returned.load();
+    gave_up.store(true);
+    a.join();
+
+    EXPECT_TRUE(let_go);
+    EXPECT_GT(on_others.load(), 0);
+    EXPECT_FALSE(overlapped.load());
+}
+
+TEST(UnifiedBusControlPlaneDeathTest, InprocThrowingCallbackTerminates) {
+    EXPECT_DEATH(
+        {
+            sx::infra::UnifiedBus bus;
+            const std::string endpoint = MakeInprocEndpoint("ctrl_throw");
+            (void)bus.subscribe(endpoint, [](const std::string&) { throw std::runtime_error("boom"); });
+            (void)bus.publish(endpoint, "x");
+        },
+        "");
+}
+
+TEST(UnifiedBusRequestReply, MultiplexedRequestsCompleteOnExecutor) {
+    sx::infra::AsyncRuntime rt;
+    rt.init(nullptr, 1U, 1U);
+    auto strand = rt.create_io_strand();
+
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("rpc_echo");
+
+    ASSERT_FALSE(bus.serve(endpoint, [](const std::string& req, sx::infra::ControlResponder respond) {
+        respond("echo:" + req);
+    }));
+    EXPECT_TRUE(bus.serve(endpoint, [](const std::string&, sx::infra::ControlResponder) {}));
+
+    constexpr int kRequests = 50;
+    std::mutex mu;
+    std::vector<std::string> replies;
+    std::promise<void> all_done;
+    auto fut = all_done.get_future();
+
+    for (int i = 0; i < kRequests; ++i) {
+        bus.request(
+            endpoint, std::to_string(i), std::chrono::seconds(2),
+            [&, i](sx::infra::ControlReply reply) {
+                EXPECT_FALSE(reply.ec);
+                EXPECT_EQ(reply.payload, "echo:" + std::to_string(i));
+                std::lock_guard<std::mutex> lock(mu);
+                replies.push_back(std::move(reply.payload));
+                if (replies.size() == static_cast<std::size_t>(kRequests)) all_done.set_value();
+            },
+            strand);
+    }
+
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(3)), std::future_status::ready);
+    bus.shutdown();
+    rt.stop();
+}
+
+TEST(UnifiedBusRequestReply, UnansweredRequestTimesOut) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("rpc_silent");
+
+    sx::infra::ControlResponder kept;
+    ASSERT_FALSE(bus.serve(endpoint, [&kept](const std::string&, sx::infra::ControlResponder respond) {
+        kept = std::move(respond);  // never answered in time
+    }));
+
+    const auto start = std::chrono::steady_clock::now();
+    auto fut = bus.request(endpoint, "ping", std::chrono::milliseconds(50));
+    ASSERT_EQ(fut.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    const auto reply = fut.get();
+    EXPECT_EQ(reply.ec, std::make_error_code(std::errc::timed_out));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+    bus.shutdown();
+    // Answering after shutdown is a no-op.
+    if (kept) kept("late");
+}
+
+TEST(UnifiedBusRequestReply, ShutdownFailsPendingRequestsOutsideItsLocks) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("rpc_pending");
+    const std::string control = MakeIpcEndpoint("rpc_pending_ctrl");  // publishes through the reactor
+
+    sx::infra::ControlResponder kept;
+    ASSERT_FALSE(bus.serve(endpoint, [&kept](const std::string&, sx::infra::ControlResponder respond) {
+        kept = std::move(respond);
+    }));
+
+    // No executor: the callback runs on the thread failing it, and uses the bus from there.
+    std::promise<std::error_code> failed;
+    bus.request(endpoint, "ping", std::chrono::seconds(30), [&](sx::infra::ControlReply reply) {
+        EXPECT_FALSE(bus.publish(control, "after"));
+        failed.set_value(reply.ec);
+    });
+    const auto served = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!kept && std::chrono::steady_clock::now() < served) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(kept);
+
+    std::thread stopper([&bus]() { bus.shutdown(); });
+    auto result = failed.get_future();
+    ASSERT_EQ(result.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(result.get(), std::make_error_code(std::errc::operation_canceled));
+    stopper.join();
+}
+
+TEST(UnifiedBusRequestReply, InlineHandlerPublishingDuringShutdownDoesNotDeadlock) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("rpc_inline_pub");
+    const std::string control = MakeIpcEndpoint("rpc_inline_pub_ctrl");
+    ASSERT_FALSE(bus.publish(control, "before"));
+
+    // No executor: the handler runs on the reactor, which shutdown joins.
+    std::promise<void> entered;
+    std::promise<std::error_code> published;
+    ASSERT_FALSE(bus.serve(endpoint, [&](const std::string&, sx::infra::ControlResponder respond) {
+        entered.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));  // let shutdown start
+        published.set_value(bus.publish(control, "during"));
+        respond("late");
+    }));
+
+    auto reply = bus.request(endpoint, "ping", std::chrono::seconds(30));
+    entered.get_future().wait();
+    std::promise<void> stopped;
+    std::thread stopper([&]() {
+        bus.shutdown();
+        stopped.set_value();
+    });
+
+    auto done = stopped.get_future();
+    ASSERT_EQ(done.wait_for(std::chrono::seconds(3)), std::future_status::ready);
+    stopper.join();
+    EXPECT_EQ(published.get_future().get(), std::make_error_code(std::errc::operation_canceled));
+    EXPECT_EQ(reply.get().ec, std::make_error_code(std::errc::operation_canceled));
+}
+
+TEST(UnifiedBusRequestReply, InlineHandlerCanSubscribe) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("rpc_inline_sub");
+    const std::string control = MakeIpcEndpoint("rpc_inline_sub_ctrl");
+    ASSERT_FALSE(bus.publish(control, "before"));
+
+    // No executor: the handler runs on the reactor, which subscribe() must not wait for.
+    ASSERT_FALSE(bus.serve(endpoint, [&](const std::string&, sx::infra::ControlResponder respond) {
+        const auto ec = bus.subscribe(control, [](const std::string&) {});
+        respond(ec ? ec.message() : "subscribed");
+    }));
+
+    auto reply = bus.request(endpoint, "ping", std::chrono::seconds(3));
+    ASSERT_EQ(reply.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    const auto result = reply.get();
+    EXPECT_FALSE(result.ec);
+    EXPECT_EQ(result.payload, "subscribed");
+    bus.shutdown();
+}
+
+TEST(UnifiedBusControlPlane, BatchedPublishFlushesOnSizeAndInterval) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeIpcEndpoint("ctrl_batch");
+
+    sx::types::ControlChannelOptions opts;
+    opts.batch_max_messages = 8U;
+    opts.batch_flush_interval = std::chrono::milliseconds(2);
+    opts.send_hwm = 100;
+    ASSERT_FALSE(bus.publish(endpoint, "warmup", opts));
+
+    std::mutex mu;
+    std::vector<std::string> seen;
+    std::atomic<bool> joined{false};
+    ASSERT_FALSE(bus.subscribe(endpoint, [&](const std::string& msg) {
+        if (msg == "probe") {
+            joined.store(true, std::memory_order_relaxed);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mu);
+        seen.push_back(msg);
+    }));
+
+    const auto join_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!joined.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < join_deadline) {
+        (void)bus.publish(endpoint, "probe");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(joined.load(std::memory_order_relaxed));
+
+    // 20 = two full batches + a partial one that only the flush interval sends.
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_FALSE(bus.publish(endpoint, std::to_string(i)));
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            if (seen.size() >= 20U) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    std::lock_guard<std::mutex> lock(mu);
+    ASSERT_EQ(seen.size(), 20U);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(seen[static_cast<std::size_t>(i)], std::to_string(i));
+    }
+}
+
+TEST(UnifiedBusControlPlane, LoadsChannelOptionsFromConfig) {
+    const std::string path = "/tmp/sx_ut_bus_cfg_" + UniqueSuffix() + ".json";
+    const std::string conflated = MakeIpcEndpoint("cfg_a");
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << R"({"bus":{"control_channels":[
+            {"endpoint":")" << conflated << R"(","conflate":true,"recv_hwm":1},
+            {"endpoint":"ipc:///tmp/sx_ut_cfg_b","batch_max_messages":16,"batch_flush_interval_us":500}
+        ]}})";
+    }
+    sx::infra::ConfigManager cfg;
+    ASSERT_FALSE(cfg.load(path));
+
+    sx::infra::UnifiedBus bus;
+    EXPECT_EQ(bus.load_channel_options(cfg), 2U);
+    EXPECT_EQ(bus.load_channel_options(cfg, "no.such.key"), 0U);
+
+    // Registered options are applied when the socket is created.
+    EXPECT_FALSE(bus.publish(conflated, "x"));
+}
+
+TEST(UnifiedBusControlPlane, InprocLastValueReplayedToLateSubscriber) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("ctrl_lvc");
+
+    sx::types::ControlChannelOptions opts;
+    opts.last_value_cache = true;
+    bus.set_channel_options(endpoint, opts);
+
+    ASSERT_FALSE(bus.publish(endpoint, "state-1"));
+    ASSERT_FALSE(bus.publish(endpoint, "state-2"));
+
+    std::vector<std::string> seen;
+    ASSERT_FALSE(bus.subscribe(endpoint, [&seen](const std::string& msg) { seen.push_back(msg); }));
+    ASSERT_EQ(seen.size(), 1U);
+    EXPECT_EQ(seen[0], "state-2");
+
+    ASSERT_FALSE(bus.publish(endpoint, "state-3"));
+    ASSERT_EQ(seen.size(), 2U);
+    EXPECT_EQ(seen[1], "state-3");
+}
+
+TEST(UnifiedBusControlPlane, InprocSubscribeFromOwnCallbackIsQueuedBehindTheDelivery) {
+    sx::infra::UnifiedBus bus;
+    const std::string endpoint = MakeInprocEndpoint("ctrl_lvc_nested");
+    sx::types::ControlChannelOptions opts;
+    opts.last_value_cache = true;
+    bus.set_channel_options(endpoint, opts);
+
+    std::vector<std::string> first;
+    std::vector<std::string> second;
+    ASSERT_FALSE(bus.subscribe(endpoint, [&](const std::string& msg) {
+        first.push_back(msg);
+        if (first.size() == 1U) {
+            // Must not wait for the delivery this callback is part of.
+            EXPECT_FALSE(bus.subscribe(endpoint, [&second](const std::string& m) { second.push_back(m); }));
+            EXPECT_TRUE(second.empty());
+        }
+    }));
+    ASSERT_FALSE(bus.publish(endpoint, "state-1"));
+    // Registered once the delivery returned, with the value it was delivering replayed.
+    ASSERT_EQ(second.size(), 1U);
+    EXPECT_EQ(second[0], "state-1");
+
+    ASSERT_FALSE(bus.publish(endpoint, "state-2"));
+    EXPECT_EQ(first, (std::vector<std::string>{"state-1", "state-2"}));
+    EXPECT_EQ(second, (std::vector<std::string>{"state-1", "state-2"}));
+}
+
+TEST(UnifiedBusControlPlane, LastValueReplayIsDeduplicatedBySequence) {
+    const std::string endpoint = MakeIpcEndpoint("ctrl_lvc_zmq");
+    sx::types::ControlChannelOptions opts;
+    opts.last_value_cache = true;
+
+    sx::infra::UnifiedBus publisher;
+    ASSERT_FALSE(publisher.publish(endpoint, "state", opts));
+
+    auto wait_for = [](const std::atomic<int>& counter, int expected) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (counter.load(std::memory_order_relaxed) < expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return counter.load(std::memory_order_relaxed) >= expected;
+    };
+
+    // A late joiner gets the cached value without a new publish.
+    sx::infra::UnifiedBus first;
+    std::atomic<int> first_count{0};
+    ASSERT_FALSE(first.subscribe(endpoint, [&](const std::string& msg) {
+        EXPECT_EQ(msg, "state");
+        first_count.fetch_add(1, std::memory_order_relaxed);
+    }, opts));
+    ASSERT_TRUE(wait_for(first_count, 1));
+
+    // The replay for a second joiner also reaches the first one, which drops it by sequence.
+    sx::infra::UnifiedBus second;
+    std::atomic<int> second_count{0};
+    ASSERT_FALSE(second.subscribe(endpoint, [&](const std::string&) {
+        second_count.fetch_add(1, std::memory_order_relaxed);
+    }, opts));
+    ASSERT_TRUE(wait_for(second_count, 1));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (first.channel_stats(endpoint).duplicates == 0U && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    const auto stats = first.channel_stats(endpoint);
+    EXPECT_EQ(stats.received, 1U);
+    EXPECT_GE(stats.duplicates, 1U);
+    EXPECT_EQ(stats.gaps, 0U);
+    EXPECT_EQ(stats.last_sequence, 1U);
+    EXPECT_EQ(first_count.load(std::memory_order_relaxed), 1);
+
+    second.shutdown();
+    first.shutdown();
+    publisher.shutdown();
+}
+
+TEST(UnifiedBusControlPlane, LaterCallbacksGetTheLastValueAndPlainSubscribersKeepPayloads) {
+    const std::string endpoint = MakeIpcEndpoint("ctrl_lvc_second");
+    sx::types::ControlChannelOptions opts;
+    opts.last_value_cache = true;
+    sx::infra::UnifiedBus publisher;
+    ASSERT_FALSE(publisher.publish(endpoint, "state", opts));
+
+    auto wait_for = [](const std::atomic<int>& counter, int expected) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (counter.load(std::memory_order_relaxed) < expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return counter.load(std::memory_order_relaxed) >= expected;
+    };
+
+    sx::infra::UnifiedBus subscriber;
+    std::atomic<int> first{0};
+    std::atomic<int> second{0};
+    ASSERT_FALSE(subscriber.subscribe(endpoint, [&](const std::string& msg) {
+        EXPECT_EQ(msg, "state");
+        first.fetch_add(1, std::memory_order_relaxed);
+    }, opts));
+    ASSERT_TRUE(wait_for(first, 1));
+    // Same bus, same SUB socket: no new subscription reaches the publisher, the cache answers.
+    ASSERT_FALSE(subscriber.subscribe(endpoint, [&](const std::string& msg) {
+        EXPECT_EQ(msg, "state");
+        second.fetch_add(1, std::memory_order_relaxed);
+    }));
+    ASSERT_TRUE(wait_for(second, 1));
+    ASSERT_FALSE(publisher.publish(endpoint, "state"));
+    ASSERT_TRUE(wait_for(second, 2));
+    EXPECT_EQ(first.load(std::memory_order_relaxed), 2);
+
+    // A sequenced subscriber of a plain publisher gets payloads untouched.
+    const std::string plain = MakeIpcEndpoint("ctrl_plain");
+    sx::types::ControlChannelOptions sequenced;
+    sequenced.sequenced = true;
+    ASSERT_FALSE(publisher.publish(plain, "warmup"));
+    std::atomic<int> intact{0};
+    ASSERT_FALSE(subscriber.subscribe(plain, [&](const std::string& msg) {
+        if (msg == "12345678-payload") intact.fetch_add(1, std::memory_order_relaxed);
+    }, sequenced));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (intact.load(std::memory_order_relaxed) == 0 && std::chrono::steady_clock::now() < deadline) {
+        (void)publisher.publish(plain, "12345678-payload");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_GT(intact.load(std::memory_order_relaxed), 0);
+
+    // A plain subscriber never looks for headers, even in a binary payload that starts like one.
+    const std::string binary = MakeIpcEndpoint("ctrl_binary");
+    std::string payload("\xFFSQ\x00", 4);
+    payload.append(8, '\0');
+    payload += "body";
+    ASSERT_FALSE(publisher.publish(binary, "warmup"));
+    std::atomic<int> untouched{0};
+    ASSERT_FALSE(subscriber.subscribe(binary, [&](const std::string& msg) {
+        if (msg == payload) untouched.fetch_add(1, std::memory_order_relaxed);
+    }));
+    const auto binary_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (untouched.load(std::memory_order_relaxed) < 2 && std::chrono::steady_clock::now() < binary_deadline) {
+        (void)publisher.publish(binary, payload);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    // Sequence 0 twice would have been stripped and then dropped as a duplicate.
+    EXPECT_GE(untouched.load(std::memory_order_relaxed), 2);
+
+    subscriber.shutdown();
+    publisher.shutdown();
+}
+
+TEST(UnifiedBusControlPlane, PlainSubscriberOfCachingPublisherGetsEachPayloadOnce) {
+    const std::string endpoint = MakeIpcEndpoint("ctrl_lvc_plain");
+    sx::types::ControlChannelOptions opts;
+    opts.last_value_cache = true;
+    opts.batch_max_messages = 4;
+    sx::infra::UnifiedBus publisher;
+    ASSERT_FALSE(publisher.publish(endpoint, "state", opts));
+
+    // Options are the publisher's business: this subscriber has none and still gets the bare
+    // payloads, the cached one included.
+    sx::infra::UnifiedBus plain;
+    std::mutex mutex;
+    std::vector<std::string> seen;
+    ASSERT_FALSE(plain.subscribe(endpoint, [&](const std::string& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.push_back(msg);
+    }));
+    auto seen_count = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return seen.size();
+    };
+    auto wait_until = [](const auto& done) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return done();
+    };
+    ASSERT_TRUE(wait_until([&]() { return seen_count() >= 1U; }));
+
+    // Another joiner triggers a replay to everyone; the plain subscriber drops its copy.
+    sx::infra::UnifiedBus other;
+    std::atomic<int> other_count{0};
+    ASSERT_FALSE(other.subscribe(endpoint, [&](const std::string&) { other_count.fetch_add(1); }));
+    ASSERT_TRUE(wait_until([&]() { return other_count.load() >= 1; }));
+    ASSERT_TRUE(wait_until([&]() { return plain.channel_stats(endpoint).duplicates >= 1U; }));
+
+    for (const char* msg : {"a", "b", "c"}) ASSERT_FALSE(publisher.publish(endpoint, msg));
+    ASSERT_TRUE(wait_until([&]() { return seen_count() >= 4U; }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(seen, (std::vector<std::string>{"state", "a", "b", "c"}));
+    }
+    const auto stats = plain.channel_stats(endpoint);
+    EXPECT_EQ(stats.received, 4U);
+    EXPECT_EQ(stats.gaps, 0U);
+    EXPECT_EQ(stats.last_sequence, 4U);
+
+    other.shutdown();
+    plain.shutdown();
+    publisher.shutdown();
+}
+
+TEST(UnifiedBusControlPlane, RestartedPublisherStartsANewCount) {
+    const std::string endpoint = MakeIpcEndpoint("ctrl_restart");
+    sx::types::ControlChannelOptions opts;
+    opts.sequenced = true;
+
+    auto wait_until = [](const auto& done) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return done();
+    };
+
+    sx::infra::UnifiedBus subscriber;
+    std::atomic<int> old_count{0};
+    std::atomic<int> new_count{0};
+    ASSERT_FALSE(subscriber.subscribe(endpoint, [&](const std::string& msg) {
+        (msg == "new" ? new_count : old_count).fetch_add(1, std::memory_order_relaxed);
+    }));
+
+    uint64_t published = 0;
+    {
+        sx::infra::UnifiedBus publisher;
+        while (old_count.load(std::memory_order_relaxed) == 0 && published < 400U) {
+            ASSERT_FALSE(publisher.publish(endpoint, "old", opts));
+            ++published;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_GT(old_count.load(std::memory_order_relaxed), 0);
+        for (int i = 0; i < 300; ++i, ++published) ASSERT_FALSE(publisher.publish(endpoint, "old", opts));
+        ASSERT_TRUE(wait_until([&]() { return subscriber.channel_stats(endpoint).last_sequence == published; }));
+        publisher.shutdown();
+    }
+    const auto before = subscriber.channel_stats(endpoint);
+
+    // The new publisher numbers from 1 again, and its first messages go out while the subscriber
+    // is still reconnecting. Its later ones are below the old count, yet none is a duplicate.
+    sx::infra::UnifiedBus restarted;
+    ASSERT_TRUE(wait_until([&]() {
+        (void)restarted.publish(endpoint, "new", opts);
+        return new_count.load(std::memory_order_relaxed) > 0;
+    }));
+    const auto after = subscriber.channel_stats(endpoint);
+    EXPECT_EQ(after.duplicates, before.duplicates);
+    EXPECT_EQ(after.gaps, before.gaps);
+    EXPECT_LT(after.last_sequence, published);
+
+    restarted.shutdown();
+    subscriber.shutdown();
+}
+
+TEST(UnifiedBusControlPlane, SequenceGapsAreCounted) {
+    const std::string endpoint = MakeIpcEndpoint("ctrl_gaps");
+    sx::types::ControlChannelOptions opts;
+    opts.sequenced = true;
+    opts.send_hwm = 1;
+
+    sx::infra::UnifiedBus publisher;
+    ASSERT_FALSE(publisher.publish(endpoint, "warmup", opts));
+
+    // Behind a slow callback, with one message of room on either side, the publisher drops.
+    sx::types::ControlChannelOptions sub_opts;
+    sub_opts.recv_hwm = 1;
+
+    sx::infra::UnifiedBus subscriber;
+    std::atomic<bool> joined{false};
+    std::atomic<bool> release{false};
+    ASSERT_FALSE(subscriber.subscribe(endpoint, [&](const std::string& msg) {
+        if (msg == "probe" && !joined.exchange(true)) {
+            while (!release.load(std::memory_order_relaxed)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }, sub_opts));
+
+    const auto join_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!joined.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < join_deadline) {
+        (void)publisher.publish(endpoint, "probe");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(joined.load(std::memory_order_relaxed));
+
+    for (int i = 0; i < 50000; ++i) ASSERT_FALSE(publisher.publish(endpoint, "tick"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    release.store(true, std::memory_order_relaxed);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (subscriber.channel_stats(endpoint).gaps == 0U && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_GT(subscriber.channel_stats(endpoint).gaps, 0U);
+
+    subscriber.shutdown();
+    publisher.shutdown();
+}